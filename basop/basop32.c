@@ -131,30 +131,40 @@ HISTORY:
 
 #include <stdio.h>
 #include <stdlib.h>
+#define WMOPS_FAST_NO_WRAP  /* operator definitions, see wmops_fast.h */
 #include "stl.h"
 
 
 #if (WMOPS)
-extern BASIC_OP multiCounter[MAXCOUNTERS];
-extern int currCounter;
+extern BASOP_TLS BASIC_OP multiCounter[MAXCOUNTERS];
+extern BASOP_TLS int currCounter;
 #endif
 
 
 /*___________________________________________________________________________
  |                                                                           |
- |   Local Functions                                                         |
+ |   Constants and Globals                                                   |
  |___________________________________________________________________________|
 */
-static Word16 saturate (Word32 L_var1);
+#ifdef BASOP_THREAD_SAFE
+BASOP_TLS BASOP_FLAGS basop_flags = {0, 0};
+#else
+Flag Overflow = 0;
+Flag Carry = 0;
+#endif
+
+
+/* With BASOP_INLINE the operators are defined inline in basop_inline.h
+ * and only the flags above are provided here */
+#ifndef _BASOP_INLINE_H
 
 
 /*___________________________________________________________________________
  |                                                                           |
- |   Constants and Globals                                                   |
+ |   Local Functions                                                         |
  |___________________________________________________________________________|
 */
-Flag Overflow = 0;
-Flag Carry = 0;
+static Word16 saturate (Word32 L_var1);
 
 
 /*___________________________________________________________________________
@@ -2611,6 +2621,7 @@ Word32 L_msu0 (Word32 L_var3, Word16 var1, Word16 var2)
   return(L_var_out);
 }
 
+#endif /* ifndef _BASOP_INLINE_H */
 #endif //FXAPI
 
 /* end of file */
@@ -0,0 +1,68 @@
+/*
+  ===========================================================================
+   File: BASOP_CTX.H                                     v.2.3 - 30.Nov.2009
+  ===========================================================================
+
+            ITU-T STL  BASIC OPERATORS
+
+            PER-THREAD OPERATOR AND COUNTER CONTEXT
+
+   By default the Overflow and Carry flags, and the WMOPS counters in
+   count.c and control.c, are process globals. When BASOP_THREAD_SAFE is
+   defined, each of them gets thread-local storage instead. Every thread
+   then has its own flags and counter groups, so several codec instances
+   can run concurrently in one process. A thread can snapshot or replace
+   its flags through basop_flags, e.g. when it multiplexes several
+   instances.
+
+   Without BASOP_THREAD_SAFE, BASOP_TLS is empty and the operators keep
+   using the plain Overflow and Carry globals.
+
+   History:
+   first version, thread-local flags and counters (BASOP_THREAD_SAFE)
+  ============================================================================
+*/
+
+
+#ifndef _BASOP_CTX_H
+#define _BASOP_CTX_H
+
+
+/*
+ * Storage class qualifier for all mutable basic operator state.
+ */
+#ifdef BASOP_THREAD_SAFE
+#if defined(_MSC_VER)
+#define BASOP_TLS __declspec(thread)
+#elif defined(__STDC_VERSION__) && (__STDC_VERSION__ >= 201112L) && !defined(__STDC_NO_THREADS__)
+#define BASOP_TLS _Thread_local
+#else
+#define BASOP_TLS __thread
+#endif
+#else
+#define BASOP_TLS
+#endif
+
+
+#ifdef BASOP_THREAD_SAFE
+/*
+ * Overflow and Carry of the calling thread. Any code that includes stl.h
+ * keeps referring to them as Overflow and Carry.
+ */
+typedef struct
+{
+    Flag Overflow;
+    Flag Carry;
+} BASOP_FLAGS;
+
+extern BASOP_TLS BASOP_FLAGS basop_flags;
+
+#define Overflow (basop_flags.Overflow)
+#define Carry    (basop_flags.Carry)
+#endif /* ifdef BASOP_THREAD_SAFE */
+
+
+#endif /* ifndef _BASOP_CTX_H */
+
+
+/* end of file */
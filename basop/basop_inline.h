@@ -0,0 +1,612 @@
+/*
+  ===========================================================================
+   File: BASOP_INLINE.H                                  v.2.3 - 30.Nov.2009
+  ===========================================================================
+
+            ITU-T STL  BASIC OPERATORS
+
+            INLINE IMPLEMENTATION FOR NATIVE (NON-WMOPS) BUILDS
+
+   This header is a drop-in replacement for basop32.h/basop32.c. Every
+   16-bit and 32-bit basic operator is defined "static __inline", so the
+   compiler can inline it into the codec loops and vectorize them. Where
+   available, the GCC/Clang overflow builtins implement the 32-bit
+   saturation checks. All results, including the Overflow and Carry
+   flags, are bit-exact with basop32.c.
+
+   The header is selected from stl.h when BASOP_INLINE is defined and
+   WMOPS counting is off. Define BASOP_NO_OVERFLOW_FLAG as well to stop
+   the saturating operators from writing the global Overflow flag. This
+   removes the last global side effect from the inner loops. Operator
+   results are unchanged, but code that reads Overflow after add(),
+   L_add(), shl(), etc. then sees a stale value. L_add_c(), L_sub_c()
+   and L_sat() always maintain Overflow and Carry.
+
+   History:
+   first version, inline operators for native builds (BASOP_INLINE)
+  ============================================================================
+*/
+
+
+#ifndef _BASOP_INLINE_H
+#define _BASOP_INLINE_H
+
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#if (WMOPS)
+#error "basop_inline.h cannot be used with WMOPS counting, use basop32.c"
+#endif
+
+
+/*___________________________________________________________________________
+ |                                                                           |
+ |   Constants and Globals                                                   |
+ |___________________________________________________________________________|
+*/
+#define MAX_32 (Word32)0x7fffffffL
+#define MIN_32 (Word32)0x80000000L
+
+#define MAX_16 (Word16)0x7fff
+#define MIN_16 (Word16)0x8000
+
+#include "basop_ctx.h"
+#ifndef BASOP_THREAD_SAFE
+extern Flag Overflow;
+extern Flag Carry;
+#endif
+
+#ifdef BASOP_NO_OVERFLOW_FLAG
+#define BASOP_SET_OVERFLOW()
+#else
+#define BASOP_SET_OVERFLOW() (Overflow = 1)
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define BASOP_HAVE_BUILTINS
+#endif
+
+
+/*___________________________________________________________________________
+ |                                                                           |
+ |   Local Functions                                                         |
+ |___________________________________________________________________________|
+*/
+static __inline Word16 basop_saturate (Word32 L_var1)
+{
+    if (L_var1 > 0X00007fffL)
+    {
+        BASOP_SET_OVERFLOW ();
+        return MAX_16;
+    }
+    if (L_var1 < (Word32) 0xffff8000L)
+    {
+        BASOP_SET_OVERFLOW ();
+        return MIN_16;
+    }
+    return (Word16) L_var1;
+}
+
+static __inline Word16 shr (Word16 var1, Word16 var2);
+static __inline Word32 L_shr (Word32 L_var1, Word16 var2);
+
+
+/*___________________________________________________________________________
+ |                                                                           |
+ |   Operators with 16-bit result                                            |
+ |___________________________________________________________________________|
+*/
+static __inline Word16 add (Word16 var1, Word16 var2)
+{
+    return basop_saturate ((Word32) var1 + var2);
+}
+
+static __inline Word16 sub (Word16 var1, Word16 var2)
+{
+    return basop_saturate ((Word32) var1 - var2);
+}
+
+static __inline Word16 abs_s (Word16 var1)
+{
+    if (var1 == MIN_16)
+        return MAX_16;
+    return (var1 < 0) ? -var1 : var1;
+}
+
+static __inline Word16 negate (Word16 var1)
+{
+    return (var1 == MIN_16) ? MAX_16 : -var1;
+}
+
+static __inline Word16 extract_h (Word32 L_var1)
+{
+    return (Word16) (L_var1 >> 16);
+}
+
+static __inline Word16 extract_l (Word32 L_var1)
+{
+    return (Word16) L_var1;
+}
+
+static __inline Word16 shl (Word16 var1, Word16 var2)
+{
+    Word32 result;
+
+    if (var2 < 0)
+    {
+        if (var2 < -16)
+            var2 = -16;
+        return shr (var1, (Word16) -var2);
+    }
+    if (var2 > 15)
+    {
+        if (var1 == 0)
+            return 0;
+        BASOP_SET_OVERFLOW ();
+        return (var1 > 0) ? MAX_16 : MIN_16;
+    }
+    result = (Word32) var1 * ((Word32) 1 << var2);
+    if (result != (Word32) ((Word16) result))
+    {
+        BASOP_SET_OVERFLOW ();
+        return (var1 > 0) ? MAX_16 : MIN_16;
+    }
+    return (Word16) result;
+}
+
+static __inline Word16 shr (Word16 var1, Word16 var2)
+{
+    if (var2 < 0)
+    {
+        if (var2 < -16)
+            var2 = -16;
+        return shl (var1, (Word16) -var2);
+    }
+    if (var2 >= 15)
+        return (var1 < 0) ? -1 : 0;
+    return (Word16) (var1 >> var2);     /* arithmetic shift */
+}
+
+static __inline Word16 mult (Word16 var1, Word16 var2)
+{
+    /* (p & 0xffff8000) >> 15 with sign extension is p >> 15 */
+    return basop_saturate (((Word32) var1 * (Word32) var2) >> 15);
+}
+
+static __inline Word16 mult_r (Word16 var1, Word16 var2)
+{
+    return basop_saturate (((Word32) var1 * (Word32) var2 + (Word32) 0x00004000L) >> 15);
+}
+
+static __inline Word16 shr_r (Word16 var1, Word16 var2)
+{
+    Word16 var_out;
+
+    if (var2 > 15)
+        return 0;
+    var_out = shr (var1, var2);
+    if (var2 > 0 && (var1 & ((Word16) 1 << (var2 - 1))) != 0)
+        var_out++;
+    return var_out;
+}
+
+static __inline Word16 norm_s (Word16 var1)
+{
+    if (var1 == 0)
+        return 0;
+    if (var1 == (Word16) 0xffff)
+        return 15;
+    if (var1 < 0)
+        var1 = ~var1;
+#ifdef BASOP_HAVE_BUILTINS
+    return (Word16) (__builtin_clz ((unsigned int) var1) - (8 * sizeof (unsigned int) - 15));
+#else
+    {
+        Word16 var_out;
+        for (var_out = 0; var1 < 0x4000; var_out++)
+            var1 <<= 1;
+        return var_out;
+    }
+#endif
+}
+
+static __inline Word16 i_mult (Word16 a, Word16 b)
+{
+#ifdef ORIGINAL_G7231
+    return a * b;
+#else
+    return basop_saturate ((Word32) a * b);
+#endif
+}
+
+
+/*___________________________________________________________________________
+ |                                                                           |
+ |   Operators with 32-bit result                                            |
+ |___________________________________________________________________________|
+*/
+static __inline Word32 L_add (Word32 L_var1, Word32 L_var2)
+{
+    Word32 L_var_out;
+
+#ifdef BASOP_HAVE_BUILTINS
+    if (__builtin_add_overflow (L_var1, L_var2, &L_var_out))
+#else
+    L_var_out = (Word32) ((UWord32) L_var1 + (UWord32) L_var2);
+    if (((L_var1 ^ L_var2) & MIN_32) == 0 && ((L_var_out ^ L_var1) & MIN_32) != 0)
+#endif
+    {
+        BASOP_SET_OVERFLOW ();
+        L_var_out = (L_var1 < 0) ? MIN_32 : MAX_32;
+    }
+    return L_var_out;
+}
+
+static __inline Word32 L_sub (Word32 L_var1, Word32 L_var2)
+{
+    Word32 L_var_out;
+
+#ifdef BASOP_HAVE_BUILTINS
+    if (__builtin_sub_overflow (L_var1, L_var2, &L_var_out))
+#else
+    L_var_out = (Word32) ((UWord32) L_var1 - (UWord32) L_var2);
+    if (((L_var1 ^ L_var2) & MIN_32) != 0 && ((L_var_out ^ L_var1) & MIN_32) != 0)
+#endif
+    {
+        BASOP_SET_OVERFLOW ();
+        L_var_out = (L_var1 < 0) ? MIN_32 : MAX_32;
+    }
+    return L_var_out;
+}
+
+static __inline Word32 L_mult (Word16 var1, Word16 var2)
+{
+    Word32 L_var_out = (Word32) var1 * (Word32) var2;
+
+    if (L_var_out == (Word32) 0x40000000L)
+    {
+        BASOP_SET_OVERFLOW ();
+        return MAX_32;
+    }
+    return L_var_out * 2;
+}
+
+static __inline Word32 L_mac (Word32 L_var3, Word16 var1, Word16 var2)
+{
+    return L_add (L_var3, L_mult (var1, var2));
+}
+
+static __inline Word32 L_msu (Word32 L_var3, Word16 var1, Word16 var2)
+{
+    return L_sub (L_var3, L_mult (var1, var2));
+}
+
+static __inline Word32 L_mult0 (Word16 var1, Word16 var2)
+{
+    return (Word32) var1 * (Word32) var2;
+}
+
+static __inline Word32 L_mac0 (Word32 L_var3, Word16 var1, Word16 var2)
+{
+    return L_add (L_var3, (Word32) var1 * (Word32) var2);
+}
+
+static __inline Word32 L_msu0 (Word32 L_var3, Word16 var1, Word16 var2)
+{
+    return L_sub (L_var3, (Word32) var1 * (Word32) var2);
+}
+
+static __inline Word32 L_add_c (Word32 L_var1, Word32 L_var2)
+{
+    Word32 L_var_out;
+    Word32 L_test;
+    Flag carry_int = 0;
+
+    /* Wrap-around sums as in basop32.c, without signed overflow */
+    L_var_out = (Word32) ((UWord32) L_var1 + (UWord32) L_var2 + (UWord32) Carry);
+    L_test = (Word32) ((UWord32) L_var1 + (UWord32) L_var2);
+
+    if ((L_var1 > 0) && (L_var2 > 0) && (L_test < 0))
+    {
+        Overflow = 1;
+        carry_int = 0;
+    }
+    else if ((L_var1 < 0) && (L_var2 < 0))
+    {
+        Overflow = (L_test >= 0) ? 1 : 0;
+        carry_int = 1;
+    }
+    else
+    {
+        Overflow = 0;
+        carry_int = (((L_var1 ^ L_var2) < 0) && (L_test >= 0)) ? 1 : 0;
+    }
+
+    if (Carry)
+    {
+        if (L_test == MAX_32)
+        {
+            Overflow = 1;
+            Carry = carry_int;
+        }
+        else if (L_test == (Word32) 0xFFFFFFFFL)
+            Carry = 1;
+        else
+            Carry = carry_int;
+    }
+    else
+        Carry = carry_int;
+
+    return L_var_out;
+}
+
+static __inline Word32 L_sub_c (Word32 L_var1, Word32 L_var2)
+{
+    Word32 L_var_out;
+    Word32 L_test;
+    Flag carry_int = 0;
+
+    if (Carry)
+    {
+        Carry = 0;
+        if (L_var2 != MIN_32)
+            L_var_out = L_add_c (L_var1, -L_var2);
+        else
+        {
+            L_var_out = (Word32) ((UWord32) L_var1 - (UWord32) L_var2);
+            if (L_var1 > 0L)
+            {
+                Overflow = 1;
+                Carry = 0;
+            }
+        }
+    }
+    else
+    {
+        L_var_out = (Word32) ((UWord32) L_var1 - (UWord32) L_var2 - 1U);
+        L_test = (Word32) ((UWord32) L_var1 - (UWord32) L_var2);
+
+        if ((L_test < 0) && (L_var1 > 0) && (L_var2 < 0))
+        {
+            Overflow = 1;
+            carry_int = 0;
+        }
+        else if ((L_test > 0) && (L_var1 < 0) && (L_var2 > 0))
+        {
+            Overflow = 1;
+            carry_int = 1;
+        }
+        else if ((L_test > 0) && ((L_var1 ^ L_var2) > 0))
+        {
+            Overflow = 0;
+            carry_int = 1;
+        }
+        if (L_test == MIN_32)
+            Overflow = 1;
+        Carry = carry_int;
+    }
+
+    return L_var_out;
+}
+
+static __inline Word32 L_macNs (Word32 L_var3, Word16 var1, Word16 var2)
+{
+    return L_add_c (L_var3, L_mult (var1, var2));
+}
+
+static __inline Word32 L_msuNs (Word32 L_var3, Word16 var1, Word16 var2)
+{
+    return L_sub_c (L_var3, L_mult (var1, var2));
+}
+
+static __inline Word32 L_negate (Word32 L_var1)
+{
+    return (L_var1 == MIN_32) ? MAX_32 : -L_var1;
+}
+
+static __inline Word32 L_abs (Word32 L_var1)
+{
+    if (L_var1 == MIN_32)
+        return MAX_32;
+    return (L_var1 < 0) ? -L_var1 : L_var1;
+}
+
+static __inline Word32 L_shl (Word32 L_var1, Word16 var2)
+{
+    if (var2 <= 0)
+    {
+        if (var2 < -32)
+            var2 = -32;
+        return L_shr (L_var1, (Word16) -var2);
+    }
+    /* basop32.c doubles step by step and saturates as soon as the value
+     * leaves [0xc0000000, 0x3fffffff]; this is the same closed range test */
+    if (var2 < 32 && L_var1 <= (MAX_32 >> var2) && L_var1 >= (MIN_32 >> var2))
+        return (Word32) ((UWord32) L_var1 << var2);
+    if (L_var1 == 0)
+        return 0;
+    BASOP_SET_OVERFLOW ();
+    return (L_var1 > 0) ? MAX_32 : MIN_32;
+}
+
+static __inline Word32 L_shr (Word32 L_var1, Word16 var2)
+{
+    if (var2 < 0)
+    {
+        if (var2 < -32)
+            var2 = -32;
+        return L_shl (L_var1, (Word16) -var2);
+    }
+    if (var2 >= 31)
+        return (L_var1 < 0L) ? -1 : 0;
+    return L_var1 >> var2;      /* arithmetic shift */
+}
+
+static __inline Word32 L_shr_r (Word32 L_var1, Word16 var2)
+{
+    Word32 L_var_out;
+
+    if (var2 > 31)
+        return 0;
+    L_var_out = L_shr (L_var1, var2);
+    if (var2 > 0 && (L_var1 & ((Word32) 1 << (var2 - 1))) != 0)
+        L_var_out++;
+    return L_var_out;
+}
+
+static __inline Word32 L_deposit_h (Word16 var1)
+{
+    return (Word32) var1 * (Word32) 0x00010000L;
+}
+
+static __inline Word32 L_deposit_l (Word16 var1)
+{
+    return (Word32) var1;
+}
+
+static __inline Word32 L_sat (Word32 L_var1)
+{
+    if (Overflow)
+    {
+        L_var1 = Carry ? MIN_32 : MAX_32;
+        Carry = 0;
+        Overflow = 0;
+    }
+    return L_var1;
+}
+
+static __inline Word16 norm_l (Word32 L_var1)
+{
+    if (L_var1 == 0)
+        return 0;
+    if (L_var1 == (Word32) 0xffffffffL)
+        return 31;
+    if (L_var1 < 0)
+        L_var1 = ~L_var1;
+#ifdef BASOP_HAVE_BUILTINS
+    return (Word16) (__builtin_clz ((unsigned int) L_var1) - (8 * sizeof (unsigned int) - 31));
+#else
+    {
+        Word16 var_out;
+        for (var_out = 0; L_var1 < (Word32) 0x40000000L; var_out++)
+            L_var1 <<= 1;
+        return var_out;
+    }
+#endif
+}
+
+static __inline Word32 L_mls (Word32 Lv, Word16 v)
+{
+    Word32 Temp;
+
+    Temp = (Lv & (Word32) 0x0000ffff) * (Word32) v;
+    Temp = L_shr (Temp, (Word16) 15);
+    return L_mac (Temp, v, extract_h (Lv));
+}
+
+
+/*___________________________________________________________________________
+ |                                                                           |
+ |   Rounding operators                                                      |
+ |___________________________________________________________________________|
+*/
+static __inline Word16 round_fx (Word32 L_var1)
+{
+    return extract_h (L_add (L_var1, (Word32) 0x00008000L));
+}
+
+static __inline Word16 mac_r (Word32 L_var3, Word16 var1, Word16 var2)
+{
+    return extract_h (L_add (L_mac (L_var3, var1, var2), (Word32) 0x00008000L));
+}
+
+static __inline Word16 msu_r (Word32 L_var3, Word16 var1, Word16 var2)
+{
+    return extract_h (L_add (L_msu (L_var3, var1, var2), (Word32) 0x00008000L));
+}
+
+
+/*___________________________________________________________________________
+ |                                                                           |
+ |   Division operators                                                      |
+ |___________________________________________________________________________|
+*/
+static __inline Word16 div_s (Word16 var1, Word16 var2)
+{
+    Word16 var_out = 0;
+    Word16 iteration;
+    Word32 L_num;
+    Word32 L_denom;
+
+    if ((var1 > var2) || (var1 < 0) || (var2 < 0))
+    {
+        printf ("Division Error var1=%d  var2=%d\n", var1, var2);
+        abort(); /* exit (0); */
+    }
+    if (var2 == 0)
+    {
+        printf ("Division by 0, Fatal error \n");
+        abort(); /* exit (0); */
+    }
+    if (var1 == 0)
+        return 0;
+    if (var1 == var2)
+        return MAX_16;
+
+    L_num = L_deposit_l (var1);
+    L_denom = L_deposit_l (var2);
+    for (iteration = 0; iteration < 15; iteration++)
+    {
+        var_out <<= 1;
+        L_num <<= 1;
+        if (L_num >= L_denom)
+        {
+            L_num = L_sub (L_num, L_denom);
+            var_out = add (var_out, 1);
+        }
+    }
+    return var_out;
+}
+
+static __inline Word16 div_l (Word32 L_num, Word16 den)
+{
+    Word16 var_out = (Word16) 0;
+    Word32 L_den;
+    Word16 iteration;
+
+    if (den == (Word16) 0)
+    {
+        printf ("Division by 0 in div_l, Fatal error \n");
+        exit (0);
+    }
+    if ((L_num < (Word32) 0) || (den < (Word16) 0))
+    {
+        printf ("Division Error in div_l, Fatal error \n");
+        exit (0);
+    }
+
+    L_den = L_deposit_h (den);
+    if (L_num >= L_den)
+        return MAX_16;
+
+    L_num = L_shr (L_num, (Word16) 1);
+    L_den = L_shr (L_den, (Word16) 1);
+    for (iteration = (Word16) 0; iteration < (Word16) 15; iteration++)
+    {
+        var_out = shl (var_out, (Word16) 1);
+        L_num = L_shl (L_num, (Word16) 1);
+        if (L_num >= L_den)
+        {
+            L_num = L_sub (L_num, L_den);
+            var_out = add (var_out, (Word16) 1);
+        }
+    }
+    return var_out;
+}
+
+
+#endif /* ifndef _BASOP_INLINE_H */
+
+
+/* end of file */
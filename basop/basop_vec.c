@@ -0,0 +1,859 @@
+/*
+  ===========================================================================
+   File: BASOP_VEC.C                                     v.1.0 - 17.Oct.2026
+  ===========================================================================
+
+            ITU-T STL  BASIC OPERATORS
+
+            VECTOR OPERATORS
+
+   History:
+   17 Oct 26   v1.0     First version, vector operators
+
+  ============================================================================
+*/
+
+
+ /*****************************************************************************
+ *
+ *  Vector operators :
+ *    vec_add()
+ *    vec_sub()
+ *    vec_mult()
+ *    vec_shl()
+ *    vec_shr()
+ *    vec_L_add()
+ *    vec_L_sub()
+ *    vec_L_shl()
+ *    vec_L_shr()
+ *    vec_norm_l()
+ *    vec_L_mac()
+ *    vec_L_msu()
+ *    vec_L_mac0()
+ *    vec_norm_l_block()
+ *
+ *****************************************************************************/
+
+
+/*****************************************************************************
+ *
+ *  Include-Files
+ *
+ *****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include "stl.h"
+#include "basop_vec.h"
+
+#if !(WMOPS) && !defined(BASOP_VEC_NO_SIMD)
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define BASOP_VEC_AVX2
+#define BASOP_VEC_SSE2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define BASOP_VEC_SSE2
+#endif
+#endif
+
+
+
+/*****************************************************************************
+ *
+ *   Constants and Globals
+ *
+ *****************************************************************************/
+#ifndef MAX_32
+#define MAX_32 (Word32)0x7fffffffL
+#define MIN_32 (Word32)0x80000000L
+#define MAX_16 (Word16)0x7fff
+#define MIN_16 (Word16)0x8000
+#endif
+
+#if defined(BASOP_INLINE) && defined(BASOP_NO_OVERFLOW_FLAG)
+#define VEC_SET_OVERFLOW()
+#else
+#define VEC_SET_OVERFLOW() (Overflow = 1)
+#endif
+
+#ifdef BASOP_VEC_SSE2
+/* nonzero if any bit of v is set */
+#define SSE2_ANY(v) (_mm_movemask_epi8 (_mm_cmpeq_epi8 ((v), _mm_setzero_si128 ())) != 0xffff)
+#endif
+#ifdef BASOP_VEC_AVX2
+#define AVX2_ANY(v) (!_mm256_testz_si256 ((v), (v)))
+#endif
+
+
+/*****************************************************************************
+ *
+ *   Functions
+ *
+ *****************************************************************************/
+
+
+/*****************************************************************************
+ *
+ *  Function Name : vec_add, vec_sub
+ *
+ *  Purpose :
+ *
+ *    z[i] = add(x[i], y[i]), z[i] = sub(x[i], y[i]).
+ *
+ *****************************************************************************/
+void vec_add (const Word16 x[], const Word16 y[], Word16 z[], Word16 n)
+{
+    Word16 i = 0;
+
+#ifdef BASOP_VEC_AVX2
+    {
+        __m256i ovf = _mm256_setzero_si256 ();
+
+        for (; i + 16 <= n; i += 16)
+        {
+            __m256i a = _mm256_loadu_si256 ((const __m256i *) &x[i]);
+            __m256i b = _mm256_loadu_si256 ((const __m256i *) &y[i]);
+            __m256i s = _mm256_adds_epi16 (a, b);
+
+            ovf = _mm256_or_si256 (ovf, _mm256_xor_si256 (s, _mm256_add_epi16 (a, b)));
+            _mm256_storeu_si256 ((__m256i *) &z[i], s);
+        }
+        if (AVX2_ANY (ovf))
+            VEC_SET_OVERFLOW ();
+    }
+#endif
+#ifdef BASOP_VEC_SSE2
+    {
+        __m128i ovf = _mm_setzero_si128 ();
+
+        for (; i + 8 <= n; i += 8)
+        {
+            __m128i a = _mm_loadu_si128 ((const __m128i *) &x[i]);
+            __m128i b = _mm_loadu_si128 ((const __m128i *) &y[i]);
+            __m128i s = _mm_adds_epi16 (a, b);
+
+            ovf = _mm_or_si128 (ovf, _mm_xor_si128 (s, _mm_add_epi16 (a, b)));
+            _mm_storeu_si128 ((__m128i *) &z[i], s);
+        }
+        if (SSE2_ANY (ovf))
+            VEC_SET_OVERFLOW ();
+    }
+#endif
+    for (; i < n; i++)
+    {
+        z[i] = add (x[i], y[i]);
+    }
+}
+
+void vec_sub (const Word16 x[], const Word16 y[], Word16 z[], Word16 n)
+{
+    Word16 i = 0;
+
+#ifdef BASOP_VEC_AVX2
+    {
+        __m256i ovf = _mm256_setzero_si256 ();
+
+        for (; i + 16 <= n; i += 16)
+        {
+            __m256i a = _mm256_loadu_si256 ((const __m256i *) &x[i]);
+            __m256i b = _mm256_loadu_si256 ((const __m256i *) &y[i]);
+            __m256i s = _mm256_subs_epi16 (a, b);
+
+            ovf = _mm256_or_si256 (ovf, _mm256_xor_si256 (s, _mm256_sub_epi16 (a, b)));
+            _mm256_storeu_si256 ((__m256i *) &z[i], s);
+        }
+        if (AVX2_ANY (ovf))
+            VEC_SET_OVERFLOW ();
+    }
+#endif
+#ifdef BASOP_VEC_SSE2
+    {
+        __m128i ovf = _mm_setzero_si128 ();
+
+        for (; i + 8 <= n; i += 8)
+        {
+            __m128i a = _mm_loadu_si128 ((const __m128i *) &x[i]);
+            __m128i b = _mm_loadu_si128 ((const __m128i *) &y[i]);
+            __m128i s = _mm_subs_epi16 (a, b);
+
+            ovf = _mm_or_si128 (ovf, _mm_xor_si128 (s, _mm_sub_epi16 (a, b)));
+            _mm_storeu_si128 ((__m128i *) &z[i], s);
+        }
+        if (SSE2_ANY (ovf))
+            VEC_SET_OVERFLOW ();
+    }
+#endif
+    for (; i < n; i++)
+    {
+        z[i] = sub (x[i], y[i]);
+    }
+}
+
+
+/*****************************************************************************
+ *
+ *  Function Name : vec_mult
+ *
+ *  Purpose :
+ *
+ *    z[i] = mult(x[i], y[i]). The product is (x*y) >> 15, built from the
+ *    high and low halves of the 32-bit product; only MIN_16 * MIN_16
+ *    saturates.
+ *
+ *****************************************************************************/
+void vec_mult (const Word16 x[], const Word16 y[], Word16 z[], Word16 n)
+{
+    Word16 i = 0;
+
+#ifdef BASOP_VEC_AVX2
+    {
+        const __m256i min16 = _mm256_set1_epi16 (MIN_16);
+        __m256i ovf = _mm256_setzero_si256 ();
+
+        for (; i + 16 <= n; i += 16)
+        {
+            __m256i a = _mm256_loadu_si256 ((const __m256i *) &x[i]);
+            __m256i b = _mm256_loadu_si256 ((const __m256i *) &y[i]);
+            __m256i p = _mm256_or_si256 (_mm256_slli_epi16 (_mm256_mulhi_epi16 (a, b), 1),
+                                         _mm256_srli_epi16 (_mm256_mullo_epi16 (a, b), 15));
+            __m256i sat = _mm256_and_si256 (_mm256_cmpeq_epi16 (a, min16), _mm256_cmpeq_epi16 (b, min16));
+
+            ovf = _mm256_or_si256 (ovf, sat);
+            _mm256_storeu_si256 ((__m256i *) &z[i], _mm256_xor_si256 (p, sat));
+        }
+        if (AVX2_ANY (ovf))
+            VEC_SET_OVERFLOW ();
+    }
+#endif
+#ifdef BASOP_VEC_SSE2
+    {
+        const __m128i min16 = _mm_set1_epi16 (MIN_16);
+        __m128i ovf = _mm_setzero_si128 ();
+
+        for (; i + 8 <= n; i += 8)
+        {
+            __m128i a = _mm_loadu_si128 ((const __m128i *) &x[i]);
+            __m128i b = _mm_loadu_si128 ((const __m128i *) &y[i]);
+            __m128i p = _mm_or_si128 (_mm_slli_epi16 (_mm_mulhi_epi16 (a, b), 1),
+                                      _mm_srli_epi16 (_mm_mullo_epi16 (a, b), 15));
+            __m128i sat = _mm_and_si128 (_mm_cmpeq_epi16 (a, min16), _mm_cmpeq_epi16 (b, min16));
+
+            ovf = _mm_or_si128 (ovf, sat);
+            _mm_storeu_si128 ((__m128i *) &z[i], _mm_xor_si128 (p, sat));
+        }
+        if (SSE2_ANY (ovf))
+            VEC_SET_OVERFLOW ();
+    }
+#endif
+    for (; i < n; i++)
+    {
+        z[i] = mult (x[i], y[i]);
+    }
+}
+
+
+/*****************************************************************************
+ *
+ *  Function Name : vec_shl, vec_shr
+ *
+ *  Purpose :
+ *
+ *    z[i] = shl(x[i], var2), z[i] = shr(x[i], var2). A left shift
+ *    saturates the lanes that do not shift back to their input.
+ *
+ *****************************************************************************/
+void vec_shl (const Word16 x[], Word16 var2, Word16 z[], Word16 n)
+{
+    Word16 i = 0;
+
+    if (var2 < 0)
+    {
+        vec_shr (x, (Word16) ((var2 < -16) ? 16 : -var2), z, n);
+        return;
+    }
+#ifdef BASOP_VEC_SSE2
+    if (var2 <= 15)
+    {
+        const __m128i cnt = _mm_cvtsi32_si128 (var2);
+#ifdef BASOP_VEC_AVX2
+        {
+            const __m256i max16 = _mm256_set1_epi16 (MAX_16);
+            __m256i ovf = _mm256_setzero_si256 ();
+
+            for (; i + 16 <= n; i += 16)
+            {
+                __m256i a = _mm256_loadu_si256 ((const __m256i *) &x[i]);
+                __m256i s = _mm256_sll_epi16 (a, cnt);
+                __m256i sat = _mm256_xor_si256 (_mm256_cmpeq_epi16 (_mm256_sra_epi16 (s, cnt), a),
+                                                _mm256_set1_epi16 (-1));
+                __m256i lim = _mm256_xor_si256 (_mm256_srai_epi16 (a, 15), max16);
+
+                ovf = _mm256_or_si256 (ovf, sat);
+                _mm256_storeu_si256 ((__m256i *) &z[i], _mm256_blendv_epi8 (s, lim, sat));
+            }
+            if (AVX2_ANY (ovf))
+                VEC_SET_OVERFLOW ();
+        }
+#endif
+        {
+            const __m128i max16 = _mm_set1_epi16 (MAX_16);
+            __m128i ovf = _mm_setzero_si128 ();
+
+            for (; i + 8 <= n; i += 8)
+            {
+                __m128i a = _mm_loadu_si128 ((const __m128i *) &x[i]);
+                __m128i s = _mm_sll_epi16 (a, cnt);
+                __m128i sat = _mm_xor_si128 (_mm_cmpeq_epi16 (_mm_sra_epi16 (s, cnt), a),
+                                             _mm_set1_epi16 (-1));
+                __m128i lim = _mm_xor_si128 (_mm_srai_epi16 (a, 15), max16);
+
+                ovf = _mm_or_si128 (ovf, sat);
+                _mm_storeu_si128 ((__m128i *) &z[i],
+                                  _mm_or_si128 (_mm_andnot_si128 (sat, s), _mm_and_si128 (sat, lim)));
+            }
+            if (SSE2_ANY (ovf))
+                VEC_SET_OVERFLOW ();
+        }
+    }
+#endif
+    for (; i < n; i++)
+    {
+        z[i] = shl (x[i], var2);
+    }
+}
+
+void vec_shr (const Word16 x[], Word16 var2, Word16 z[], Word16 n)
+{
+    Word16 i = 0;
+
+    if (var2 < 0)
+    {
+        vec_shl (x, (Word16) ((var2 < -16) ? 16 : -var2), z, n);
+        return;
+    }
+#ifdef BASOP_VEC_SSE2
+    {
+        /* shr() of 15 or more leaves the sign, as an arithmetic shift by 15 */
+        const __m128i cnt = _mm_cvtsi32_si128 ((var2 > 15) ? 15 : var2);
+#ifdef BASOP_VEC_AVX2
+        for (; i + 16 <= n; i += 16)
+        {
+            __m256i a = _mm256_loadu_si256 ((const __m256i *) &x[i]);
+            _mm256_storeu_si256 ((__m256i *) &z[i], _mm256_sra_epi16 (a, cnt));
+        }
+#endif
+        for (; i + 8 <= n; i += 8)
+        {
+            __m128i a = _mm_loadu_si128 ((const __m128i *) &x[i]);
+            _mm_storeu_si128 ((__m128i *) &z[i], _mm_sra_epi16 (a, cnt));
+        }
+    }
+#endif
+    for (; i < n; i++)
+    {
+        z[i] = shr (x[i], var2);
+    }
+}
+
+
+/*****************************************************************************
+ *
+ *  Function Name : vec_L_add, vec_L_sub
+ *
+ *  Purpose :
+ *
+ *    z[i] = L_add(x[i], y[i]), z[i] = L_sub(x[i], y[i]). A lane overflows
+ *    when the wrapped result has the wrong sign; it is then replaced by
+ *    MAX_32 or MIN_32 following the sign of x[i].
+ *
+ *****************************************************************************/
+void vec_L_add (const Word32 x[], const Word32 y[], Word32 z[], Word16 n)
+{
+    Word16 i = 0;
+
+#ifdef BASOP_VEC_AVX2
+    {
+        const __m256i max32 = _mm256_set1_epi32 (MAX_32);
+        __m256i ovf = _mm256_setzero_si256 ();
+
+        for (; i + 8 <= n; i += 8)
+        {
+            __m256i a = _mm256_loadu_si256 ((const __m256i *) &x[i]);
+            __m256i b = _mm256_loadu_si256 ((const __m256i *) &y[i]);
+            __m256i s = _mm256_add_epi32 (a, b);
+            __m256i sat = _mm256_srai_epi32 (_mm256_andnot_si256 (_mm256_xor_si256 (a, b),
+                                                                  _mm256_xor_si256 (a, s)), 31);
+            __m256i lim = _mm256_xor_si256 (_mm256_srai_epi32 (a, 31), max32);
+
+            ovf = _mm256_or_si256 (ovf, sat);
+            _mm256_storeu_si256 ((__m256i *) &z[i], _mm256_blendv_epi8 (s, lim, sat));
+        }
+        if (AVX2_ANY (ovf))
+            VEC_SET_OVERFLOW ();
+    }
+#endif
+#ifdef BASOP_VEC_SSE2
+    {
+        const __m128i max32 = _mm_set1_epi32 (MAX_32);
+        __m128i ovf = _mm_setzero_si128 ();
+
+        for (; i + 4 <= n; i += 4)
+        {
+            __m128i a = _mm_loadu_si128 ((const __m128i *) &x[i]);
+            __m128i b = _mm_loadu_si128 ((const __m128i *) &y[i]);
+            __m128i s = _mm_add_epi32 (a, b);
+            __m128i sat = _mm_srai_epi32 (_mm_andnot_si128 (_mm_xor_si128 (a, b),
+                                                            _mm_xor_si128 (a, s)), 31);
+            __m128i lim = _mm_xor_si128 (_mm_srai_epi32 (a, 31), max32);
+
+            ovf = _mm_or_si128 (ovf, sat);
+            _mm_storeu_si128 ((__m128i *) &z[i],
+                              _mm_or_si128 (_mm_andnot_si128 (sat, s), _mm_and_si128 (sat, lim)));
+        }
+        if (SSE2_ANY (ovf))
+            VEC_SET_OVERFLOW ();
+    }
+#endif
+    for (; i < n; i++)
+    {
+        z[i] = L_add (x[i], y[i]);
+    }
+}
+
+void vec_L_sub (const Word32 x[], const Word32 y[], Word32 z[], Word16 n)
+{
+    Word16 i = 0;
+
+#ifdef BASOP_VEC_AVX2
+    {
+        const __m256i max32 = _mm256_set1_epi32 (MAX_32);
+        __m256i ovf = _mm256_setzero_si256 ();
+
+        for (; i + 8 <= n; i += 8)
+        {
+            __m256i a = _mm256_loadu_si256 ((const __m256i *) &x[i]);
+            __m256i b = _mm256_loadu_si256 ((const __m256i *) &y[i]);
+            __m256i s = _mm256_sub_epi32 (a, b);
+            __m256i sat = _mm256_srai_epi32 (_mm256_and_si256 (_mm256_xor_si256 (a, b),
+                                                               _mm256_xor_si256 (a, s)), 31);
+            __m256i lim = _mm256_xor_si256 (_mm256_srai_epi32 (a, 31), max32);
+
+            ovf = _mm256_or_si256 (ovf, sat);
+            _mm256_storeu_si256 ((__m256i *) &z[i], _mm256_blendv_epi8 (s, lim, sat));
+        }
+        if (AVX2_ANY (ovf))
+            VEC_SET_OVERFLOW ();
+    }
+#endif
+#ifdef BASOP_VEC_SSE2
+    {
+        const __m128i max32 = _mm_set1_epi32 (MAX_32);
+        __m128i ovf = _mm_setzero_si128 ();
+
+        for (; i + 4 <= n; i += 4)
+        {
+            __m128i a = _mm_loadu_si128 ((const __m128i *) &x[i]);
+            __m128i b = _mm_loadu_si128 ((const __m128i *) &y[i]);
+            __m128i s = _mm_sub_epi32 (a, b);
+            __m128i sat = _mm_srai_epi32 (_mm_and_si128 (_mm_xor_si128 (a, b),
+                                                         _mm_xor_si128 (a, s)), 31);
+            __m128i lim = _mm_xor_si128 (_mm_srai_epi32 (a, 31), max32);
+
+            ovf = _mm_or_si128 (ovf, sat);
+            _mm_storeu_si128 ((__m128i *) &z[i],
+                              _mm_or_si128 (_mm_andnot_si128 (sat, s), _mm_and_si128 (sat, lim)));
+        }
+        if (SSE2_ANY (ovf))
+            VEC_SET_OVERFLOW ();
+    }
+#endif
+    for (; i < n; i++)
+    {
+        z[i] = L_sub (x[i], y[i]);
+    }
+}
+
+
+/*****************************************************************************
+ *
+ *  Function Name : vec_L_shl, vec_L_shr
+ *
+ *  Purpose :
+ *
+ *    z[i] = L_shl(x[i], var2), z[i] = L_shr(x[i], var2).
+ *
+ *****************************************************************************/
+void vec_L_shl (const Word32 x[], Word16 var2, Word32 z[], Word16 n)
+{
+    Word16 i = 0;
+
+    if (var2 <= 0)
+    {
+        vec_L_shr (x, (Word16) ((var2 < -32) ? 32 : -var2), z, n);
+        return;
+    }
+#ifdef BASOP_VEC_SSE2
+    if (var2 <= 31)
+    {
+        const __m128i cnt = _mm_cvtsi32_si128 (var2);
+#ifdef BASOP_VEC_AVX2
+        {
+            const __m256i max32 = _mm256_set1_epi32 (MAX_32);
+            __m256i ovf = _mm256_setzero_si256 ();
+
+            for (; i + 8 <= n; i += 8)
+            {
+                __m256i a = _mm256_loadu_si256 ((const __m256i *) &x[i]);
+                __m256i s = _mm256_sll_epi32 (a, cnt);
+                __m256i sat = _mm256_xor_si256 (_mm256_cmpeq_epi32 (_mm256_sra_epi32 (s, cnt), a),
+                                                _mm256_set1_epi32 (-1));
+                __m256i lim = _mm256_xor_si256 (_mm256_srai_epi32 (a, 31), max32);
+
+                ovf = _mm256_or_si256 (ovf, sat);
+                _mm256_storeu_si256 ((__m256i *) &z[i], _mm256_blendv_epi8 (s, lim, sat));
+            }
+            if (AVX2_ANY (ovf))
+                VEC_SET_OVERFLOW ();
+        }
+#endif
+        {
+            const __m128i max32 = _mm_set1_epi32 (MAX_32);
+            __m128i ovf = _mm_setzero_si128 ();
+
+            for (; i + 4 <= n; i += 4)
+            {
+                __m128i a = _mm_loadu_si128 ((const __m128i *) &x[i]);
+                __m128i s = _mm_sll_epi32 (a, cnt);
+                __m128i sat = _mm_xor_si128 (_mm_cmpeq_epi32 (_mm_sra_epi32 (s, cnt), a),
+                                             _mm_set1_epi32 (-1));
+                __m128i lim = _mm_xor_si128 (_mm_srai_epi32 (a, 31), max32);
+
+                ovf = _mm_or_si128 (ovf, sat);
+                _mm_storeu_si128 ((__m128i *) &z[i],
+                                  _mm_or_si128 (_mm_andnot_si128 (sat, s), _mm_and_si128 (sat, lim)));
+            }
+            if (SSE2_ANY (ovf))
+                VEC_SET_OVERFLOW ();
+        }
+    }
+#endif
+    for (; i < n; i++)
+    {
+        z[i] = L_shl (x[i], var2);
+    }
+}
+
+void vec_L_shr (const Word32 x[], Word16 var2, Word32 z[], Word16 n)
+{
+    Word16 i = 0;
+
+    if (var2 < 0)
+    {
+        vec_L_shl (x, (Word16) ((var2 < -32) ? 32 : -var2), z, n);
+        return;
+    }
+#ifdef BASOP_VEC_SSE2
+    {
+        /* L_shr() of 31 or more leaves the sign, as an arithmetic shift by 31 */
+        const __m128i cnt = _mm_cvtsi32_si128 ((var2 > 31) ? 31 : var2);
+#ifdef BASOP_VEC_AVX2
+        for (; i + 8 <= n; i += 8)
+        {
+            __m256i a = _mm256_loadu_si256 ((const __m256i *) &x[i]);
+            _mm256_storeu_si256 ((__m256i *) &z[i], _mm256_sra_epi32 (a, cnt));
+        }
+#endif
+        for (; i + 4 <= n; i += 4)
+        {
+            __m128i a = _mm_loadu_si128 ((const __m128i *) &x[i]);
+            _mm_storeu_si128 ((__m128i *) &z[i], _mm_sra_epi32 (a, cnt));
+        }
+    }
+#endif
+    for (; i < n; i++)
+    {
+        z[i] = L_shr (x[i], var2);
+    }
+}
+
+
+/*****************************************************************************
+ *
+ *  Function Name : vec_norm_l, vec_norm_l_block
+ *
+ *  Purpose :
+ *
+ *    z[i] = norm_l(x[i]), and the block exponent of x[] (see basop_vec.h).
+ *    norm_l(x) is the number of redundant sign bits of x, which is also
+ *    the one of x ^ (x >> 31); the block exponent is therefore norm_l()
+ *    of the OR of these values over the block.
+ *
+ *****************************************************************************/
+void vec_norm_l (const Word32 x[], Word16 z[], Word16 n)
+{
+    Word16 i;
+
+    for (i = 0; i < n; i++)
+    {
+        z[i] = norm_l (x[i]);
+    }
+}
+
+Word16 vec_norm_l_block (const Word32 x[], Word16 n)
+{
+    Word16 i = 0;
+    Word16 var_out;
+
+#if (WMOPS)
+    Word16 e;
+
+    var_out = 31;
+    e = 0;
+    for (i = 0; i < n; i++)
+    {
+        if (x[i] != 0)
+        {
+            var_out = s_min (var_out, norm_l (x[i]));
+            e = 1;
+        }
+    }
+    if (e == 0)
+        var_out = 0;
+#else
+    UWord32 mag = 0, nz = 0;
+
+#ifdef BASOP_VEC_AVX2
+    {
+        __m256i vmag = _mm256_setzero_si256 ();
+        __m256i vnz = _mm256_setzero_si256 ();
+
+        for (; i + 8 <= n; i += 8)
+        {
+            __m256i a = _mm256_loadu_si256 ((const __m256i *) &x[i]);
+            vmag = _mm256_or_si256 (vmag, _mm256_xor_si256 (a, _mm256_srai_epi32 (a, 31)));
+            vnz = _mm256_or_si256 (vnz, a);
+        }
+        {
+            Word32 m[8], z8[8];
+            Word16 k;
+
+            _mm256_storeu_si256 ((__m256i *) m, vmag);
+            _mm256_storeu_si256 ((__m256i *) z8, vnz);
+            for (k = 0; k < 8; k++)
+            {
+                mag |= (UWord32) m[k];
+                nz |= (UWord32) z8[k];
+            }
+        }
+    }
+#endif
+#ifdef BASOP_VEC_SSE2
+    {
+        __m128i vmag = _mm_setzero_si128 ();
+        __m128i vnz = _mm_setzero_si128 ();
+        Word32 m[4], z4[4];
+        Word16 k;
+
+        for (; i + 4 <= n; i += 4)
+        {
+            __m128i a = _mm_loadu_si128 ((const __m128i *) &x[i]);
+            vmag = _mm_or_si128 (vmag, _mm_xor_si128 (a, _mm_srai_epi32 (a, 31)));
+            vnz = _mm_or_si128 (vnz, a);
+        }
+        _mm_storeu_si128 ((__m128i *) m, vmag);
+        _mm_storeu_si128 ((__m128i *) z4, vnz);
+        for (k = 0; k < 4; k++)
+        {
+            mag |= (UWord32) m[k];
+            nz |= (UWord32) z4[k];
+        }
+    }
+#endif
+    for (; i < n; i++)
+    {
+        mag |= (UWord32) (x[i] ^ (x[i] >> 31));
+        nz |= (UWord32) x[i];
+    }
+
+    if (nz == 0)
+        var_out = 0;
+    else if (mag == 0)
+        var_out = 31;           /* only 0 and -1 */
+    else
+        var_out = norm_l ((Word32) mag);
+#endif
+
+    return (var_out);
+}
+
+
+/*****************************************************************************
+ *
+ *  Function Name : vec_dot
+ *
+ *  Purpose :
+ *
+ *    Computes *sum = sum(x[i]*y[i]) and *mag = sum(|x[i]*y[i]|) exactly.
+ *    The products are accumulated per lane in 32 bits, and the loop gives
+ *    up (returns 0) as soon as a lane magnitude reaches 2^30 or an input
+ *    is MIN_16: the dot products are then out of the range where the
+ *    scalar loop cannot saturate anyway.
+ *
+ *****************************************************************************/
+#if !(WMOPS)
+static Flag vec_dot (const Word16 x[], const Word16 y[], Word16 n, Word40 *sum, Word40 *mag)
+{
+    Word16 i = 0;
+    Word40 s = 0, m = 0;
+
+#ifdef BASOP_VEC_AVX2
+    {
+        const __m256i min16 = _mm256_set1_epi16 (MIN_16);
+        __m256i vs = _mm256_setzero_si256 ();
+        __m256i vm = _mm256_setzero_si256 ();
+        __m256i bad = _mm256_setzero_si256 ();
+        Word32 ls[8], lm[8];
+        Word16 k;
+
+        for (; i + 16 <= n; i += 16)
+        {
+            __m256i a = _mm256_loadu_si256 ((const __m256i *) &x[i]);
+            __m256i b = _mm256_loadu_si256 ((const __m256i *) &y[i]);
+
+            bad = _mm256_or_si256 (bad, _mm256_or_si256 (_mm256_cmpeq_epi16 (a, min16), _mm256_cmpeq_epi16 (b, min16)));
+            vs = _mm256_add_epi32 (vs, _mm256_madd_epi16 (a, b));
+            vm = _mm256_add_epi32 (vm, _mm256_madd_epi16 (_mm256_abs_epi16 (a), _mm256_abs_epi16 (b)));
+            if (AVX2_ANY (_mm256_srli_epi32 (vm, 30)))
+                return 0;
+        }
+        if (AVX2_ANY (bad))
+            return 0;
+        _mm256_storeu_si256 ((__m256i *) ls, vs);
+        _mm256_storeu_si256 ((__m256i *) lm, vm);
+        for (k = 0; k < 8; k++)
+        {
+            s += ls[k];
+            m += lm[k];
+        }
+    }
+#endif
+#ifdef BASOP_VEC_SSE2
+    {
+        const __m128i min16 = _mm_set1_epi16 (MIN_16);
+        __m128i vs = _mm_setzero_si128 ();
+        __m128i vm = _mm_setzero_si128 ();
+        __m128i bad = _mm_setzero_si128 ();
+        Word32 ls[4], lm[4];
+        Word16 k;
+
+        for (; i + 8 <= n; i += 8)
+        {
+            __m128i a = _mm_loadu_si128 ((const __m128i *) &x[i]);
+            __m128i b = _mm_loadu_si128 ((const __m128i *) &y[i]);
+            __m128i sa = _mm_srai_epi16 (a, 15);
+            __m128i sb = _mm_srai_epi16 (b, 15);
+
+            bad = _mm_or_si128 (bad, _mm_or_si128 (_mm_cmpeq_epi16 (a, min16), _mm_cmpeq_epi16 (b, min16)));
+            vs = _mm_add_epi32 (vs, _mm_madd_epi16 (a, b));
+            vm = _mm_add_epi32 (vm, _mm_madd_epi16 (_mm_sub_epi16 (_mm_xor_si128 (a, sa), sa),
+                                                    _mm_sub_epi16 (_mm_xor_si128 (b, sb), sb)));
+            if (SSE2_ANY (_mm_srli_epi32 (vm, 30)))
+                return 0;
+        }
+        if (SSE2_ANY (bad))
+            return 0;
+        _mm_storeu_si128 ((__m128i *) ls, vs);
+        _mm_storeu_si128 ((__m128i *) lm, vm);
+        for (k = 0; k < 4; k++)
+        {
+            s += ls[k];
+            m += lm[k];
+        }
+    }
+#endif
+    for (; i < n; i++)
+    {
+        Word32 p = (Word32) x[i] * y[i];
+
+        if (x[i] == MIN_16 || y[i] == MIN_16)
+            return 0;
+        s += p;
+        m += (p < 0) ? -p : p;
+    }
+
+    *sum = s;
+    *mag = m;
+    return 1;
+}
+#endif
+
+
+/*****************************************************************************
+ *
+ *  Function Name : vec_L_mac, vec_L_msu, vec_L_mac0
+ *
+ *  Purpose :
+ *
+ *    Multiply-accumulate over arrays, L_var3 = L_mac(L_var3, x[i], y[i])
+ *    etc. for i = 0..n-1. When |L_var3| plus the sum of the product
+ *    magnitudes fits in 31 bits, no partial sum of the scalar loop can
+ *    saturate and the exact dot product is the result. Otherwise the
+ *    scalar loop runs, with its saturations and Overflow.
+ *
+ *****************************************************************************/
+Word32 vec_L_mac (Word32 L_var3, const Word16 x[], const Word16 y[], Word16 n)
+{
+    Word16 i;
+#if !(WMOPS)
+    Word40 sum, mag;
+    Word40 acc = (L_var3 < 0) ? -(Word40) L_var3 : (Word40) L_var3;
+
+    if (vec_dot (x, y, n, &sum, &mag) && acc + 2 * mag <= MAX_32)
+        return (Word32) (L_var3 + 2 * sum);
+#endif
+
+    for (i = 0; i < n; i++)
+    {
+        L_var3 = L_mac (L_var3, x[i], y[i]);
+    }
+    return (L_var3);
+}
+
+Word32 vec_L_msu (Word32 L_var3, const Word16 x[], const Word16 y[], Word16 n)
+{
+    Word16 i;
+#if !(WMOPS)
+    Word40 sum, mag;
+    Word40 acc = (L_var3 < 0) ? -(Word40) L_var3 : (Word40) L_var3;
+
+    if (vec_dot (x, y, n, &sum, &mag) && acc + 2 * mag <= MAX_32)
+        return (Word32) (L_var3 - 2 * sum);
+#endif
+
+    for (i = 0; i < n; i++)
+    {
+        L_var3 = L_msu (L_var3, x[i], y[i]);
+    }
+    return (L_var3);
+}
+
+Word32 vec_L_mac0 (Word32 L_var3, const Word16 x[], const Word16 y[], Word16 n)
+{
+    Word16 i;
+#if !(WMOPS)
+    Word40 sum, mag;
+    Word40 acc = (L_var3 < 0) ? -(Word40) L_var3 : (Word40) L_var3;
+
+    if (vec_dot (x, y, n, &sum, &mag) && acc + mag <= MAX_32)
+        return (Word32) (L_var3 + sum);
+#endif
+
+    for (i = 0; i < n; i++)
+    {
+        L_var3 = L_mac0 (L_var3, x[i], y[i]);
+    }
+    return (L_var3);
+}
+
+
+/* end of file */
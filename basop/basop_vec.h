@@ -0,0 +1,71 @@
+/*
+  ===========================================================================
+   File: BASOP_VEC.H                                     v.1.0 - 17.Oct.2026
+  ===========================================================================
+
+            ITU-T STL  BASIC OPERATORS
+
+            VECTOR OPERATORS
+
+   Array versions of the basic operators that are typically called in
+   codec inner loops. Each function gives the same results and the same
+   Overflow flag as the loop over the scalar operator shown next to its
+   prototype, so a loop can be replaced by a call without losing
+   bit-exactness.
+
+   The element-wise operators saturate lane by lane with SSE2/AVX2
+   instructions. The dot products first compute the exact sum with
+   SIMD. They return it if an exact bound shows that no partial sum of
+   the scalar loop would saturate. Otherwise they run the scalar loop.
+   The SIMD paths are chosen at compile time from __AVX2__ and __SSE2__.
+   Define BASOP_VEC_NO_SIMD to force the portable C code. In WMOPS builds
+   every function is the scalar loop, so operator counts are unchanged.
+
+   History:
+   17 Oct 26   v1.0     First version, vector operators
+  ============================================================================
+*/
+
+
+#ifndef _BASOP_VEC_H
+#define _BASOP_VEC_H
+
+
+#include "stl.h"
+
+
+/*
+ * Element-wise operators, z[i] = op(x[i], ...) for 0 <= i < n.
+ * z may be the same array as x or y.
+ */
+void vec_add (const Word16 x[], const Word16 y[], Word16 z[], Word16 n);     /* add()    */
+void vec_sub (const Word16 x[], const Word16 y[], Word16 z[], Word16 n);     /* sub()    */
+void vec_mult (const Word16 x[], const Word16 y[], Word16 z[], Word16 n);    /* mult()   */
+void vec_shl (const Word16 x[], Word16 var2, Word16 z[], Word16 n);          /* shl()    */
+void vec_shr (const Word16 x[], Word16 var2, Word16 z[], Word16 n);          /* shr()    */
+
+void vec_L_add (const Word32 x[], const Word32 y[], Word32 z[], Word16 n);   /* L_add()  */
+void vec_L_sub (const Word32 x[], const Word32 y[], Word32 z[], Word16 n);   /* L_sub()  */
+void vec_L_shl (const Word32 x[], Word16 var2, Word32 z[], Word16 n);        /* L_shl()  */
+void vec_L_shr (const Word32 x[], Word16 var2, Word32 z[], Word16 n);        /* L_shr()  */
+void vec_norm_l (const Word32 x[], Word16 z[], Word16 n);                    /* norm_l() */
+
+/*
+ * Dot products, L_var3 = op(L_var3, x[i], y[i]) for i = 0 .. n-1.
+ */
+Word32 vec_L_mac (Word32 L_var3, const Word16 x[], const Word16 y[], Word16 n);   /* L_mac()  */
+Word32 vec_L_msu (Word32 L_var3, const Word16 x[], const Word16 y[], Word16 n);   /* L_msu()  */
+Word32 vec_L_mac0 (Word32 L_var3, const Word16 x[], const Word16 y[], Word16 n);  /* L_mac0() */
+
+/*
+ * Block exponent: the smallest norm_l(x[i]) over the non-zero elements,
+ * i.e. the largest shift that L_shl() can apply to every element without
+ * saturating. Returns 0 when all elements are zero, like norm_l(0).
+ */
+Word16 vec_norm_l_block (const Word32 x[], Word16 n);
+
+
+#endif /* ifndef _BASOP_VEC_H */
+
+
+/* end of file */
@@ -32,6 +32,8 @@
                         L_mls() weight of 5.
                         div_l() weight of 32.
                         i_mult() weight of 3.
+                        Light counting backend (WMOPS_FAST), worst frame
+                        capture, per-frame CSV log and JSON output.
   ============================================================================
 */
 
@@ -49,15 +51,25 @@
 #include "stl.h"
 
 #ifdef WMOPS
-static double frameRate = FRAME_RATE; /* default value : 10 ms */ 
+static BASOP_TLS double frameRate = FRAME_RATE; /* default value : 10 ms */ 
 #endif /* ifdef WMOPS */
 
 #ifdef WMOPS
 /* Global counter variable for calculation of complexity weight */
-BASIC_OP multiCounter[MAXCOUNTERS];
-int currCounter=0; /* Zero equals global counter */
+BASOP_TLS BASIC_OP multiCounter[MAXCOUNTERS];
+BASOP_TLS int currCounter=0; /* Zero equals global counter */
 #endif /* ifdef WMOPS */
 
+#ifdef WMOPS_FAST
+/* Light counting: the operators add their weight to wmops_fast_count
+   (see wmops_fast.h), which is moved to fastCounter[currCounter] when
+   the counter group changes. */
+BASOP_TLS UWord32 wmops_fast_count = 0;
+BASOP_TLS UWord32 wmops_fast_else_count = 0;
+BASOP_TLS Flag    wmops_fast_else_pending = 0;
+static BASOP_TLS Word32 fastCounter[MAXCOUNTERS];
+#endif /* ifdef WMOPS_FAST */
+
 #ifdef WMOPS
 void setFrameRate(int samplingFreq, int frameLength)
 {
@@ -149,19 +161,64 @@ Word32 DeltaWeightedOperation (void);
 /* Counters for separating counting for different objects */
 
 
-static int maxCounter=0;
-static char* objectName[MAXCOUNTERS+1];
+static BASOP_TLS int maxCounter=0;
+static BASOP_TLS char* objectName[MAXCOUNTERS+1];
 
-static Word16 fwc_corr[MAXCOUNTERS+1];
-static long int nbTimeObjectIsCalled[MAXCOUNTERS+1];
+static BASOP_TLS Word16 fwc_corr[MAXCOUNTERS+1];
+static BASOP_TLS long int nbTimeObjectIsCalled[MAXCOUNTERS+1];
 
 #define NbFuncMax  1024
 
-static Word16 funcid[MAXCOUNTERS], nbframe[MAXCOUNTERS];
-static Word32 glob_wc[MAXCOUNTERS], wc[MAXCOUNTERS][NbFuncMax];
-static float total_wmops[MAXCOUNTERS];
+static BASOP_TLS Word16 funcid[MAXCOUNTERS], nbframe[MAXCOUNTERS];
+static BASOP_TLS Word32 glob_wc[MAXCOUNTERS], wc[MAXCOUNTERS][NbFuncMax];
+static BASOP_TLS float total_wmops[MAXCOUNTERS];
+
+static BASOP_TLS Word32 LastWOper[MAXCOUNTERS];
+
+/* frame of the worst case glob_wc[], counted from 0 */
+static BASOP_TLS Word32 glob_wc_frame[MAXCOUNTERS];
+
+/* per-frame log, see WMOPS_frame_log() */
+static BASOP_TLS FILE *frameLog = NULL;
+#endif /* ifdef WMOPS */
 
-static Word32 LastWOper[MAXCOUNTERS];
+
+#ifdef WMOPS
+static void WMOPS_flush() {
+/* adds the pending light counts to the current counter group */
+#ifdef WMOPS_FAST
+    fastCounter[currCounter] += (Word32) wmops_fast_count;
+    wmops_fast_count = 0;
+    wmops_fast_else_pending = 0;
+#endif /* ifdef WMOPS_FAST */
+}
+#endif /* ifdef WMOPS */
+
+
+#ifdef WMOPS
+static void WMOPS_print_string (FILE *f, const char *s, int json) {
+/* prints s as a JSON string (json != 0) or as a quoted CSV field */
+    fputc ('"', f);
+    for (; s != NULL && *s != '\0'; s++) {
+        if (*s == '"')
+            fputs (json ? "\\\"" : "\"\"", f);
+        else if (json && *s == '\\')
+            fputs ("\\\\", f);
+        else if (json && (unsigned char) *s < 0x20)
+            fprintf (f, "\\u%04x", (unsigned char) *s);
+        else
+            fputc (*s, f);
+    }
+    fputc ('"', f);
+}
+
+
+static void WMOPS_log_frame (Word32 tot) {
+/* appends the last frame of the current counter group to frameLog */
+    WMOPS_print_string (frameLog, objectName[currCounter], 0);
+    fprintf (frameLog, ",%d,%ld,%.6f\n", nbframe[currCounter] - 1,
+             (long) tot, ((float) tot) * frameRate);
+}
 #endif /* ifdef WMOPS */
 
 
@@ -219,13 +276,16 @@ char * readCounterIdName() {
 
 void setCounter( int counterId) {
 #if WMOPS
+   WMOPS_flush();
    if( (counterId > maxCounter)
     || (counterId < 0)) {
       currCounter=0;
       return;
    }
    currCounter=counterId;
+#ifndef WMOPS_FAST
    call_occurred = 1;
+#endif /* ifndef WMOPS_FAST */
 #endif /* ifdef WMOPS */
 }
 
@@ -250,8 +310,10 @@ static Word32 WMOPS_frameStat() {
     Word32 tot;
 
     tot = TotalWeightedOperation ();
-    if (tot > glob_wc[currCounter])
+    if (tot > glob_wc[currCounter]) {
         glob_wc[currCounter] = tot;
+        glob_wc_frame[currCounter] = (nbframe[currCounter] > 0) ? nbframe[currCounter] - 1 : 0;
+    }
 
     /* check if fwc() was forgotten at end of last frame */
     if (tot > LastWOper[currCounter]) {
@@ -271,12 +333,19 @@ static Word32 WMOPS_frameStat() {
 
 #ifdef WMOPS
 static void WMOPS_clearMultiCounter() {
+#ifdef WMOPS_FAST
+    fastCounter[currCounter] = 0;
+    wmops_fast_count = 0;
+    wmops_fast_else_pending = 0;
+
+#else /* ifdef WMOPS_FAST */
     Word16 i;
     
     Word32 *ptr = (Word32 *) &multiCounter[currCounter];
     for( i = 0; i < (sizeof (multiCounter[currCounter])/ sizeof (Word32)); i++) {
         *ptr++ = 0;
     }
+#endif /* ifdef WMOPS_FAST */
 }
 #endif /* ifdef WMOPS */
 
@@ -292,7 +361,10 @@ void ClearNbTimeObjectsAreCalled() {
 }
 
 Word32 TotalWeightedOperation () {
-#if WMOPS
+#if defined(WMOPS_FAST)
+    return (fastCounter[currCounter] + (Word32) wmops_fast_count);
+
+#elif WMOPS
     Word16 i;
     Word32 tot, *ptr, *ptr2;
 
@@ -337,6 +409,7 @@ void Init_WMOPS_counter (void) {
     for (i = 0; i < NbFuncMax; i++)
         wc[currCounter][i] = (Word32) 0;
     glob_wc[currCounter] = 0;
+    glob_wc_frame[currCounter] = 0;
     nbframe[currCounter] = 0;
     total_wmops[currCounter] = 0.0;
 
@@ -345,9 +418,11 @@ void Init_WMOPS_counter (void) {
     LastWOper[currCounter] = 0;
     funcid[currCounter] = 0;
 
+#ifndef WMOPS_FAST
     /* Following line is useful for incrIf(), see control.h */
     call_occurred = 1;
     funcId_where_last_call_to_else_occurred=MAXCOUNTERS;
+#endif /* ifndef WMOPS_FAST */
 #endif /* ifdef WMOPS */
 }
 
@@ -355,6 +430,10 @@ void Init_WMOPS_counter (void) {
 void Reset_WMOPS_counter (void) {
 #if WMOPS
     Word32 tot = WMOPS_frameStat();
+
+    /* log the frame that ends here (none before the first frame) */
+    if (frameLog != NULL && nbframe[currCounter] > 0)
+        WMOPS_log_frame(tot);
         
     /* increase the frame counter --> a frame is counted WHEN IT BEGINS */
     nbframe[currCounter]++;
@@ -471,10 +550,11 @@ void generic_WMOPS_output (Word16 dtx_mode, char *test_file_name)
 #if WMOPS
    int		saved_value;
    Word16	i;
-   Word32	tot, tot_wm, tot_wc, *ptr, *ptr2;
+   Word32	tot, tot_wm, tot_wc;
    Word40   grand_total;
    FILE	*WMOPS_file;
 
+   WMOPS_flush();
    saved_value = currCounter;
 
    /*Count the grand_total WMOPS so that % ratio per function group
@@ -562,7 +642,9 @@ void generic_WMOPS_output (Word16 dtx_mode, char *test_file_name)
       printf( "Can not open file %s for WMOPS editing.\n", WMOPS_TOTAL_FILENAME);
 
 
+#ifndef WMOPS_FAST /* no count per basic operation with the light backend */
    if( (WMOPS_file=fopen(CODE_PROFILE_FILENAME,"a"))!=NULL) {
+      Word32 *ptr, *ptr2;
 
       printf( "opened file %s in order to print basic operation distribution statistics.\n", CODE_PROFILE_FILENAME);
 
@@ -600,9 +682,145 @@ void generic_WMOPS_output (Word16 dtx_mode, char *test_file_name)
 
    } else
       printf( "Can not open file %s for basic operations distribution statistic editing\n", CODE_PROFILE_FILENAME);
+#endif /* ifndef WMOPS_FAST */
+
+   currCounter = saved_value;
+
+#endif /* ifdef WMOPS */
+}
+
+
+void WMOPS_frame_log (char *file_name) {
+#if WMOPS
+    int saved_value;
+    Word32 tot;
+
+    if (frameLog != NULL) {
+        /* log the frames still in progress, then close the log */
+        WMOPS_flush();
+        saved_value = currCounter;
+        for( currCounter = 0; currCounter <= maxCounter; currCounter++) {
+            tot = WMOPS_frameStat();
+            if (nbframe[currCounter] > 0 && tot > 0)
+                WMOPS_log_frame (tot);
+        }
+        currCounter = saved_value;
+        fclose (frameLog);
+        frameLog = NULL;
+    }
 
+    if (file_name != NULL) {
+        if ((frameLog = fopen (file_name, "w")) == NULL) {
+            printf ("Can not open file %s for WMOPS frame log\n", file_name);
+            return;
+        }
+        fprintf (frameLog, "group,frame,operations,wmops\n");
+    }
+#else /* ifdef WMOPS */
+    (void) file_name;  /* Dummy */
+
+#endif /* ifdef WMOPS */
+}
+
+
+void WMOPS_output_json (Word16 dtx_mode, char *test_file_name, char *file_name)
+{
+#if WMOPS
+   int     saved_value;
+   Word16  i;
+   Word32  tot, tot_wc;
+   float   average, grand_average, grand_wc, grand_wwc;
+   FILE    *f;
+
+   if (file_name == NULL)
+      file_name = WMOPS_JSON_FILENAME;
+   if ((f = fopen (file_name, "w")) == NULL) {
+      printf ("Can not open file %s for WMOPS editing\n", file_name);
+      return;
+   }
+
+   WMOPS_flush();
+   saved_value = currCounter;
+   grand_average = grand_wc = grand_wwc = 0;
+
+   fprintf (f, "{\n  \"test\": ");
+   WMOPS_print_string (f, test_file_name, 1);
+#ifdef WMOPS_FAST
+   fprintf (f, ",\n  \"backend\": \"light\"");
+#else /* ifdef WMOPS_FAST */
+   fprintf (f, ",\n  \"backend\": \"basop32\"");
+#endif /* ifdef WMOPS_FAST */
+   fprintf (f, ",\n  \"groups\": [");
+
+   for( currCounter = 0; currCounter <= maxCounter; currCounter++) {
+      tot = WMOPS_frameStat();
+      average = 0;
+      if (nbframe[currCounter] != 0)
+         average = (total_wmops[currCounter] + ((float) tot) * frameRate) / nbframe[currCounter];
+      tot_wc = 0L;
+      for (i = 0; i < funcid[currCounter]; i++)
+         tot_wc += wc[currCounter][i];
+
+      fprintf (f, "%s\n    {\"name\": ", currCounter > 0 ? "," : "");
+      WMOPS_print_string (f, objectName[currCounter], 1);
+      fprintf (f, ", \"frames\": %d", nbframe[currCounter]);
+      fprintf (f, ", \"calls\": %ld", nbTimeObjectIsCalled[currCounter]);
+      fprintf (f, ", \"wmops\": %.6f", ((float) tot) * frameRate);
+      fprintf (f, ", \"average\": %.6f", average);
+      fprintf (f, ", \"worst_case\": %.6f", ((float) glob_wc[currCounter]) * frameRate);
+      fprintf (f, ", \"worst_frame\": %ld", (long) glob_wc_frame[currCounter]);
+
+      /* Worst worst case and its parts between fwc() calls, only when not in DTX mode */
+      if (dtx_mode == 0) {
+         fprintf (f, ", \"worst_worst_case\": %.6f", ((float) tot_wc) * frameRate);
+         fprintf (f, ", \"worst_case_parts\": [");
+         for (i = 0; i < funcid[currCounter]; i++)
+            fprintf (f, "%s%.6f", i > 0 ? ", " : "", ((float) wc[currCounter][i]) * frameRate);
+         fprintf (f, "]");
+      }
+      fprintf (f, "}");
+
+      grand_average += average;
+      grand_wc += ((float) glob_wc[currCounter]) * frameRate;
+      grand_wwc += ((float) tot_wc) * frameRate;
+   }
+   fprintf (f, "\n  ],\n  \"total\": {\"average\": %.6f, \"worst_case\": %.6f", grand_average, grand_wc);
+   if (dtx_mode == 0)
+      fprintf (f, ", \"worst_worst_case\": %.6f", grand_wwc);
+   fprintf (f, "}");
+
+#ifndef WMOPS_FAST
+   {
+      /* WMOPS of the current frame per basic operation, over all counter groups */
+      Word32 *ptr, *ptr2;
+      Word16 n = 0;
+
+      fprintf (f, ",\n  \"operators\": {");
+      for( i = 0; i <(sizeof(op_weight) / sizeof(Word32)); i++) {
+         tot = 0;
+         ptr = (Word32 *) &multiCounter[0] + i;
+         ptr2 = (Word32 *) &op_weight + i;
+         for( currCounter = 0; currCounter <= maxCounter; currCounter++) {
+            tot += ((*ptr) * (*ptr2));
+            ptr += (sizeof(op_weight) / sizeof(Word32));
+         }
+         if (tot != 0)
+            fprintf (f, "%s\n    \"%s\": %.6f", n++ > 0 ? "," : "",
+                     BasicOperationList[i], ((float) tot) * frameRate);
+      }
+      fprintf (f, "\n  }");
+   }
+#endif /* ifndef WMOPS_FAST */
+
+   fprintf (f, "\n}\n");
+   fclose (f);
    currCounter = saved_value;
 
+#else /* ifdef WMOPS */
+   (void) dtx_mode;  /* Dummy */
+   (void) test_file_name;
+   (void) file_name;
+
 #endif /* ifdef WMOPS */
 }
 
@@ -27,6 +27,8 @@
                         L_mls() weight of 5.
                         div_l() weight of 32.
                         i_mult() weight of 3.
+                        Light counting backend (WMOPS_FAST), worst frame
+                        capture, per-frame CSV log and JSON output.
   ============================================================================
 */
 
@@ -61,6 +63,13 @@
 #define _COUNT_H "$Id$"
 /*#define WMOPS 1*/		    /* enable WMOPS profiling features  */
  #undef WMOPS			/* disable WMOPS profiling features */
+
+/*
+ * Compiling with -DWMOPS_FAST -DBASOP_INLINE instead enables the light
+ * counting backend of wmops_fast.h: the same functions and reports as
+ * with WMOPS, at a fraction of the run time, without the count per
+ * basic operation.
+ */
 #define MAXCOUNTERS (256)
 
 int getCounterId( char *objectName);
@@ -178,6 +187,13 @@ void setFrameRate(int samplingFreq, int frameLength);
 */
 
 
+#define WMOPS_JSON_FILENAME	"wmops.json"
+/*
+ * WMOPS_JSON_FILENAME is the macro defining the default name of the
+ * file written by WMOPS_output_json().
+*/
+
+
 #define FRAME_RATE	(0.0001F) /*in this version frame_rate can be overwriten online by the new setFrameRate function */
 /* FRAME_RATE of 0.000025 is corresponding to 40ms frame.*/
 /* FRAME_RATE of 0.00005 is corresponding to 20ms frame.*/
@@ -344,6 +360,32 @@ void generic_WMOPS_output ( Word16 notPrintWorstWorstCase, char *test_file_name)
  */
 
 
+void WMOPS_output_json (Word16 notPrintWorstWorstCase, char *test_file_name, char *file_name);
+/*
+ * This function writes the statistics of all the function groups to the
+ * file file_name (WMOPS_JSON_FILENAME if NULL) as a JSON object, for
+ * automated complexity regression checks. The file is overwritten.
+ *
+ * For each function group it gives the number of frames and of calls,
+ * the WMOPS of the current frame, the average, the worst case and the
+ * frame where it occurred (counted from 0), and, unless
+ * notPrintWorstWorstCase is non zero, the worst worst case with the
+ * worst case of each part between fwc() calls. A "total" object sums the
+ * groups. Except with WMOPS_FAST, "operators" gives the WMOPS of the
+ * current frame per basic operation.
+ */
+
+
+void WMOPS_frame_log (char *file_name);
+/*
+ * Starts a per-frame log of all the function groups in the CSV file
+ * file_name (overwritten), with the header line
+ * "group,frame,operations,wmops". Reset_WMOPS_counter() then appends a
+ * line for the frame it ends. WMOPS_frame_log(NULL) logs the frames in
+ * progress and closes the file.
+ */
+
+
 #if 0
 /*
  * Example of how count.h could be used.
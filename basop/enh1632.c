@@ -54,11 +54,12 @@
  *****************************************************************************/
 #include <stdio.h>
 #include <stdlib.h>
+#define WMOPS_FAST_NO_WRAP  /* operator definitions, see wmops_fast.h */
 #include "stl.h"
 
 #if (WMOPS)
-extern BASIC_OP multiCounter[MAXCOUNTERS];
-extern int currCounter;
+extern BASOP_TLS BASIC_OP multiCounter[MAXCOUNTERS];
+extern BASOP_TLS int currCounter;
 #endif /* ifdef WMOPS */
 
 
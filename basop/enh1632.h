@@ -38,8 +38,8 @@
 
 #if (WMOPS)
 #include "count.h"
-extern BASIC_OP multiCounter[MAXCOUNTERS];
-extern int currCounter;
+extern BASOP_TLS BASIC_OP multiCounter[MAXCOUNTERS];
+extern BASOP_TLS int currCounter;
 #endif /* ifdef WMOPS */
 
 
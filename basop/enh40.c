@@ -62,11 +62,16 @@
  *****************************************************************************/
 #include <stdio.h>
 #include <stdlib.h>
+#define WMOPS_FAST_NO_WRAP  /* operator definitions, see wmops_fast.h */
 #include "stl.h"
 
+/* With BASOP_ENH40 and BASOP_INLINE, stl.h supplies the operators (enh40_inline.h) */
+#ifndef _ENH40_INLINE_H
+#include "enh40.h"
+
 #if (WMOPS)
-extern BASIC_OP multiCounter[MAXCOUNTERS];
-extern int currCounter;
+extern BASOP_TLS BASIC_OP multiCounter[MAXCOUNTERS];
+extern BASOP_TLS int currCounter;
 #endif /* ifdef WMOPS */
 
 
@@ -1044,4 +1049,7 @@ Word40 L40_shl_r( Word40 L40_var1, Word16 var2) {
 }
 
 
+#endif /* ifndef _ENH40_INLINE_H */
+
+
 /* end of file */
@@ -27,8 +27,8 @@
 
 
 #ifdef WMOPS
-extern BASIC_OP multiCounter[MAXCOUNTERS];
-extern int currCounter;
+extern BASOP_TLS BASIC_OP multiCounter[MAXCOUNTERS];
+extern BASOP_TLS int currCounter;
 #endif /* ifdef WMOPS */
 
 
@@ -51,8 +51,12 @@ extern int currCounter;
  *  the application will exit.
  *
  *****************************************************************************/
+#ifndef L40_OVERFLOW_OCCURED
 #define L40_OVERFLOW_OCCURED(  L40_var1) (Overflow = 1, exit(1), L40_var1) 
+#endif
+#ifndef L40_UNDERFLOW_OCCURED
 #define L40_UNDERFLOW_OCCURED( L40_var1) (Overflow = 1, exit(2), L40_var1)
+#endif
 
 
  
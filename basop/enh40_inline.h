@@ -0,0 +1,325 @@
+/*
+  ===========================================================================
+   File: ENH40_INLINE.H                                  v.1.0 - 17.Oct.2026
+  ===========================================================================
+
+            ITU-T  STL  BASIC OPERATORS
+
+            40-BIT ARITHMETIC OPERATORS, NATIVE 64-BIT IMPLEMENTATION
+
+   Drop-in replacement for enh40.h/enh40.c on hosts with a native 64-bit
+   integer type. Word40 values are kept sign-extended in 64 bits, all
+   operators are "static __inline", and the shift/normalization loops of
+   enh40.c are replaced by direct computations. The 40-bit overflow and
+   underflow checks stay at the same points, with the same conditions,
+   as in enh40.c. Results, the Overflow flag and the calls to
+   L40_OVERFLOW_OCCURED()/L40_UNDERFLOW_OCCURED() are bit-exact with
+   enh40.c for all inputs in the documented operator ranges.
+
+   The header is selected from stl.h when both BASOP_ENH40 and
+   BASOP_INLINE are defined and WMOPS counting is off.
+
+   History:
+   17 Oct 26   v1.0     First version, native 40-bit operators
+                        (BASOP_ENH40 + BASOP_INLINE)
+  ============================================================================
+*/
+
+
+#ifndef _ENH40_INLINE_H
+#define _ENH40_INLINE_H
+
+
+#include "stl.h"
+
+#if (WMOPS)
+#error "enh40_inline.h cannot be used with WMOPS counting, use enh40.c"
+#endif
+
+
+/*****************************************************************************
+ *
+ *  Constants and Globals
+ *
+ *****************************************************************************/
+#ifndef MAX_40
+#define MAX_40 ((Word40) 0x0000007fffffffffLL)
+#define MIN_40 ((Word40) -0x0000008000000000LL)
+#endif
+
+/* bit 39 of a Word40, as tested by enh40.c */
+#define L40_SIGN(L40_var1) ((( L40_var1) >> 39) & 1)
+
+
+/*****************************************************************************
+ *
+ *  Macros for 40 bit arithmetic overflow management :
+ *  Upon 40-bit overflow beyond MAX_40 or underflow beyond MIN_40,
+ *  the application will exit.
+ *
+ *****************************************************************************/
+#ifndef L40_OVERFLOW_OCCURED
+#define L40_OVERFLOW_OCCURED(  L40_var1) (Overflow = 1, exit(1), L40_var1)
+#endif
+#ifndef L40_UNDERFLOW_OCCURED
+#define L40_UNDERFLOW_OCCURED( L40_var1) (Overflow = 1, exit(2), L40_var1)
+#endif
+
+
+/*****************************************************************************
+ *
+ *  Local Functions
+ *
+ *****************************************************************************/
+
+/* number of significant bits of a non-negative value (0 for 0) */
+static __inline Word16 L40_bitlen( Word40 L40_var1) {
+#if defined(__GNUC__) || defined(__clang__)
+   return (L40_var1 == 0) ? 0 : (Word16) (64 - __builtin_clzll( (unsigned long long) L40_var1));
+#else
+   Word16 var_out = 0;
+
+   while( L40_var1 != 0) {
+      L40_var1 >>= 1;
+      var_out++;
+   }
+   return( var_out);
+#endif
+}
+
+
+/*****************************************************************************
+ *
+ *  Functions
+ *
+ *****************************************************************************/
+
+static __inline Word40 L40_set( Word40 L40_var1) {
+   return( ((L40_var1 & 0x000000ffffffffffLL) ^ 0x0000008000000000LL) - 0x0000008000000000LL);
+}
+
+static __inline UWord16 Extract40_H( Word40 L40_var1) {
+   return( ( UWord16)( L40_var1 >> 16));
+}
+
+static __inline UWord16 Extract40_L( Word40 L40_var1) {
+   return( ( UWord16)( L40_var1));
+}
+
+static __inline UWord32 L_Extract40( Word40 L40_var1) {
+   return( ( UWord32) L40_var1);
+}
+
+static __inline Word40 L40_deposit_h( Word16 var1) {
+   return( (( Word40) var1) * 65536);
+}
+
+static __inline Word40 L40_deposit_l( Word16 var1) {
+   return( ( Word40) var1);
+}
+
+static __inline Word40 L40_deposit32( Word32 L_var1) {
+   return( ( Word40) L_var1);
+}
+
+static __inline Word40 L40_add( Word40 L40_var1, Word40 L40_var2) {
+   Word40 L40_var_out;
+
+   L40_var_out = L40_var1 + L40_var2;
+
+   if( L40_SIGN( L40_var1) && L40_SIGN( L40_var2) && !L40_SIGN( L40_var_out)) {
+      L40_var_out = L40_UNDERFLOW_OCCURED( L40_var_out);
+
+   } else if( !L40_SIGN( L40_var1) && !L40_SIGN( L40_var2) && L40_SIGN( L40_var_out)) {
+      L40_var_out = L40_OVERFLOW_OCCURED( L40_var_out);
+   }
+   return( L40_var_out);
+}
+
+static __inline Word40 L40_sub( Word40 L40_var1, Word40 L40_var2) {
+   Word40 L40_var_out;
+
+   L40_var_out = L40_var1 - L40_var2;
+
+   if( L40_SIGN( L40_var1) && !L40_SIGN( L40_var2) && !L40_SIGN( L40_var_out)) {
+      L40_var_out = L40_UNDERFLOW_OCCURED( L40_var_out);
+
+   } else if( !L40_SIGN( L40_var1) && L40_SIGN( L40_var2) && L40_SIGN( L40_var_out)) {
+      L40_var_out = L40_OVERFLOW_OCCURED( L40_var_out);
+   }
+   return( L40_var_out);
+}
+
+static __inline Word40 L40_negate( Word40 L40_var1) {
+   return( L40_add( ~L40_var1, 0x01));
+}
+
+static __inline Word40 L40_abs( Word40 L40_var1) {
+   return( (L40_var1 < 0) ? L40_negate( L40_var1) : L40_var1);
+}
+
+static __inline Word40 L40_max( Word40 L40_var1, Word40 L40_var2) {
+   return( (L40_var1 < L40_var2) ? L40_var2 : L40_var1);
+}
+
+static __inline Word40 L40_min( Word40 L40_var1, Word40 L40_var2) {
+   return( (L40_var1 < L40_var2) ? L40_var1 : L40_var2);
+}
+
+/*
+ * The loop of enh40.c checks, before each of the var2 doublings, that the
+ * value is in [-2^38, 2^38-1]. Values only grow in magnitude, so it fails
+ * iff the last check, on L40_var1 * 2^(var2-1), fails. Only then is the
+ * loop run, to pass the same value to the overflow macros.
+ */
+static __inline Word40 L40_shr( Word40 L40_var1, Word16 var2);
+
+static __inline Word40 L40_shl( Word40 L40_var1, Word16 var2) {
+   Word16 k;
+
+   if( var2 < 0)
+      return( L40_shr( L40_var1, (Word16) ((var2 < -63) ? 63 : -var2)));
+   if( var2 == 0 || L40_var1 == 0)
+      return( L40_var1);
+
+   k = var2 - 1;
+   if( (k < 39)
+    && (L40_var1 <= (0x0000003fffffffffLL >> k))
+    && (L40_var1 >= -(( Word40) 1 << (38 - k))))
+      return( L40_var1 * (( Word40) 1 << var2));
+
+   for( ;; L40_var1 *= 2) {
+      if( L40_var1 > 0x003fffffffffLL)
+         return( L40_OVERFLOW_OCCURED( L40_var1));
+      if( L40_var1 < -0x004000000000LL)
+         return( L40_UNDERFLOW_OCCURED( L40_var1));
+   }
+}
+
+static __inline Word40 L40_shr( Word40 L40_var1, Word16 var2) {
+   if( var2 < 0)
+      return( L40_shl( L40_var1, (Word16) ((var2 < -64) ? 64 : -var2)));
+   return( L40_var1 >> ((var2 > 63) ? 63 : var2));
+}
+
+static __inline Word40 L40_shr_r( Word40 L40_var1, Word16 var2) {
+   Word40 L40_var_out;
+
+   if( var2 > 39)
+      return( 0);
+
+   L40_var_out = L40_shr( L40_var1, var2);
+   if( var2 > 0 && (L40_var1 & (( Word40) 1 << (var2 - 1))) != 0)
+      L40_var_out++;
+   return( L40_var_out);
+}
+
+static __inline Word40 L40_shl_r( Word40 L40_var1, Word16 var2) {
+   if( var2 >= 0)
+      return( L40_shl( L40_var1, var2));
+   return( L40_shr_r( L40_var1, (Word16) -var2));
+}
+
+static __inline Word40 L40_lshl( Word40 L40_var1, Word16 var2) {
+   if( var2 <= 0) {
+      int n = -var2;
+      return( (n >= 40) ? 0 : (L40_var1 & 0x000000ffffffffffLL) >> n);
+   }
+   if( var2 >= 40)
+      return( 0);
+   return( L40_set( ( Word40) (( unsigned long long) L40_var1 << var2)));
+}
+
+static __inline Word40 L40_lshr( Word40 L40_var1, Word16 var2) {
+   if( var2 < 0)
+      return( L40_lshl( L40_var1, (Word16) ((var2 < -40) ? 40 : -var2)));
+   return( (var2 >= 40) ? 0 : (L40_var1 & 0x000000ffffffffffLL) >> var2);
+}
+
+/*
+ * enh40.c shifts left while the value is inside ]MIN_32, MAX_32[ and then
+ * right while it is outside [MIN_32, MAX_32]. Both loops end at the shift
+ * that leaves 31 - bitlen bits of headroom, where bitlen counts the
+ * significant bits of L40_var1 (of ~L40_var1 for negative values).
+ */
+static __inline Word16 norm_L40( Word40 L40_var1) {
+   if( L40_var1 == 0)
+      return( 0);
+   return( (Word16) (31 - L40_bitlen( (L40_var1 < 0) ? ~L40_var1 : L40_var1)));
+}
+
+static __inline Word32 L_saturate40( Word40 L40_var1) {
+   if( L40_var1 < ( Word40) MIN_32) {
+      L40_var1 = ( Word40) MIN_32;
+      Overflow = 1;
+   }
+   if( L40_var1 > ( Word40) MAX_32) {
+      L40_var1 = ( Word40) MAX_32;
+      Overflow = 1;
+   }
+   return( ( Word32) L40_var1);
+}
+
+static __inline Word40 L40_round( Word40 L40_var1) {
+   return( L40_add( 0x8000, L40_var1) & ~( Word40) 0xffff);
+}
+
+static __inline Word16 round40( Word40 L40_var1) {
+   return( extract_h( L_saturate40( L40_round( L40_var1))));
+}
+
+static __inline Word40 L40_mult( Word16 var1, Word16 var2) {
+   return( (( Word40) (( Word32) var1 * ( Word32) var2)) * 2);
+}
+
+static __inline Word40 L40_mac( Word40 L40_var1, Word16 var2, Word16 var3) {
+   return( L40_add( L40_var1, L40_mult( var2, var3)));
+}
+
+static __inline Word16 mac_r40( Word40 L40_var1, Word16 var2, Word16 var3) {
+   return( round40( L40_mac( L40_var1, var2, var3)));
+}
+
+static __inline Word40 L40_msu( Word40 L40_var1, Word16 var2, Word16 var3) {
+   return( L40_sub( L40_var1, L40_mult( var2, var3)));
+}
+
+static __inline Word16 msu_r40( Word40 L40_var1, Word16 var2, Word16 var3) {
+   return( round40( L40_msu( L40_var1, var2, var3)));
+}
+
+/*
+ * 32x16 and 32x32 products: the partial products of enh40.c add up to the
+ * exact doubled product, of which they return the high and low parts.
+ */
+static __inline void Mpy_32_16_ss( Word32 L_var1, Word16 var2, Word32 *L_varout_h, UWord16 *varout_l) {
+   Word40 L40_var1;
+
+   if( (L_var1 == ( Word32) 0x80000000) && (var2 == ( Word16) 0x8000)) {
+      *L_varout_h = 0x7fffffff;
+      *varout_l = ( UWord16) 0xffff;
+   } else {
+      L40_var1 = ( Word40) L_var1 * var2 * 2;
+      *varout_l = ( UWord16) L40_var1;
+      *L_varout_h = ( Word32) (L40_var1 >> 16);
+   }
+}
+
+static __inline void Mpy_32_32_ss( Word32 L_var1, Word32 L_var2, Word32 *L_varout_h, UWord32 *L_varout_l) {
+   Word40 L40_var1;
+
+   if( (L_var1 == ( Word32) 0x80000000) && (L_var2 == ( Word32) 0x80000000)) {
+      *L_varout_h = 0x7fffffff;
+      *L_varout_l = ( UWord32) 0xffffffff;
+   } else {
+      L40_var1 = ( Word40) L_var1 * L_var2 * 2;
+      *L_varout_l = ( UWord32) L40_var1;
+      *L_varout_h = ( Word32) (L40_var1 >> 32);
+   }
+}
+
+
+#endif /*_ENH40_INLINE_H*/
+
+
+/* end of file */
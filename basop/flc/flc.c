@@ -23,6 +23,31 @@
 
 #ifndef DONT_COUNT
 
+#ifdef FLC_THREAD_SAFE
+#if defined(_WIN32)
+#include <windows.h>
+static SRWLOCK flc_lock = SRWLOCK_INIT;
+#define FLC_LOCK()    AcquireSRWLockExclusive(&flc_lock)
+#define FLC_UNLOCK()  ReleaseSRWLockExclusive(&flc_lock)
+#else
+#include <pthread.h>
+static pthread_mutex_t flc_lock = PTHREAD_MUTEX_INITIALIZER;
+#define FLC_LOCK()    pthread_mutex_lock(&flc_lock)
+#define FLC_UNLOCK()  pthread_mutex_unlock(&flc_lock)
+#endif
+#if defined(_MSC_VER)
+#define FLC_TLS __declspec(thread)
+#elif defined(__STDC_VERSION__) && (__STDC_VERSION__ >= 201112L) && !defined(__STDC_NO_THREADS__)
+#define FLC_TLS _Thread_local
+#else
+#define FLC_TLS __thread
+#endif
+#else
+#define FLC_LOCK()
+#define FLC_UNLOCK()
+#define FLC_TLS
+#endif
+
 /* printing behavioral defines */
 #define FLC_MAXPREFIXLEN  8
 #define FLC_MAXTAGLEN     17
@@ -56,8 +81,34 @@ struct FLC_Mem_Data
    char *context;
 };
 
+/* ops of a pipeline stage, see FLC_stage_start() */
+struct FLC_Stage_Data
+{
+   struct FLC_Stage_Data *next;
+   char name[FLC_MAXTAGLEN+1];
+   unsigned long invocations;
+   unsigned long frames;
+   double fn_total;
+   unsigned long fn_max;
+   unsigned long op_cnt;
+   int active;                  /* the stage ran in the current frame */
+};
+
+/* the counters of one thread */
+struct FLC_Context
+{
+   struct FLC_Context *next;
+   struct FLC_Ops_Data *top;
+   struct FLC_Ops_Data *current;
+   struct FLC_Ops_Data *total;
+   struct FLC_Stage_Data *stages;
+   struct FLC_Stage_Data *stage;
+};
+
 typedef struct FLC_Ops_Data FLC_Ops_Data;
 typedef struct FLC_Mem_Data FLC_Mem_Data;
+typedef struct FLC_Stage_Data FLC_Stage_Data;
+typedef struct FLC_Context FLC_Context;
 
 static char *Op_Names[FLC_OPEND] = {
    "NOP",
@@ -102,14 +153,37 @@ static FLC_Mem_Summaries *FLC_Mem_find_function(FLC_Mem_Summaries *top,
                                                 char *name);
 
 /* global variables */
-FLC_Ops_Data *ops_top;
-FLC_Ops_Data *ops_current;
-FLC_Ops_Data *ops_total;
 FLC_Mem_Data *mem_top;
 FILE *FLC_output;
 unsigned long totals[FLC_OPEND];
 
+/*
+ * Each thread counts into its own context, created at its first count.
+ * All contexts are linked from ctx_top, in creation order, and are
+ * merged by FLC_end(). FLC_init() starts a new generation of contexts.
+ */
+static FLC_Context *ctx_top = NULL;
+static unsigned long ctx_generation = 0;
+static FLC_TLS FLC_Context *ctx_thread = NULL;
+static FLC_TLS unsigned long ctx_thread_generation = 0;
+
+/* the counters of the calling thread */
+#define ops_top        (ctx_thread->top)
+#define ops_current    (ctx_thread->current)
+#define ops_total      (ctx_thread->total)
+#define stage_top      (ctx_thread->stages)
+#define stage_current  (ctx_thread->stage)
+
+static FLC_Context *FLC_context_new();
+static void FLC_context_free(FLC_Context *ctx);
+static void FLC_thread_context();
+static int FLC_context_used(FLC_Context *ctx);
+static FLC_Context *FLC_context_merge();
+
+static FLC_Ops_Data *FLC_Ops_new(FLC_Ops_Data *parent, char *name);
 static FLC_Ops_Data *search_Ops_list(FLC_Ops_Data *top, char *name);
+static FLC_Stage_Data *search_Stage_list(FLC_Stage_Data *top, char *name);
+static void FLC_mem_add(int op, int c);
 
 static void FLC_Ops_header();
 static void FLC_Ops_print(char *prefix, FLC_Ops_Data *pL);
@@ -119,6 +193,8 @@ static void FLC_Mem_print();
 
 static void FLC_print_sum();
 static void FLC_print_frame_sum();
+static void FLC_print_thread_sum(int n_used);
+static void FLC_print_stage_sum();
 
 /*
  * FLC initialisation. Must be called at start, sets up all the
@@ -128,24 +204,23 @@ static void FLC_print_frame_sum();
  */
 void FLC_init()
 {
-   FLC_output = stderr;
+   FLC_Context *ctx;
 
-   ops_top = (FLC_Ops_Data *) malloc(sizeof(struct FLC_Ops_Data));
-   if (!ops_top)
-      perror("Allocation mem (ops_top) for flc");
-   ops_total = (FLC_Ops_Data *) malloc(sizeof(struct FLC_Ops_Data));
-   if (!ops_total)
-      perror("Allocation mem (ops_total) for flc");
+   FLC_output = stderr;
 
-   ops_current = ops_top;
+   /* drop the contexts of a previous run that was not ended */
+   FLC_LOCK();
+   while (ctx_top)
+   {
+      ctx = ctx_top;
+      ctx_top = ctx->next;
+      FLC_context_free(ctx);
+   }
+   ctx_generation++;
+   FLC_UNLOCK();
 
-   /* clear the structures */
-   memset(ops_current, 0, sizeof(struct FLC_Ops_Data));
-   strcpy(ops_current->name, "ROOT");
-   ops_current->invocations++;
-   memset(ops_total, 0, sizeof(struct FLC_Ops_Data));
-   strcpy(ops_total->name, "TOTAL");
-   ops_total->invocations = 0;  /* this field is actually the frame count */
+   /* the context of the calling thread */
+   FLC_thread_context();
 
    /* the mem count structure is initialised a NULL pointer */
    mem_top = NULL;
@@ -173,6 +248,32 @@ static void FLC_free_node(FLC_Ops_Data *node)
 
 void FLC_end()
 {
+   FLC_Context *ctx, *merged;
+   FLC_Mem_Data *pM;
+   int n_ctx, n_used;
+
+   /* all threads must have stopped counting here */
+   FLC_LOCK();
+   n_ctx = n_used = 0;
+   for (ctx = ctx_top; ctx; ctx = ctx->next)
+   {
+      n_ctx++;
+      if (FLC_context_used(ctx))
+         n_used++;
+   }
+
+   /* the report is printed from a single context */
+   merged = NULL;
+   if (n_ctx > 1)
+   {
+      merged = FLC_context_merge();
+      ctx_thread = merged;
+   }
+   else
+   {
+      ctx_thread = ctx_top;
+   }
+
    fprintf(FLC_output, "\n===== Call Graph and total ops per function =====\n\n");
    FLC_Ops_header();
    FLC_Ops_print("", ops_top);
@@ -185,10 +286,33 @@ void FLC_end()
    {
       FLC_print_frame_sum();
    }
+   if (n_used > 1)
+   {
+      FLC_print_thread_sum(n_used);
+   }
+   if (stage_top != NULL)
+   {
+      FLC_print_stage_sum();
+   }
 
-   FLC_free_node(ops_top);
-   free(ops_total);
-   free(ops_top);
+   /* free all the counters, the next FLC_init() starts from scratch */
+   while (ctx_top)
+   {
+      ctx = ctx_top;
+      ctx_top = ctx->next;
+      FLC_context_free(ctx);
+   }
+   if (merged)
+      FLC_context_free(merged);
+   while (mem_top)
+   {
+      pM = mem_top;
+      mem_top = pM->next;
+      free(pM);
+   }
+   ctx_thread = NULL;
+   ctx_generation++;
+   FLC_UNLOCK();
 }
 
 /*
@@ -200,9 +324,10 @@ void FLC_end()
 
 void FLC_sub_start(char *name)
 {
-   FLC_Ops_Data *newleaf;
    FLC_Ops_Data *temp;
 
+   FLC_thread_context();
+
    temp = search_Ops_list(ops_current->subfirst, name);
 
    if (!temp)
@@ -210,41 +335,15 @@ void FLC_sub_start(char *name)
 
       /* No context of that type in this function found. */
 
-      newleaf = (FLC_Ops_Data *) malloc(sizeof(struct FLC_Ops_Data));
-      memset(newleaf, 0, sizeof(struct FLC_Ops_Data));
-      if (!newleaf)
-         perror("Allocation mem for flc");
-
-      newleaf->next = NULL;
-      newleaf->subfirst = NULL;
-      newleaf->sublast = NULL;
-      newleaf->parent = ops_current;
-
-      if (ops_current->subfirst == NULL)
-      {
-         ops_current->subfirst = newleaf;
-         ops_current->sublast = newleaf;
-      }
-      else
-      {
-         ops_current->sublast->next = newleaf;
-         ops_current->sublast = newleaf;
-      }
-
-      /* now switch contexts to new function */
-      ops_current = newleaf;
-
-      /* set the name pointer */
       if (strlen(name) > FLC_MAXTAGLEN)
       {
          perror("The counter name is too long");
          exit(1);
       }
-      strncpy(ops_current->name, name, FLC_MAXTAGLEN);
-      ops_current->invocations++;
 
-      /* clear some fields */
-      ops_current->fn_max = 0;
+      /* now switch contexts to new function */
+      ops_current = FLC_Ops_new(ops_current, name);
+      ops_current->invocations++;
    }
    else
    {
@@ -263,6 +362,8 @@ void FLC_sub_start(char *name)
 
 void FLC_sub_end()
 {
+   FLC_thread_context();
+
    if (ops_current->parent == NULL)
    {
       fprintf(stderr, "ERROR: fell off stack in FLC_sub_end!\n");
@@ -289,6 +390,10 @@ void FLC_sub_end()
 
 void FLC_frame_update()
 {
+   FLC_Stage_Data *pS;
+
+   FLC_thread_context();
+
    ops_total->invocations++;
 
    if (ops_total->op_cnt > ops_total->fn_max)
@@ -297,26 +402,135 @@ void FLC_frame_update()
    ops_total->fn_total += ops_total->op_cnt;
 
    ops_total->op_cnt = 0;
+
+   /* close the frame of the stages that ran in it */
+   for (pS = stage_top; pS; pS = pS->next)
+   {
+      if (pS->active)
+      {
+         pS->frames++;
+         if (pS->op_cnt > pS->fn_max)
+            pS->fn_max = pS->op_cnt;
+         pS->fn_total += pS->op_cnt;
+         pS->op_cnt = 0;
+         pS->active = (pS == stage_current);
+      }
+   }
+}
+
+/*
+ * Pipeline stage start. The ops counted by this thread are also
+ * added to the stage, until FLC_stage_end() or the next FLC_stage_start().
+ *
+ * Called externally.
+ */
+
+void FLC_stage_start(char *name)
+{
+   FLC_Stage_Data *pS, *temp;
+
+   FLC_thread_context();
+
+   temp = search_Stage_list(stage_top, name);
+
+   if (!temp)
+   {
+      if (strlen(name) > FLC_MAXTAGLEN)
+      {
+         perror("The stage name is too long");
+         exit(1);
+      }
+      temp = (FLC_Stage_Data *) malloc(sizeof(struct FLC_Stage_Data));
+      if (!temp)
+      {
+         perror("Allocation mem for flc");
+         exit(1);
+      }
+      memset(temp, 0, sizeof(struct FLC_Stage_Data));
+      memcpy(temp->name, name, strlen(name) + 1);
+
+      /* keep the stages in order of appearance */
+      if (stage_top == NULL)
+      {
+         stage_top = temp;
+      }
+      else
+      {
+         for (pS = stage_top; pS->next; pS = pS->next);
+         pS->next = temp;
+      }
+   }
+
+   temp->invocations++;
+   temp->active = 1;
+   stage_current = temp;
+}
+
+void FLC_stage_end()
+{
+   FLC_thread_context();
+
+   stage_current = NULL;
 }
 
 /* the ops count routine */
 void FLC_ops(int op, int c)
 {
+   unsigned long cnt;
+
+   FLC_thread_context();
+
    if (op == FLC_FUNC)
    {
       /* the "FUNC" opcode is special in the handling of the argument */
-      ops_current->op_cnt += Ops_Weights[op] + c;
+      cnt = Ops_Weights[op] + c;
       ops_current->optable[op]++;
    }
    else
    {
-      ops_current->op_cnt += Ops_Weights[op] * c;
+      cnt = Ops_Weights[op] * c;
       ops_current->optable[op] += c;
    }
+   ops_current->op_cnt += cnt;
+
+   if (stage_current != NULL)
+      stage_current->op_cnt += cnt;
 }
 
 /* the memory count routine */
 void FLC_mem(int op, int c)
+{
+   FLC_thread_context();
+
+   FLC_LOCK();
+   FLC_mem_add(op, c);
+   FLC_UNLOCK();
+}
+
+/*
+ * Memory count of a _FLC() macro in FLC_THREAD_SAFE builds: *flag
+ * is set under the lock, so that only the first thread counts it.
+ */
+void FLC_mem_once(int *flag, int op, int c)
+{
+   FLC_thread_context();
+
+   FLC_LOCK();
+   if (!*flag)
+   {
+      *flag = 1;
+      FLC_mem_add(op, c);
+   }
+   FLC_UNLOCK();
+}
+
+
+/**************************************************************************
+ * From here, there are only internal (static) functions                  *
+ **************************************************************************/
+
+/* add a memory count, called with the lock held */
+static void FLC_mem_add(int op, int c)
 {
    FLC_Mem_Data *temp;
 
@@ -340,10 +554,213 @@ void FLC_mem(int op, int c)
    return;
 }
 
+/*
+ * Allocate the counters of a thread, with its ROOT and TOTAL nodes
+ */
 
-/**************************************************************************
- * From here, there are only internal (static) functions                  *
- **************************************************************************/
+static FLC_Context *FLC_context_new()
+{
+   FLC_Context *ctx;
+
+   ctx = (FLC_Context *) malloc(sizeof(struct FLC_Context));
+   if (!ctx)
+   {
+      perror("Allocation mem (context) for flc");
+      exit(1);
+   }
+   memset(ctx, 0, sizeof(struct FLC_Context));
+
+   ctx->top = (FLC_Ops_Data *) malloc(sizeof(struct FLC_Ops_Data));
+   if (!ctx->top)
+      perror("Allocation mem (ops_top) for flc");
+   ctx->total = (FLC_Ops_Data *) malloc(sizeof(struct FLC_Ops_Data));
+   if (!ctx->total)
+      perror("Allocation mem (ops_total) for flc");
+
+   ctx->current = ctx->top;
+
+   /* clear the structures */
+   memset(ctx->top, 0, sizeof(struct FLC_Ops_Data));
+   strcpy(ctx->top->name, "ROOT");
+   ctx->top->invocations++;
+   memset(ctx->total, 0, sizeof(struct FLC_Ops_Data));
+   strcpy(ctx->total->name, "TOTAL");
+   ctx->total->invocations = 0;  /* this field is actually the frame count */
+
+   return ctx;
+}
+
+static void FLC_context_free(FLC_Context *ctx)
+{
+   FLC_Stage_Data *pS;
+
+   FLC_free_node(ctx->top);
+   free(ctx->total);
+   free(ctx->top);
+   while (ctx->stages)
+   {
+      pS = ctx->stages;
+      ctx->stages = pS->next;
+      free(pS);
+   }
+   free(ctx);
+}
+
+/*
+ * Make ctx_thread point to the context of the calling thread, creating
+ * it at the first count of the thread after FLC_init().
+ */
+
+static void FLC_thread_context()
+{
+   FLC_Context *pC;
+
+   if (ctx_thread != NULL && ctx_thread_generation == ctx_generation)
+      return;
+
+   ctx_thread = FLC_context_new();
+
+   FLC_LOCK();
+   ctx_thread_generation = ctx_generation;
+   if (ctx_top == NULL)
+   {
+      ctx_top = ctx_thread;
+   }
+   else
+   {
+      for (pC = ctx_top; pC->next; pC = pC->next);
+      pC->next = ctx_thread;
+   }
+   FLC_UNLOCK();
+}
+
+/* add the counts of src to dst, merging the sublists by name */
+static void FLC_Ops_merge(FLC_Ops_Data *dst, FLC_Ops_Data *src)
+{
+   FLC_Ops_Data *pS, *pD;
+   int n;
+
+   dst->invocations += src->invocations;
+   dst->fn_total += src->fn_total;
+   if (src->fn_max > dst->fn_max)
+      dst->fn_max = src->fn_max;
+   dst->op_cnt += src->op_cnt;
+   for (n = 0; n < FLC_OPEND; n++)
+      dst->optable[n] += src->optable[n];
+
+   for (pS = src->subfirst; pS; pS = pS->next)
+   {
+      pD = search_Ops_list(dst->subfirst, pS->name);
+      if (!pD)
+         pD = FLC_Ops_new(dst, pS->name);
+      FLC_Ops_merge(pD, pS);
+   }
+}
+
+/* a context with no function, frame or stage has nothing to merge */
+static int FLC_context_used(FLC_Context *ctx)
+{
+   return ctx->top->subfirst != NULL || ctx->top->op_cnt != 0
+      || ctx->total->invocations != 0 || ctx->stages != NULL;
+}
+
+/*
+ * Merge the contexts of all threads into a new context, called with
+ * the lock held. Functions and stages of the same name are added up,
+ * the max fields keep the largest value of any thread.
+ */
+
+static FLC_Context *FLC_context_merge()
+{
+   FLC_Context *merged, *ctx;
+   FLC_Stage_Data *pS, *pD, *pL;
+
+   merged = FLC_context_new();
+   merged->top->invocations = 0;
+
+   for (ctx = ctx_top; ctx; ctx = ctx->next)
+   {
+      if (!FLC_context_used(ctx))
+         continue;
+
+      FLC_Ops_merge(merged->top, ctx->top);
+      FLC_Ops_merge(merged->total, ctx->total);
+
+      for (pS = ctx->stages; pS; pS = pS->next)
+      {
+         pD = search_Stage_list(merged->stages, pS->name);
+         if (!pD)
+         {
+            pD = (FLC_Stage_Data *) malloc(sizeof(struct FLC_Stage_Data));
+            if (!pD)
+            {
+               perror("Allocation mem for flc");
+               exit(1);
+            }
+            memset(pD, 0, sizeof(struct FLC_Stage_Data));
+            strcpy(pD->name, pS->name);
+            if (merged->stages == NULL)
+            {
+               merged->stages = pD;
+            }
+            else
+            {
+               for (pL = merged->stages; pL->next; pL = pL->next);
+               pL->next = pD;
+            }
+         }
+         pD->invocations += pS->invocations;
+         pD->frames += pS->frames;
+         pD->fn_total += pS->fn_total;
+         if (pS->fn_max > pD->fn_max)
+            pD->fn_max = pS->fn_max;
+      }
+   }
+
+   /* at least the ROOT of one thread */
+   if (merged->top->invocations == 0)
+      merged->top->invocations = 1;
+
+   return merged;
+}
+
+/*
+ * Allocate a function node and append it to the sublist of parent
+ */
+
+static FLC_Ops_Data *FLC_Ops_new(FLC_Ops_Data *parent, char *name)
+{
+   FLC_Ops_Data *newleaf;
+
+   newleaf = (FLC_Ops_Data *) malloc(sizeof(struct FLC_Ops_Data));
+   if (!newleaf)
+   {
+      perror("Allocation mem for flc");
+      exit(1);
+   }
+   memset(newleaf, 0, sizeof(struct FLC_Ops_Data));
+
+   newleaf->next = NULL;
+   newleaf->subfirst = NULL;
+   newleaf->sublast = NULL;
+   newleaf->parent = parent;
+
+   if (parent->subfirst == NULL)
+   {
+      parent->subfirst = newleaf;
+      parent->sublast = newleaf;
+   }
+   else
+   {
+      parent->sublast->next = newleaf;
+      parent->sublast = newleaf;
+   }
+
+   /* callers have checked that name fits in FLC_MAXTAGLEN characters */
+   memcpy(newleaf->name, name, strlen(name) + 1);
+
+   return newleaf;
+}
 
 /*
  * search a FLC_Ops_Data list for an item according to name pointer
@@ -364,6 +781,21 @@ static FLC_Ops_Data *search_Ops_list(FLC_Ops_Data *top, char *name)
    return pL;
 }
 
+/*
+ * search a FLC_Stage_Data list for a stage according to name
+ */
+
+static FLC_Stage_Data *search_Stage_list(FLC_Stage_Data *top, char *name)
+{
+   FLC_Stage_Data *pS;
+
+   for (pS = top; pS; pS = pS->next)
+      if (!strncmp(pS->name, name, FLC_MAXTAGLEN))
+         return pS;
+
+   return pS;
+}
+
 /**************************************************************
  * below this are functions for printing the summaries        *
  **************************************************************/
@@ -546,8 +978,10 @@ static FLC_Mem_Summaries *FLC_Mem_find_function(FLC_Mem_Summaries *top,
 {
    FLC_Mem_Summaries *pL;
 
+   /* names are compared by contents, so that the functions of
+      different threads are merged */
    for (pL = top; pL; pL = pL->next)
-      if (pL->name == name)
+      if (!strcmp(pL->name, name))
          return pL;
 
    return pL;
@@ -599,6 +1033,57 @@ static void FLC_print_frame_sum()
 
 }
 
+static void FLC_print_thread_sum(int n_used)
+{
+   FLC_Context *ctx;
+   int n;
+
+   fprintf(FLC_output, "\n===== Per Thread Summary (%d threads) =====\n\n", n_used);
+   fprintf(FLC_output, "%-8s%10s%17s%17s%17s\n",
+           "Thread", "Frames", "Total Ops", "Ops/frame", "Max Ops/frame");
+   fputs("-----------\n", FLC_output);
+
+   /* the threads that counted something, in order of their first count */
+   n = 0;
+   for (ctx = ctx_top; ctx; ctx = ctx->next)
+   {
+      if (!FLC_context_used(ctx))
+         continue;
+      fprintf(FLC_output, "%-8d%10ld%17lg%17.2f%17ld\n", n++,
+              ctx->total->invocations, ctx->total->fn_total,
+              ctx->total->invocations ?
+              ctx->total->fn_total / (float) ctx->total->invocations : 0.0,
+              ctx->total->fn_max);
+   }
+   fputc('\n', FLC_output);
+}
+
+static void FLC_print_stage_sum()
+{
+   FLC_Stage_Data *pS;
+   char formatstring[10];
+   double avg;
+
+   fprintf(FLC_output, "\n===== Per Stage Summary (Frame length is %4.2f ms) =====\n\n",
+           FLC_FRAMELEN);
+   sprintf(formatstring, "%%-%ds", FLC_MAXTAGLEN);
+   fprintf(FLC_output, formatstring, "Stage");
+   fprintf(FLC_output, "%10s%10s%17s%17s%12s%12s\n",
+           "Calls", "Frames", "Ops/frame", "Max Ops/frame", "Avg WMOPS", "Max WMOPS");
+   fputs("-----------\n", FLC_output);
+
+   for (pS = stage_top; pS; pS = pS->next)
+   {
+      avg = pS->frames ? pS->fn_total / (float) pS->frames : 0.0;
+      fprintf(FLC_output, formatstring, pS->name);
+      fprintf(FLC_output, "%10ld%10ld%17.2f%17ld%12f%12f\n",
+              pS->invocations, pS->frames, avg, pS->fn_max,
+              avg / (1000.0f * (float) FLC_FRAMELEN),
+              pS->fn_max / (1000.0f * (float) FLC_FRAMELEN));
+   }
+   fputc('\n', FLC_output);
+}
+
 #else   /* else of DONT_COUNT */
 
 void FLC_init() {}
@@ -606,5 +1091,7 @@ void FLC_end() {}
 void FLC_sub_start(char *name) {}
 void FLC_sub_end() {}
 void FLC_frame_update() {}
+void FLC_stage_start(char *name) {}
+void FLC_stage_end() {}
 
 #endif   /* end of DONT_COUNT */
@@ -28,6 +28,10 @@
 /* define DONT_COUNT switch only if you want to SUPPRESS the tool in instrumented code */
 /* #define DONT_COUNT */
 
+/* define FLC_THREAD_SAFE to count in several threads at once: every thread
+   then counts into its own context, and FLC_end() merges the contexts */
+/* #define FLC_THREAD_SAFE */
+
 /* Scaling factor to estimate corresponding complexity in fixed point implementation */
 #define FLC_SCALEFAC 1.1F
 
@@ -62,8 +66,16 @@ enum flc_fields
 /* the most important fn */
 void FLC_ops(int op, int count);
 void FLC_mem(int op, int count);
+void FLC_mem_once(int *flag, int op, int count);
 
-#define _FLC(o,c)  {static int f=0; FLC_ops((o),(c)); if (!f) {f=1;FLC_mem((o),(c));}}
+/* program memory is counted once per macro, by the first thread that runs it */
+#ifdef FLC_THREAD_SAFE
+#define _FLC_MEM(o,c)  FLC_mem_once(&f,(o),(c))
+#else
+#define _FLC_MEM(o,c)  {f=1;FLC_mem((o),(c));}
+#endif
+
+#define _FLC(o,c)  {static int f=0; FLC_ops((o),(c)); if (!f) _FLC_MEM((o),(c));}
 #define ADD(c)          _FLC( FLC_ADD,      (c) )
 #define MULT(c)         _FLC( FLC_MULT,     (c) )
 #define MAC(c)          _FLC( FLC_MAC,      (c) )
@@ -85,7 +97,7 @@ void FLC_mem(int op, int count);
 #define TEST(c)         _FLC( FLC_TEST,     (c) )
 
 /* Double Ops count as double the operations but same memory */
-#define _FLCD(o,c)  {static int f=0; FLC_ops((o),2*(c)); if (!f) {f=1;FLC_mem((o),(c));}}
+#define _FLCD(o,c)  {static int f=0; FLC_ops((o),2*(c)); if (!f) _FLC_MEM((o),(c));}
 #define DADD(c)         _FLCD( FLC_ADD,     (c) )
 #define DMULT(c)        _FLCD( FLC_MULT,    (c) )
 #define DMOVE(c)        _FLCD( FLC_MOVE,    (c) )
@@ -127,4 +139,11 @@ void FLC_sub_start(char *name);
 void FLC_sub_end();
 void FLC_frame_update();
 
+/* Pipeline stages: until FLC_stage_end(), or the next FLC_stage_start(),
+   the ops counted by the calling thread are also attributed to the named
+   stage, whatever the call graph. FLC_end() prints the ops per frame of
+   every stage, summed over all threads. Stages do not nest. */
+void FLC_stage_start(char *name);
+void FLC_stage_end();
+
 #endif
@@ -14,6 +14,11 @@
                         TD 11 document and subsequent discussions on the
                         wp3audio@yahoogroups.com email reflector.
    March 06   v2.1      Changed to improve portability.                        
+                        Optional inline basic operators (basop_inline.h) are
+                        selected with BASOP_INLINE for non-WMOPS builds.
+                        Thread-local flags and WMOPS counters with
+                        BASOP_THREAD_SAFE (basop_ctx.h).
+                        Light WMOPS counting with WMOPS_FAST (wmops_fast.h).
 
   ============================================================================
 */
@@ -24,12 +29,26 @@
 
 #include "patch.h"
 #include "typedef.h"
-#include "basop32.h" 
 #include "count.h"
+#if defined(BASOP_INLINE) && !defined(__FXAPI__)
+#include "basop_inline.h"
+#else
+#include "basop32.h" 
+#endif
+#include "basop_ctx.h"
 #include "move.h"
 #include "control.h"
 #include "enh1632.h" 
-//#include "enh40.h"
+#ifdef BASOP_ENH40
+#if defined(BASOP_INLINE) && !defined(__FXAPI__)
+#include "enh40_inline.h"
+#else
+#include "enh40.h"
+#endif
+#endif
+#ifdef WMOPS_FAST
+#include "wmops_fast.h"
+#endif
 
 
 
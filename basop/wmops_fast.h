@@ -0,0 +1,240 @@
+/*
+  ===========================================================================
+   File: WMOPS_FAST.H                                    v.2.3 - 30.Nov.2009
+  ===========================================================================
+
+            ITU-T STL  BASIC OPERATORS
+
+            LIGHT WMOPS COUNTING WITH INLINE OPERATORS
+
+   With WMOPS counting, basop32.c increments one field of the BASIC_OP
+   structure of the current counter group in every operator call. This
+   header is a cheaper backend for the same count.h interface. It is
+   included at the end of stl.h when WMOPS_FAST is defined. It requires
+   BASOP_INLINE and replaces every operator, and the move16()/test()/...
+   and FOR/IF/... macros, by a macro that adds the operator's weight from
+   count.c to one per-thread accumulator and then calls the inline
+   operator. The weights are compile-time constants and the accumulator
+   is a plain variable, so the compiler folds the additions of a basic
+   block into one. The code under test runs at close to native speed.
+
+   Only calls made by the code under test are counted. Calls between
+   operators inside basop_inline.h, enh1632.c, etc. are not, which is
+   what the compensating decrements of basop32.c achieve. The totals per
+   counter group, the worst case and worst worst case are the same as
+   with WMOPS. The count per basic operator is not available, so
+   generic_WMOPS_output() does not write CODE_PROFILE_FILENAME.
+
+   After this header WMOPS is defined, so the "#ifdef WMOPS" code of the
+   application (extra move16() for arrays, counter groups, output) is
+   compiled as in a WMOPS build. The files that implement the operators
+   define WMOPS_FAST_NO_WRAP before including stl.h, to compile them
+   without the wrappers and without counting.
+
+   History:
+   first version, light WMOPS counting (WMOPS_FAST)
+  ============================================================================
+*/
+
+
+#ifndef _WMOPS_FAST_H
+#define _WMOPS_FAST_H
+
+
+#if (WMOPS)
+#error "WMOPS_FAST replaces the WMOPS counting of basop32.c, do not enable both"
+#endif
+#ifndef _BASOP_INLINE_H
+#error "WMOPS_FAST needs the inline operators, compile with -DBASOP_INLINE"
+#endif
+
+
+/*****************************************************************************
+ *
+ *  Constants and Globals
+ *
+ *****************************************************************************/
+
+/* weighted operations of the current counter group not yet added to it */
+extern BASOP_TLS UWord32 wmops_fast_count;
+
+/* state of the last ELSE, so that ELSE IF is counted once, as in control.h */
+extern BASOP_TLS UWord32 wmops_fast_else_count;
+extern BASOP_TLS Flag    wmops_fast_else_pending;
+
+#define WMOPS_FAST_ADD( w) (wmops_fast_count += (w))
+
+
+/*****************************************************************************
+ *
+ *  Control operators (control.h)
+ *
+ *****************************************************************************/
+static __inline void wmops_fast_if( void) {
+   if( !wmops_fast_else_pending
+    || (wmops_fast_count != wmops_fast_else_count))
+      WMOPS_FAST_ADD( 4);
+   wmops_fast_else_pending = 0;
+}
+
+static __inline void wmops_fast_else( void) {
+   WMOPS_FAST_ADD( 4);
+   wmops_fast_else_count = wmops_fast_count;
+   wmops_fast_else_pending = 1;
+}
+
+
+#ifndef WMOPS_FAST_NO_WRAP
+#undef FOR
+#undef WHILE
+#undef IF
+#undef ELSE
+#undef SWITCH
+#undef CONTINUE
+#undef BREAK
+#undef GOTO
+
+#define FOR( a)      if( WMOPS_FAST_ADD( 3), 0); else for( a)
+#define WHILE( a)    while( WMOPS_FAST_ADD( 4), a)
+#define IF( a)       if( wmops_fast_if(), a)
+#define ELSE         else if( wmops_fast_else(), 0) ; else
+#define SWITCH( a)   switch( WMOPS_FAST_ADD( 8), a)
+#define CONTINUE     if( WMOPS_FAST_ADD( 4), 0); else continue
+#define BREAK        if( WMOPS_FAST_ADD( 4), 0); else break
+#define GOTO         if( WMOPS_FAST_ADD( 4), 0); else goto
+
+
+/*****************************************************************************
+ *
+ *  Move and miscellaneous operators (move.h)
+ *
+ *****************************************************************************/
+#define move16()     ((void) WMOPS_FAST_ADD( 1))
+#define move32()     ((void) WMOPS_FAST_ADD( 2))
+#define test()       ((void) WMOPS_FAST_ADD( 2))
+#define logic16()    ((void) WMOPS_FAST_ADD( 1))
+#define logic32()    ((void) WMOPS_FAST_ADD( 2))
+
+
+/*****************************************************************************
+ *
+ *  16/32 bit operators (basop_inline.h), same weights as op_weight in count.c
+ *
+ *****************************************************************************/
+#define add( a, b)            (WMOPS_FAST_ADD(  1), add( a, b))
+#define sub( a, b)            (WMOPS_FAST_ADD(  1), sub( a, b))
+#define abs_s( a)             (WMOPS_FAST_ADD(  1), abs_s( a))
+#define shl( a, b)            (WMOPS_FAST_ADD(  1), shl( a, b))
+#define shr( a, b)            (WMOPS_FAST_ADD(  1), shr( a, b))
+#define extract_h( a)         (WMOPS_FAST_ADD(  1), extract_h( a))
+#define extract_l( a)         (WMOPS_FAST_ADD(  1), extract_l( a))
+#define mult( a, b)           (WMOPS_FAST_ADD(  1), mult( a, b))
+#define L_mult( a, b)         (WMOPS_FAST_ADD(  1), L_mult( a, b))
+#define negate( a)            (WMOPS_FAST_ADD(  1), negate( a))
+#define round_fx( a)          (WMOPS_FAST_ADD(  1), round_fx( a))
+#define L_mac( a, b, c)       (WMOPS_FAST_ADD(  1), L_mac( a, b, c))
+#define L_msu( a, b, c)       (WMOPS_FAST_ADD(  1), L_msu( a, b, c))
+#define L_macNs( a, b, c)     (WMOPS_FAST_ADD(  1), L_macNs( a, b, c))
+#define L_msuNs( a, b, c)     (WMOPS_FAST_ADD(  1), L_msuNs( a, b, c))
+#define L_add( a, b)          (WMOPS_FAST_ADD(  1), L_add( a, b))
+#define L_sub( a, b)          (WMOPS_FAST_ADD(  1), L_sub( a, b))
+#define L_add_c( a, b)        (WMOPS_FAST_ADD(  2), L_add_c( a, b))
+#define L_sub_c( a, b)        (WMOPS_FAST_ADD(  2), L_sub_c( a, b))
+#define L_negate( a)          (WMOPS_FAST_ADD(  1), L_negate( a))
+#define L_shl( a, b)          (WMOPS_FAST_ADD(  1), L_shl( a, b))
+#define L_shr( a, b)          (WMOPS_FAST_ADD(  1), L_shr( a, b))
+#define mult_r( a, b)         (WMOPS_FAST_ADD(  1), mult_r( a, b))
+#define shr_r( a, b)          (WMOPS_FAST_ADD(  3), shr_r( a, b))
+#define mac_r( a, b, c)       (WMOPS_FAST_ADD(  1), mac_r( a, b, c))
+#define msu_r( a, b, c)       (WMOPS_FAST_ADD(  1), msu_r( a, b, c))
+#define L_deposit_h( a)       (WMOPS_FAST_ADD(  1), L_deposit_h( a))
+#define L_deposit_l( a)       (WMOPS_FAST_ADD(  1), L_deposit_l( a))
+#define L_shr_r( a, b)        (WMOPS_FAST_ADD(  3), L_shr_r( a, b))
+#define L_abs( a)             (WMOPS_FAST_ADD(  1), L_abs( a))
+#define L_sat( a)             (WMOPS_FAST_ADD(  4), L_sat( a))
+#define norm_s( a)            (WMOPS_FAST_ADD(  1), norm_s( a))
+#define div_s( a, b)          (WMOPS_FAST_ADD( 18), div_s( a, b))
+#define norm_l( a)            (WMOPS_FAST_ADD(  1), norm_l( a))
+#define L_mult0( a, b)        (WMOPS_FAST_ADD(  1), L_mult0( a, b))
+#define L_mac0( a, b, c)      (WMOPS_FAST_ADD(  1), L_mac0( a, b, c))
+#define L_msu0( a, b, c)      (WMOPS_FAST_ADD(  1), L_msu0( a, b, c))
+#define L_mls( a, b)          (WMOPS_FAST_ADD(  5), L_mls( a, b))
+#define div_l( a, b)          (WMOPS_FAST_ADD( 32), div_l( a, b))
+#define i_mult( a, b)         (WMOPS_FAST_ADD(  3), i_mult( a, b))
+
+
+/*****************************************************************************
+ *
+ *  Enhanced 16/32 bit operators (enh1632.h)
+ *
+ *****************************************************************************/
+#define s_max( a, b)          (WMOPS_FAST_ADD(  1), s_max( a, b))
+#define s_min( a, b)          (WMOPS_FAST_ADD(  1), s_min( a, b))
+#define L_max( a, b)          (WMOPS_FAST_ADD(  1), L_max( a, b))
+#define L_min( a, b)          (WMOPS_FAST_ADD(  1), L_min( a, b))
+#define shl_r( a, b)          (WMOPS_FAST_ADD(  3), shl_r( a, b))
+#define L_shl_r( a, b)        (WMOPS_FAST_ADD(  3), L_shl_r( a, b))
+#define lshl( a, b)           (WMOPS_FAST_ADD(  1), lshl( a, b))
+#define lshr( a, b)           (WMOPS_FAST_ADD(  1), lshr( a, b))
+#define L_lshl( a, b)         (WMOPS_FAST_ADD(  1), L_lshl( a, b))
+#define L_lshr( a, b)         (WMOPS_FAST_ADD(  1), L_lshr( a, b))
+#define s_and( a, b)          (WMOPS_FAST_ADD(  1), s_and( a, b))
+#define s_or( a, b)           (WMOPS_FAST_ADD(  1), s_or( a, b))
+#define s_xor( a, b)          (WMOPS_FAST_ADD(  1), s_xor( a, b))
+#define L_and( a, b)          (WMOPS_FAST_ADD(  1), L_and( a, b))
+#define L_or( a, b)           (WMOPS_FAST_ADD(  1), L_or( a, b))
+#define L_xor( a, b)          (WMOPS_FAST_ADD(  1), L_xor( a, b))
+#define rotl( a, b, c)        (WMOPS_FAST_ADD(  3), rotl( a, b, c))
+#define rotr( a, b, c)        (WMOPS_FAST_ADD(  3), rotr( a, b, c))
+#define L_rotl( a, b, c)      (WMOPS_FAST_ADD(  3), L_rotl( a, b, c))
+#define L_rotr( a, b, c)      (WMOPS_FAST_ADD(  3), L_rotr( a, b, c))
+
+
+#ifdef _ENH40_INLINE_H
+/*****************************************************************************
+ *
+ *  40 bit operators (enh40_inline.h)
+ *
+ *****************************************************************************/
+#define L40_max( a, b)        (WMOPS_FAST_ADD(  1), L40_max( a, b))
+#define L40_min( a, b)        (WMOPS_FAST_ADD(  1), L40_min( a, b))
+#define L40_shr_r( a, b)      (WMOPS_FAST_ADD(  3), L40_shr_r( a, b))
+#define L40_shl_r( a, b)      (WMOPS_FAST_ADD(  3), L40_shl_r( a, b))
+#define norm_L40( a)          (WMOPS_FAST_ADD(  1), norm_L40( a))
+#define L40_shl( a, b)        (WMOPS_FAST_ADD(  1), L40_shl( a, b))
+#define L40_shr( a, b)        (WMOPS_FAST_ADD(  1), L40_shr( a, b))
+#define L40_negate( a)        (WMOPS_FAST_ADD(  1), L40_negate( a))
+#define L40_add( a, b)        (WMOPS_FAST_ADD(  1), L40_add( a, b))
+#define L40_sub( a, b)        (WMOPS_FAST_ADD(  1), L40_sub( a, b))
+#define L40_abs( a)           (WMOPS_FAST_ADD(  1), L40_abs( a))
+#define L40_mult( a, b)       (WMOPS_FAST_ADD(  1), L40_mult( a, b))
+#define L40_mac( a, b, c)     (WMOPS_FAST_ADD(  1), L40_mac( a, b, c))
+#define mac_r40( a, b, c)     (WMOPS_FAST_ADD(  2), mac_r40( a, b, c))
+#define L40_msu( a, b, c)     (WMOPS_FAST_ADD(  1), L40_msu( a, b, c))
+#define msu_r40( a, b, c)     (WMOPS_FAST_ADD(  2), msu_r40( a, b, c))
+#define Mpy_32_16_ss( a, b, c, d) (WMOPS_FAST_ADD( 2), Mpy_32_16_ss( a, b, c, d))
+#define Mpy_32_32_ss( a, b, c, d) (WMOPS_FAST_ADD( 4), Mpy_32_32_ss( a, b, c, d))
+#define L40_lshl( a, b)       (WMOPS_FAST_ADD(  1), L40_lshl( a, b))
+#define L40_lshr( a, b)       (WMOPS_FAST_ADD(  1), L40_lshr( a, b))
+#define L40_set( a)           (WMOPS_FAST_ADD(  3), L40_set( a))
+#define L40_deposit_h( a)     (WMOPS_FAST_ADD(  1), L40_deposit_h( a))
+#define L40_deposit_l( a)     (WMOPS_FAST_ADD(  1), L40_deposit_l( a))
+#define L40_deposit32( a)     (WMOPS_FAST_ADD(  1), L40_deposit32( a))
+#define Extract40_H( a)       (WMOPS_FAST_ADD(  1), Extract40_H( a))
+#define Extract40_L( a)       (WMOPS_FAST_ADD(  1), Extract40_L( a))
+#define L_Extract40( a)       (WMOPS_FAST_ADD(  1), L_Extract40( a))
+#define L40_round( a)         (WMOPS_FAST_ADD(  1), L40_round( a))
+#define L_saturate40( a)      (WMOPS_FAST_ADD(  1), L_saturate40( a))
+#define round40( a)           (WMOPS_FAST_ADD(  1), round40( a))
+#endif /* ifdef _ENH40_INLINE_H */
+
+
+/* the application is compiled as in a WMOPS build */
+#define WMOPS 1
+#endif /* ifndef WMOPS_FAST_NO_WRAP */
+
+
+#endif /* ifndef _WMOPS_FAST_H */
+
+
+/* end of file */
@@ -1,4 +1,4 @@
-/*                                                           02.Feb.2010 v3.5
+/*                                                           17.Oct.2026 v3.8
   ===========================================================================
 
   FILTER.C
@@ -10,10 +10,11 @@
   Test program to process a given fil by one of the possible filter
   characteristic available in the STL. Multiple filterings (as
   available in firdemo.c and pcmdemo.c) can be obtained by piping
-  (cascading) several runs of this program. Asynchronous tandeming
-  simulation is available for some types of filter; delay of the input
-  file or skipping samples from the input file is also available with
-  the async operation.
+  (cascading) several runs of this program, or in a single run by
+  giving a chain of filter types separated by commas (see below).
+  Asynchronous tandeming simulation is available for some types of
+  filter; delay of the input file or skipping samples from the input
+  file is also available with the async operation.
 
   Usage:
   ~~~~~~
@@ -77,6 +78,19 @@
    LP20		low-pass filter with cut-off frequency 20kHz for fs=48kHz, 1:1
    RXIRS8   Receive-side Modified IRS weighting with factor 1:1 at 8kHz
    RXIRS16  Receive-side Modified IRS weighting with factor 1:1 at 16kHz
+   RSl:m    Rational resampler, up-sampling by l then down-sampling by m
+            (e.g. RS160:441 from 44.1 kHz to 16 kHz)
+
+  Filter chains:
+  Flt_type may be a list of up to 16 filter types separated by
+  commas, e.g. LP7,HQ3,mod:IRS16, which are applied in this order. Each
+  block of BlockSize input samples goes through all the filters before
+  the next one is read, in float, with a single conversion from and to
+  short; the small block buffers stay in the cache. Between stages the
+  samples are limited to the 16-bit range, as in separate runs. A filter type can
+  be preceded by "up:", "down:" or "mod:" to set the -up, -down or -mod
+  options for that filter only. The async operation is not available
+  for chains.
 
 
   Testing:
@@ -152,6 +166,13 @@
 
    02.Feb.2010 v3.5 - Modified maximum string length for filenames to avoid
                       buffer overruns (y.hiwasaki)
+   17.Oct.2026 v3.6 - Added rational resampler RSl:m
+   17.Oct.2026 v3.7 - Added filter chains, applied in a single pass. The
+                      filter initialization, kernel call and release
+                      are now done by stage (init_stage(), alloc_stage(),
+                      filter_stage() and free_stage())
+   17.Oct.2026 v3.8 - Intermediate stages of a chain limited to the 16-bit
+                      range (clip_stage()); empty chain elements rejected
   ===========================================================================
 */
 
@@ -217,6 +238,7 @@ int             valid_filter(F_type, modified_IRS)
 // FILTER_12k48k_HW
 	  || strncmp(F_type, "LP14", 4) == 0 || strncmp(F_type, "lp14",4) == 0
 	  || strncmp(F_type, "LP20", 4) == 0 || strncmp(F_type, "lp20",4) == 0
+	  || strncmp(F_type, "RS", 2) == 0   || strncmp(F_type, "rs",2) == 0
 	  )
     valid = 1;
   
@@ -232,26 +254,26 @@ int             valid_filter(F_type, modified_IRS)
 /*
  * Function to display usage
  * By: Simao in 1.May.1994
- * Last update: 15.May.2007 <>
+ * Last update: 17.Oct.2026
  */
 #define P(x) printf x
 void display_usage()
 {
-  P(("FILTER.C - Version 3.5 of 02.Feb.2010 \n\n"));
+  P(("FILTER.C - Version 3.8 of 17.Oct.2026 \n\n"));
  
   P((" Test program to process a given file by one of the possible filter\n"));
   P((" characteristics of the STL. Multiple filterings (as available\n"));
   P((" in firdemo.c and pcmdemo.c) can be obtained by piping (cascading) \n"));
-  P((" several runs of this program. Asynchronous tandeming simulation \n"));
-  P((" is available for some types of filter; delay of the input file \n"));
-  P((" or skipping samples from the input file is also available with \n"));
-  P((" the async operation.\n"));
+  P((" several runs of this program, or by a chain of filters in a single\n"));
+  P((" run. Asynchronous tandeming simulation is available for some types\n"));
+  P((" of filter; delay of the input file or skipping samples from the \n"));
+  P((" input file is also available with the async operation.\n"));
   P(("\n"));
   P((" Usage:\n"));
   P((" $ filter   [-options] Flt_type InpFile OutFile \n"));
   P(("            [BlockSize [1stBlock [NoOfBlocks]]]\n"));
   P((" where:\n"));
-  P(("  Flt_type:    is the filter type (see list below)\n"));
+  P(("  Flt_type:    is the filter type, or chain of types (see below)\n"));
   P(("  InpFile      is the name of the file to be processed;\n"));
   P(("  OutFile      is the name with the processed data;\n"));
   P(("  BlockSize    is the block size, in number of samples\n"));
@@ -305,6 +327,14 @@ void display_usage()
   P(("   LP12    12kHz low-pass filter for fs=48kHz, w/ factor 1:1\n"));
   P(("   LP14    14kHz low-pass filter for fs=48kHz, w/ factor 1:1\n"));
   P(("   LP20    20kHz low-pass filter for fs=48kHz, w/ factor 1:1\n"));
+  P(("   RSl:m   Rational resampler, factor l:m (e.g. RS160:441 from 44.1kHz\n"));
+  P(("           to 16kHz)\n"));
+  P(("\n"));
+  P((" Filter chains:\n"));
+  P(("  Flt_type can be a comma-separated list of filter types, applied in\n"));
+  P(("  this order in a single pass (e.g. LP7,HQ3,mod:IRS16). Each type can\n"));
+  P(("  be preceded by up:, down: or mod: to set -up, -down or -mod for\n"));
+  P(("  that filter only. Not available with -async.\n"));
 
   P(("\n"));
 
@@ -319,199 +349,49 @@ enum filter_kernel_type {FIR,IIR_PARALLEL, IIR_CASCADE, IIR_DIRECT};
 char *filter_type_str[] = {"FIR", "Parallel-form IIR",
 			   "Cascade-form IIR", "Direct-form IIR"};
 
-/*============================== */
-int main(argc, argv)
-  int             argc;
-  char           *argv[];
-/*============================== */
-{
-  /* DECLARATIONS */
 
-  /* Algorithm variables */
+/* Maximum number of filters in a chain */
+#define MAX_STAGES 16
+
+/* State of one filter of the chain */
+typedef struct
+{
+  char            kernel_type;	/* FIR, IIR_PARALLEL, IIR_CASCADE, ... */
   SCD_FIR        *fir_state;
   SCD_IIR        *parallel_iir_state;
   CASCADE_IIR    *cascade_iir_state;
   DIRECT_IIR     *direct_iir_state;
-
-  float          *InpBuff, *OutBuff;
-  short			 *TmpBuff;
-  char            F_type[MAX_STRLEN], async = 0, upsample = 0;
-  long            cur_blk, satur = 0, total = 0, k, N, N1, N2;
-  char            modified_IRS = 0, quiet = 0;
-  long            inp_size, out_size, factor, smpno;
-  double          fs=8000;
-  char            kernel_type = 0;
-  static char     funny[9] = "|/-\\|/-\\";
-
-  /* For asynchronous tandem simulation */
-  long            delay=0, skip=0;
-  short          *zero;
-
-  /* File variables */
-  char            FileIn[MAX_STRLEN], FileOut[MAX_STRLEN];
-  FILE           *Fi, *Fo;
-  long            start_byte;
-#ifdef VMS
-  char            mrs[15];
-#endif
-
-
-  /* ......... GET PARAMETERS ......... */
-
-  /* Check options */
-  if (argc < 2)
-    display_usage();
-  else
-  {
-    while (argc > 1 && argv[1][0] == '-')
-      if (strcmp(argv[1],"-mod")==0)
-      {
-	/* Set modified IRS flag */
-	modified_IRS = 1;
-
-	/* Move arg{c,v} over the option to the next argument */
-	argc--;
-	argv++;
-      }
-      else if (strcmp(argv[1], "-fs") == 0)
-      {
-	/* Change sampling frequency */
-	fs = atof(argv[2]);
-
-	/* Move arg{c,v} over the option to the next argument */
-	argc -= 2;
-	argv += 2;
-      }
-      else if (strcmp(argv[1], "-q") == 0)
-      {
-	/* Change sampling frequency */
-	quiet = 1;
-
-	/* Move arg{c,v} over the option to the next argument */
-	argc --;
-	argv ++;
-      }
-      else if (strcmp(argv[1], "-down") == 0)
-      {
-	/* Filtering is for downsampling */
-	upsample = async = 0;
-
-	/* Move arg{c,v} over the option to the next argument */
-	argc --;
-	argv ++;
-      }
-      else if (strcmp(argv[1], "-up") == 0)
-      {
-	/* Filtering is for upsampling */
-	upsample = 1;
-
-	/* Move arg{c,v} over the option to the next argument */
-	argc--;
-	argv++;
-      }
-      else if (strcmp(argv[1], "-async") == 0)
-      {
-	/* Filtering is an asyncronization process */
-	async = upsample = 1;
-
-	/* Move arg{c,v} over the option to the next argument */
-	argc --;
-	argv ++;
-      }
-      else if (strcmp(argv[1], "-delay") == 0)
-      {
-	/* Filtering is an asyncronization process */
-	delay = atoi(argv[2]);
-	if (delay<0)
-	  skip = -delay;
-
-	/* Move arg{c,v} over the option to the next argument */
-	argc -= 2;
-	argv += 2;
-      }
-      else if (strcmp(argv[1], "-h") == 0 || strcmp(argv[1], "-?") == 0)
-      {
-	/* Display help message */
-	display_usage();
-      }
-      else
-      {
-	fprintf(stderr, "ERROR! Invalid option \"%s\" in command line\n\n",
-		argv[1]);
-	display_usage();
-      }
-  }
-
-  /* Read parameters for processing */
-  GET_PAR_S(1, "_Filter type: ................. ", F_type);
-  GET_PAR_S(2, "_Input File: .................. ", FileIn);
-  GET_PAR_S(3, "_Output File: ................. ", FileOut);
-  FIND_PAR_L(4, "_Block Size: .................. ", N, 256);
-  FIND_PAR_L(5, "_Starting Block: .............. ", N1, 1);
-  FIND_PAR_L(6, "_No. of Blocks: ............... ", N2, 0);
+  char            upsample;	/* 1: upsampling filter */
+  char            modified_IRS;	/* 1: modified IRS characteristic */
+  long            factor;	/* rate change factor */
+  long            out_size;	/* size of the output buffer, in samples */
+  float          *out;		/* output buffer */
+} FILTER_STAGE;
 
 
-  /* ......... CHECK CONSISTENCY ......... */
-
-  /* Verify that a valid filter was selected */
-  if (!valid_filter(F_type, modified_IRS))
-  {
-    if (modified_IRS &&
-	(strcmp(F_type, "irs8")==0 || strcmp(F_type, "IRS8")==0))
-      fprintf(stderr, "\nModified IRS is NOT available at 8 kHz! Aborted.\n");
-    else
-      fprintf(stderr, "\nInvalid filter chosen! Aborted.\n");
-    exit(2);
-  }
-
-  /* The delay option is only available with asynchronous filtering */
-  if (delay!=0 && !async)
-    HARAKIRI("\nDelay option only available for ASYNC filtering! Aborted.\n",5);
-
-
-  /* ......... STARTING ......... */
-
-  /* Find starting byte in file */
-  start_byte = sizeof(short) * (long) (--N1) * (long) N;
-
-#ifdef SKIP_APPROACH_1
-  /* If samples are to be skipped in output file, does it here */
-  if (skip)
-    start_byte += skip * sizeof(short);
-#endif
-
-  /* Check if is to process the whole file */
-  if (N2 == 0)
-  {
-    struct stat     st;
-
-    /* ... find the input file size ... */
-    stat(FileIn, &st);
-    N2 = ceil((st.st_size - start_byte) / (double)(N * sizeof(short)));
-  }
-  inp_size = N; /* samples */
+/*
+ * Initialize the filter F_type as stage st of the chain. The upsampling
+ * and modified IRS flags are taken from st. Aborts for unimplemented
+ * filters.
+ * Last update: 17.Oct.2026
+ */
+void            init_stage(F_type, st)
+  char           *F_type;
+  FILTER_STAGE   *st;
+{
+  long            k, factor;
 
 
-  /* Allocate memory for delay buffer & initialize it */
-  if (delay>0)
-  {
-    if ((zero=(short *)calloc(delay, sizeof(short)))==NULL)
-    {
-      HARAKIRI("Error allocating memory for delay buffer\n", 5);
-    }    
-    else
-      memset(zero, 0, delay * sizeof(short));
-  }
-
   /* Set flag to filter type: IIR or FIR; default is FIR */
   if (strncmp(F_type, "dc", 2) == 0 || strncmp(F_type, "DC",2) == 0)
-    kernel_type = IIR_DIRECT;
+    st->kernel_type = IIR_DIRECT;
   else if (strncmp(F_type, "iflat", 5) == 0||strncmp(F_type, "IFLAT", 5) == 0)
-    kernel_type = IIR_CASCADE;
+    st->kernel_type = IIR_CASCADE;
   else if (strncmp(F_type, "pcm", 3) == 0 || strncmp(F_type, "PCM", 3) == 0)
-    kernel_type = IIR_PARALLEL;
+    st->kernel_type = IIR_PARALLEL;
   else
-    kernel_type = FIR;
+    st->kernel_type = FIR;
+
 
 
   /* ... CHOOSE CORRECT FILTER INITIALIZATION ... */
@@ -533,15 +413,15 @@ int main(argc, argv)
     switch(k)
     {
     case 8:
-      fir_state = irs_8khz_init();
+      st->fir_state = irs_8khz_init();
       break;
     case 16:
-      fir_state = modified_IRS
+      st->fir_state = st->modified_IRS
                    ? mod_irs_16khz_init()
       		   : irs_16khz_init() ;
       break;
     case 48:
-      fir_state = mod_irs_48khz_init();
+      st->fir_state = mod_irs_48khz_init();
       break;
     default:
       HARAKIRI("Unimplemented: IRS rate not 8, 16 or 48 kHz\n", 15);
@@ -553,12 +433,12 @@ int main(argc, argv)
     switch(k)
     {
     case 8:
-      modified_IRS = 1; /* Only modified IRS rcx filter available */
-      fir_state = rx_mod_irs_8khz_init();
+      st->modified_IRS = 1; /* Only modified IRS rcx filter available */
+      st->fir_state = rx_mod_irs_8khz_init();
       break;
     case 16:
-      modified_IRS = 1; /* Only modified IRS rcx filter available */
-      fir_state = rx_mod_irs_16khz_init();
+      st->modified_IRS = 1; /* Only modified IRS rcx filter available */
+      st->fir_state = rx_mod_irs_16khz_init();
       break;
     default:
       HARAKIRI("Unimplemented: Receive Mod-IRS rate not 8 or 16 kHz\n", 15);
@@ -566,12 +446,12 @@ int main(argc, argv)
   }
   else if (strncmp(F_type, "hirs16", 6) == 0 || strncmp(F_type, "HIRS16", 6) == 0)
   {
-      fir_state = ht_irs_16khz_init();
+      st->fir_state = ht_irs_16khz_init();
   }
 
   else if (strncmp(F_type, "tirs", 4) == 0 || strncmp(F_type, "TIRS", 4) == 0)
   {
-      fir_state = tia_irs_8khz_init();
+      st->fir_state = tia_irs_8khz_init();
   }
 
 /*
@@ -579,7 +459,7 @@ int main(argc, argv)
   */
   else if (strncmp(F_type, "dsm", 3) == 0 || strncmp(F_type, "DSM", 3) == 0)
   {
-      fir_state = delta_sm_16khz_init();
+      st->fir_state = delta_sm_16khz_init();
   }
 
 /*
@@ -587,7 +467,7 @@ int main(argc, argv)
   */
   else if (strncmp(F_type, "pso", 3) == 0 || strncmp(F_type, "PSO", 3) == 0)
   {
-      fir_state = psophometric_8khz_init();
+      st->fir_state = psophometric_8khz_init();
   }
 
 /*
@@ -599,7 +479,7 @@ int main(argc, argv)
 	     strncmp(F_type, "msin", 4) == 0 || 
 	     strncmp(F_type, "MSIN", 4) == 0)
     {
-      fir_state = msin_16khz_init();
+      st->fir_state = msin_16khz_init();
     }    
 
 /*
@@ -610,9 +490,9 @@ int main(argc, argv)
   */
   else if (strncmp(F_type, "flat", 4) == 0 || strncmp(F_type, "FLAT", 4) == 0)
   {
-      fir_state = F_type[4] == '1'
+      st->fir_state = F_type[4] == '1'
 	          ? linear_phase_pb_1_to_1_init()
-	          : (upsample
+	          : (st->upsample
                      ? linear_phase_pb_1_to_2_init()
                      : linear_phase_pb_2_to_1_init());
   }
@@ -627,12 +507,12 @@ int main(argc, argv)
   */
   else if (strncmp(F_type, "hq", 2) == 0 || strncmp(F_type, "HQ", 2) == 0)
   {
-    if (upsample)		/* It is up-sampling! */
-      fir_state = F_type[2] == '2'
+    if (st->upsample)		/* It is up-sampling! */
+      st->fir_state = F_type[2] == '2'
 	? hq_up_1_to_2_init()
 	: hq_up_1_to_3_init();
     else			/* It is down-sampling! */
-      fir_state = F_type[2] == '2'
+      st->fir_state = F_type[2] == '2'
 	? hq_down_2_to_1_init()
 	: hq_down_3_to_1_init();
   }
@@ -642,7 +522,7 @@ int main(argc, argv)
   */
   else if (strncmp(F_type, "p341", 4) == 0 || strncmp(F_type, "P341", 4) == 0)
   {
-      fir_state = p341_16khz_init();
+      st->fir_state = p341_16khz_init();
   }
 
 /*
@@ -650,7 +530,7 @@ int main(argc, argv)
   */
   else if (strncmp(F_type, "5kbp", 4) == 0 || strncmp(F_type, "5KBP", 4) == 0 || strncmp(F_type, "5Kbp", 4) == 0 || strncmp(F_type, "5kBP", 4) == 0)
   {
-      fir_state = bp5k_16khz_init();
+      st->fir_state = bp5k_16khz_init();
   }
 
 /*
@@ -658,7 +538,7 @@ int main(argc, argv)
   */
   else if (strncmp(F_type, "100_5kbp", 8) == 0 || strncmp(F_type, "100_5KBP", 8) == 0)
   {
-      fir_state = bp100_5k_16khz_init();
+      st->fir_state = bp100_5k_16khz_init();
   }
 
 /*
@@ -666,7 +546,7 @@ int main(argc, argv)
   */
   else if (strncmp(F_type, "14kbp", 5) == 0 || strncmp(F_type, "14KBP", 5) == 0 || strncmp(F_type, "14Kbp", 5) == 0 || strncmp(F_type, "14kBP", 5) == 0)
   {
-      fir_state = bp14k_32khz_init();
+      st->fir_state = bp14k_32khz_init();
   }
 
   /*
@@ -674,7 +554,7 @@ int main(argc, argv)
   */
   else if (strncmp(F_type, "20kbp", 5) == 0 || strncmp(F_type, "20KBP", 5) == 0 || strncmp(F_type, "20Kbp", 5) == 0 || strncmp(F_type, "20kBP", 5) == 0)
   {
-      fir_state = bp20k_48khz_init();
+      st->fir_state = bp20k_48khz_init();
   }
 
 /*
@@ -682,7 +562,7 @@ int main(argc, argv)
   */
   else if (strncmp(F_type, "LP1p5", 5) == 0 || strncmp(F_type, "lp1p5", 5) == 0 || strncmp(F_type, "LP1p5", 5) == 0)
   {
-      fir_state = LP1p5_48kHz_init();
+      st->fir_state = LP1p5_48kHz_init();
   }
 
 /*
@@ -690,21 +570,21 @@ int main(argc, argv)
   */
   else if (strncmp(F_type, "LP35", 4) == 0 || strncmp(F_type, "lp35", 4) == 0)
   {
-      fir_state = LP35_48kHz_init();
+      st->fir_state = LP35_48kHz_init();
   }
 /*
   * Filter type: 7kHz lowpass filter (fs=48kHz): factor 1:1
   */
   else if (strncmp(F_type, "LP7", 3) == 0 || strncmp(F_type, "lp7", 3) == 0)
   {
-      fir_state = LP7_48kHz_init();
+      st->fir_state = LP7_48kHz_init();
   }
 /*
   * Filter type: 10kHz lowpass filter (fs=48kHz): factor 1:1
   */
   else if (strncmp(F_type, "LP10", 5) == 0 || strncmp(F_type, "lp10", 5) == 0)
   {
-      fir_state = LP10_48kHz_init();
+      st->fir_state = LP10_48kHz_init();
   }
 // FILTER_12k48k_HW
   /*
@@ -712,7 +592,7 @@ int main(argc, argv)
   */
   else if (strncmp(F_type, "LP12", 4) == 0 || strncmp(F_type, "lp12", 4) == 0)
   {
-      fir_state = LP12_48kHz_init();
+      st->fir_state = LP12_48kHz_init();
   }
 // FILTER_12k48k_HW
 /*
@@ -720,7 +600,7 @@ int main(argc, argv)
   */
   else if (strncmp(F_type, "LP14", 4) == 0 || strncmp(F_type, "lp14", 4) == 0)
   {
-      fir_state = LP14_48kHz_init();
+      st->fir_state = LP14_48kHz_init();
   }
 
 /*
@@ -728,7 +608,18 @@ int main(argc, argv)
   */
   else if (strncmp(F_type, "LP20", 4) == 0 || strncmp(F_type, "lp20", 4) == 0)
   {
-      fir_state = LP20_48kHz_init();
+      st->fir_state = LP20_48kHz_init();
+  }
+
+/*
+  * Filter type: RSl:m - rational resampler, up-sampling by l and
+  *                      down-sampling by m
+  */
+  else if (strncmp(F_type, "RS", 2) == 0 || strncmp(F_type, "rs", 2) == 0)
+  {
+      if (sscanf(&F_type[2], "%ld:%ld", &k, &factor) != 2 ||
+          (st->fir_state = hq_resample_init(k, factor)) == NULL)
+	HARAKIRI("Invalid resampling factors, use RSl:m with l,m>0\n", 15);
   }
 
 /*
@@ -743,10 +634,10 @@ int main(argc, argv)
   {
     if (strncmp(F_type, "pcm1", 4) == 0 || strncmp(F_type, "PCM1", 4) == 0)
     {
-	parallel_iir_state = stdpcm_16khz_init();
+	st->parallel_iir_state = stdpcm_16khz_init();
     }
     else
-      parallel_iir_state = upsample
+      st->parallel_iir_state = st->upsample
 	? stdpcm_1_to_2_init()	/* It is up-sampling! */
 	: stdpcm_2_to_1_init();	/* It is down-sampling! */
   }
@@ -759,7 +650,7 @@ int main(argc, argv)
   else if (strncmp(F_type, "iflat", 5) == 0 || 
 	   strncmp(F_type, "IFLAT", 5) == 0)
   {
-      cascade_iir_state = upsample
+      st->cascade_iir_state = st->upsample
 	? iir_casc_lp_1_to_3_init()  	/* It is up-sampling! */
 	: iir_casc_lp_3_to_1_init();	/* It is down-sampling! */
   }
@@ -770,42 +661,388 @@ int main(argc, argv)
   else if (strncmp(F_type, "dc", 2) == 0 || 
 	   strncmp(F_type, "DC", 2) == 0)
   {
-      direct_iir_state = iir_dir_dc_removal_init();
+      st->direct_iir_state = iir_dir_dc_removal_init();
   }
+}
+
 
+/*
+ * Find the rate change factor of stage st and the size of its output
+ * buffer for blocks of inp_size samples, and allocate this buffer.
+ * Return: the size of the output buffer
+ * Last update: 17.Oct.2026
+ */
+long            alloc_stage(st, inp_size)
+  FILTER_STAGE   *st;
+  long            inp_size;
+{
+  switch (st->kernel_type)
+  {
+  case FIR:
+    st->factor = st->fir_state->dwn_up;
+    if (st->fir_state->hswitch=='R')
+      st->out_size = ceil(inp_size * st->factor / (double)st->fir_state->dwn);
+    else
+      st->out_size = (st->fir_state->hswitch=='U')
+	             ? inp_size * st->factor
+	             : ceil(inp_size / (double)st->factor); 
+    break;
+  case IIR_PARALLEL:
+    st->factor = st->parallel_iir_state->idown;
+    st->out_size = (st->parallel_iir_state->hswitch=='U')
+	           ? inp_size * st->factor
+	           : ceil(inp_size / (double)st->factor); 
+    break;
+  case IIR_CASCADE:
+    st->factor = st->cascade_iir_state->idown;
+    st->out_size = (st->cascade_iir_state->hswitch=='U')
+	           ? inp_size * st->factor
+	           : ceil(inp_size / (double)st->factor); 
+    break;
+  case IIR_DIRECT:
+    st->factor = st->direct_iir_state->idown;
+    st->out_size = (st->direct_iir_state->hswitch=='U')
+	           ? inp_size * st->factor
+	           : ceil(inp_size / (double)st->factor);
+  }
 
+  /* Allocate memory for float output buffer */
+  if ((st->out = (float *) calloc(st->out_size, sizeof(float))) == NULL)
+    HARAKIRI("Can't allocate memory for output data buffer\n", 10);
 
-  /* MEMORY ALLOCATION */
+  return(st->out_size);
+}
+
+
+/*
+ * Filter the smpno samples of inp by stage st, into st->out.
+ * Return: the number of output samples
+ * Last update: 17.Oct.2026
+ */
+long            filter_stage(st, smpno, inp)
+  FILTER_STAGE   *st;
+  long            smpno;
+  float          *inp;
+{
+  /* Reset output buffer */
+  memset(st->out, '\0', st->out_size*sizeof(float));
+
+  /* Call the filtering routine */
+  switch (st->kernel_type)
+  {
+  case FIR:
+    smpno = hq_kernel(smpno, inp, st->fir_state, st->out);
+    break;
+  case IIR_PARALLEL:
+    smpno = stdpcm_kernel(smpno, inp, st->parallel_iir_state, st->out);
+    break;
+  case IIR_CASCADE:
+    smpno = cascade_iir_kernel(smpno, inp, st->cascade_iir_state, st->out);
+    break;
+  case IIR_DIRECT:
+    smpno = direct_iir_kernel(smpno, inp, st->direct_iir_state, st->out);
+    break;
+  }
+
+  return(smpno);
+}
+
+
+/*
+ * Limit the smpno samples of x, the output of an intermediate stage, to
+ * the range of 16-bit samples, as fl2sh_16bit() does between separate
+ * runs.
+ * Return: the number of limited samples
+ * Last update: 17.Oct.2026
+ */
+long            clip_stage(smpno, x)
+  long            smpno;
+  float          *x;
+{
+  long            k, count = 0;
+
+  for (k = 0; k < smpno; k++)
+    if (x[k] > 32767.0 / 32768.0)
+    {
+      x[k] = (float) (32767.0 / 32768.0);
+      count++;
+    }
+    else if (x[k] < -1.0)
+    {
+      x[k] = -1.0;
+      count++;
+    }
 
-  /* Calculate Output buffer size and rate change factor */
-  switch (kernel_type)
+  return(count);
+}
+
+
+/*
+ * Release the filter structure and output buffer of stage st
+ * Last update: 17.Oct.2026
+ */
+void            free_stage(st)
+  FILTER_STAGE   *st;
+{
+  free(st->out);
+
+  switch (st->kernel_type)
   {
   case FIR:
-    factor = fir_state->dwn_up;
-    out_size = (fir_state->hswitch=='U')
-	       ? inp_size * factor
-	       : ceil(inp_size / (double)factor); 
+    hq_free(st->fir_state);
     break;
   case IIR_PARALLEL:
-    factor = parallel_iir_state->idown;
-    out_size = (parallel_iir_state->hswitch=='U')
-	       ? inp_size * factor
-	       : ceil(inp_size / (double)factor); 
+    stdpcm_free(st->parallel_iir_state);
     break;
   case IIR_CASCADE:
-    factor = cascade_iir_state->idown;
-    out_size = (cascade_iir_state->hswitch=='U')
-	       ? inp_size * factor
-	       : ceil(inp_size / (double)factor); 
+    cascade_iir_free(st->cascade_iir_state);
     break;
   case IIR_DIRECT:
-    factor = direct_iir_state->idown;
-    out_size = (direct_iir_state->hswitch=='U')
-	       ? inp_size * factor
-	       : ceil(inp_size / (double)factor);
+    direct_iir_free(st->direct_iir_state);
+    break;
+  }
+}
+
+
+/*============================== */
+int main(argc, argv)
+  int             argc;
+  char           *argv[];
+/*============================== */
+{
+  /* DECLARATIONS */
+
+  /* Algorithm variables */
+  FILTER_STAGE    stage[MAX_STAGES];
+  char           *stage_type[MAX_STAGES], *p;
+  long            nstages, i;
+
+  float          *InpBuff, *OutBuff;
+  short			 *TmpBuff;
+  char            F_type[MAX_STRLEN], async = 0, upsample = 0;
+  long            cur_blk, satur = 0, total = 0, N, N1, N2;
+  char            modified_IRS = 0, quiet = 0;
+  long            inp_size, out_size, factor, smpno;
+  double          fs=8000;
+  static char     funny[9] = "|/-\\|/-\\";
+
+  /* For asynchronous tandem simulation */
+  long            delay=0, skip=0;
+  short          *zero;
+
+  /* File variables */
+  char            FileIn[MAX_STRLEN], FileOut[MAX_STRLEN];
+  FILE           *Fi, *Fo;
+  long            start_byte;
+#ifdef VMS
+  char            mrs[15];
+#endif
+
+
+  /* ......... GET PARAMETERS ......... */
+
+  /* Check options */
+  if (argc < 2)
+    display_usage();
+  else
+  {
+    while (argc > 1 && argv[1][0] == '-')
+      if (strcmp(argv[1],"-mod")==0)
+      {
+	/* Set modified IRS flag */
+	modified_IRS = 1;
+
+	/* Move arg{c,v} over the option to the next argument */
+	argc--;
+	argv++;
+      }
+      else if (strcmp(argv[1], "-fs") == 0)
+      {
+	/* Change sampling frequency */
+	fs = atof(argv[2]);
+
+	/* Move arg{c,v} over the option to the next argument */
+	argc -= 2;
+	argv += 2;
+      }
+      else if (strcmp(argv[1], "-q") == 0)
+      {
+	/* Change sampling frequency */
+	quiet = 1;
+
+	/* Move arg{c,v} over the option to the next argument */
+	argc --;
+	argv ++;
+      }
+      else if (strcmp(argv[1], "-down") == 0)
+      {
+	/* Filtering is for downsampling */
+	upsample = async = 0;
+
+	/* Move arg{c,v} over the option to the next argument */
+	argc --;
+	argv ++;
+      }
+      else if (strcmp(argv[1], "-up") == 0)
+      {
+	/* Filtering is for upsampling */
+	upsample = 1;
+
+	/* Move arg{c,v} over the option to the next argument */
+	argc--;
+	argv++;
+      }
+      else if (strcmp(argv[1], "-async") == 0)
+      {
+	/* Filtering is an asyncronization process */
+	async = upsample = 1;
+
+	/* Move arg{c,v} over the option to the next argument */
+	argc --;
+	argv ++;
+      }
+      else if (strcmp(argv[1], "-delay") == 0)
+      {
+	/* Filtering is an asyncronization process */
+	delay = atoi(argv[2]);
+	if (delay<0)
+	  skip = -delay;
+
+	/* Move arg{c,v} over the option to the next argument */
+	argc -= 2;
+	argv += 2;
+      }
+      else if (strcmp(argv[1], "-h") == 0 || strcmp(argv[1], "-?") == 0)
+      {
+	/* Display help message */
+	display_usage();
+      }
+      else
+      {
+	fprintf(stderr, "ERROR! Invalid option \"%s\" in command line\n\n",
+		argv[1]);
+	display_usage();
+      }
   }
 
+  /* Read parameters for processing */
+  GET_PAR_S(1, "_Filter type: ................. ", F_type);
+  GET_PAR_S(2, "_Input File: .................. ", FileIn);
+  GET_PAR_S(3, "_Output File: ................. ", FileOut);
+  FIND_PAR_L(4, "_Block Size: .................. ", N, 256);
+  FIND_PAR_L(5, "_Starting Block: .............. ", N1, 1);
+  FIND_PAR_L(6, "_No. of Blocks: ............... ", N2, 0);
+
+
+  /* ......... CHECK CONSISTENCY ......... */
+
+  /* Split the filter chain in its stages, with their own options;
+   * strtok() would skip empty elements */
+  if (F_type[0] == ',' || strstr(F_type, ",,") != NULL
+      || (F_type[0] != '\0' && F_type[strlen(F_type) - 1] == ','))
+    HARAKIRI("\nEmpty filter in the chain! Aborted.\n", 2);
+  for (nstages = 0, p = strtok(F_type, ","); p != NULL; p = strtok(NULL, ","))
+  {
+    if (nstages == MAX_STAGES)
+      HARAKIRI("\nToo many filters in the chain! Aborted.\n", 2);
+
+    memset(&stage[nstages], 0, sizeof(FILTER_STAGE));
+    stage[nstages].upsample = upsample;
+    stage[nstages].modified_IRS = modified_IRS;
+    while (1)
+      if (strncmp(p, "up:", 3) == 0)
+      {
+	stage[nstages].upsample = 1;
+	p += 3;
+      }
+      else if (strncmp(p, "down:", 5) == 0)
+      {
+	stage[nstages].upsample = 0;
+	p += 5;
+      }
+      else if (strncmp(p, "mod:", 4) == 0)
+      {
+	stage[nstages].modified_IRS = 1;
+	p += 4;
+      }
+      else
+	break;
+
+    /* Verify that a valid filter was selected */
+    if (!valid_filter(p, stage[nstages].modified_IRS))
+    {
+      if (stage[nstages].modified_IRS &&
+	  (strcmp(p, "irs8")==0 || strcmp(p, "IRS8")==0))
+	fprintf(stderr, "\nModified IRS is NOT available at 8 kHz! Aborted.\n");
+      else
+	fprintf(stderr, "\nInvalid filter chosen! Aborted.\n");
+      exit(2);
+    }
+    stage_type[nstages++] = p;
+  }
+  if (nstages == 0)
+    HARAKIRI("\nInvalid filter chosen! Aborted.\n", 2);
+
+  /* The async operation is only available for a single filter */
+  if (async && nstages > 1)
+    HARAKIRI("\nAsync operation not available for filter chains! Aborted.\n",5);
+
+  /* The delay option is only available with asynchronous filtering */
+  if (delay!=0 && !async)
+    HARAKIRI("\nDelay option only available for ASYNC filtering! Aborted.\n",5);
+
+
+  /* ......... STARTING ......... */
+
+  /* Find starting byte in file */
+  start_byte = sizeof(short) * (long) (--N1) * (long) N;
+
+#ifdef SKIP_APPROACH_1
+  /* If samples are to be skipped in output file, does it here */
+  if (skip)
+    start_byte += skip * sizeof(short);
+#endif
+
+  /* Check if is to process the whole file */
+  if (N2 == 0)
+  {
+    struct stat     st;
+
+    /* ... find the input file size ... */
+    stat(FileIn, &st);
+    N2 = ceil((st.st_size - start_byte) / (double)(N * sizeof(short)));
+  }
+  inp_size = N; /* samples */
+
+
+  /* Allocate memory for delay buffer & initialize it */
+  if (delay>0)
+  {
+    if ((zero=(short *)calloc(delay, sizeof(short)))==NULL)
+    {
+      HARAKIRI("Error allocating memory for delay buffer\n", 5);
+    }    
+    else
+      memset(zero, 0, delay * sizeof(short));
+  }
+
+  /* Initialize the filters, in the order of the chain */
+  for (i = 0; i < nstages; i++)
+    init_stage(stage_type[i], &stage[i]);
+
+
+  /* MEMORY ALLOCATION */
+
+  /* Calculate output buffer size and rate change factor of each stage;
+   * the output of a stage is the input of the next one, so that each
+   * block goes through the whole chain while in the cache */
+  for (out_size = inp_size, i = 0; i < nstages; i++)
+    out_size = alloc_stage(&stage[i], out_size);
+  factor = stage[0].factor;
+
   /* Check consistency once more */
+  if (async && stage[0].kernel_type==FIR && stage[0].fir_state->hswitch=='R')
+    HARAKIRI("INCONSISTENCY: async operation not available for resampling; aborting\n",10);
   if (async && factor==1)
     HARAKIRI("INCONSISTENCY: async operation requires non-unity upsampling factor; aborting\n",10);
 
@@ -813,10 +1050,6 @@ int main(argc, argv)
   if ((InpBuff = (float *) calloc(inp_size, sizeof(float))) == NULL)
     HARAKIRI("Can't allocate memory for input data buffer\n", 10);
 
-  /* Allocate memory for float output buffer */
-  if ((OutBuff = (float *) calloc(out_size, sizeof(float))) == NULL)
-    HARAKIRI("Can't allocate memory for output data buffer\n", 10);
-
   /* Allocate memory for short input/output buffer */
   if ((TmpBuff = (short *) calloc(max(inp_size, out_size), 
                                   sizeof(short))) == NULL)
@@ -826,23 +1059,50 @@ int main(argc, argv)
 /*
  * ......... PRINT INFO .......... 
  */
-  if (factor==1)
-    fprintf(stderr, "No-rate change operation\n");
-  else
+  if (nstages > 1)
   {
-    fprintf(stderr, "%s operation, ", async? "Asynchronization" : 
-	    (upsample? "Upsampling" : "Downsampling"));
-    fprintf(stderr, "factor %ld\n", async? 1l : factor);
+    fprintf(stderr, "Filter chain of %ld stages\n", nstages);
+    for (i = 0; i < nstages; i++)
+    {
+      fprintf(stderr, " %ld: %s, ", i + 1, stage_type[i]);
+      if (stage[i].kernel_type==FIR && stage[i].fir_state->hswitch=='R')
+	fprintf(stderr, "resampling factor %ld:%ld",
+		stage[i].fir_state->dwn_up, stage[i].fir_state->dwn);
+      else if (stage[i].factor==1)
+	fprintf(stderr, "no-rate change");
+      else
+	fprintf(stderr, "%s factor %ld",
+		stage[i].upsample? "upsampling" : "downsampling",
+		stage[i].factor);
+      fprintf(stderr, "%s, %s\n",
+	      stage[i].modified_IRS? ", modified IRS" : "",
+	      filter_type_str[(int)stage[i].kernel_type]);
+    }
   }
-  if (modified_IRS)
-    fprintf(stderr, "Using modified IRS\n");
+  else
+  {
+    if (stage[0].kernel_type==FIR && stage[0].fir_state->hswitch=='R')
+      fprintf(stderr, "Resampling operation, factor %ld:%ld\n",
+	      stage[0].fir_state->dwn_up, stage[0].fir_state->dwn);
+    else if (factor==1)
+      fprintf(stderr, "No-rate change operation\n");
+    else
+    {
+      fprintf(stderr, "%s operation, ", async? "Asynchronization" : 
+	      (stage[0].upsample? "Upsampling" : "Downsampling"));
+      fprintf(stderr, "factor %ld\n", async? 1l : factor);
+    }
+    if (stage[0].modified_IRS)
+      fprintf(stderr, "Using modified IRS\n");
 
-  if (delay>0)
-    fprintf(stderr, "Delaying output file by %ld samples\n", delay);
-  else if (skip)
-    fprintf(stderr, "Skipping %ld samples in output file\n", skip);
+    if (delay>0)
+      fprintf(stderr, "Delaying output file by %ld samples\n", delay);
+    else if (skip)
+      fprintf(stderr, "Skipping %ld samples in output file\n", skip);
 
-  fprintf(stderr, "Filter structure: %s\n", filter_type_str[(int)kernel_type]);
+    fprintf(stderr, "Filter structure: %s\n",
+	    filter_type_str[(int)stage[0].kernel_type]);
+  }
 
 
 /*
@@ -881,9 +1141,6 @@ int main(argc, argv)
     if (!quiet)
       fprintf(stderr, "%c\r", funny[cur_blk%8]);
 
-    /* Reset output buffer */
-    memset(OutBuff, '\0', out_size*sizeof(float));
-
     /* Read a block of samples */
     if ((smpno = fread(TmpBuff, sizeof(short), N, Fi)) == 0)
       KILL(FileIn, 5);
@@ -891,21 +1148,14 @@ int main(argc, argv)
     /* ... and convert short to float, normalizing */
     sh2fl_16bit(smpno, TmpBuff, InpBuff, 1);
 
-    /* Call the filtering routine */
-    switch (kernel_type)
+    /* Call the filtering routines; the output of each stage, limited
+     * to the 16-bit range, is the input of the next */
+    for (OutBuff = InpBuff, i = 0; i < nstages; i++)
     {
-    case FIR:
-      smpno = hq_kernel(smpno, InpBuff, fir_state, OutBuff);
-      break;
-    case IIR_PARALLEL:
-      smpno = stdpcm_kernel(smpno, InpBuff, parallel_iir_state, OutBuff);
-      break;
-    case IIR_CASCADE:
-      smpno = cascade_iir_kernel(smpno, InpBuff, cascade_iir_state, OutBuff);
-      break;
-    case IIR_DIRECT:
-      smpno = direct_iir_kernel(smpno, InpBuff, direct_iir_state, OutBuff);
-      break;
+      if (i > 0)
+	satur += clip_stage(smpno, OutBuff);
+      smpno = filter_stage(&stage[i], smpno, OutBuff);
+      OutBuff = stage[i].out;
     }
 
     /* Decimates to implement asynchronization process */
@@ -956,25 +1206,11 @@ int main(argc, argv)
 
   /* Release some memory */
   free(TmpBuff);
-  free(OutBuff);
   free(InpBuff);
 
   /* Release filter structrues */
-  switch (kernel_type)
-  {
-  case FIR:
-    hq_free(fir_state);
-    break;
-  case IIR_PARALLEL:
-    stdpcm_free(parallel_iir_state);
-    break;
-  case IIR_CASCADE:
-    cascade_iir_free(cascade_iir_state);
-    break;
-  case IIR_DIRECT:
-    direct_iir_free(direct_iir_state);
-    break;
-  }
+  for (i = 0; i < nstages; i++)
+    free_stage(&stage[i]);
 
   /* Release memory for delay buffer */
   if (delay>0)
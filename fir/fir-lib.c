@@ -1,4 +1,4 @@
-/*                                                          v2.3 - 03/Dec/2004
+/*                                                         v2.10 - 17/Oct/2026
   =============================================================================
 
                           U    U   GGG    SSSS  TTTTT
@@ -53,8 +53,31 @@ FUNCTIONS:
          = fir_initialization(...) : common initialization function for
                                    all filter types;
   Local (should be used only here -- prototypes only in this file)
+         = fir_coef_get(...)     : shared tables of a set of coefficients,
+                                   from the registry or built;
+         = fir_coef_build(...)   : build the tables of a set of
+                                   coefficients;
+         = fir_coef_free(...)    : deallocate a set of shared tables;
+         = fir_polyphase_tables(...) : tables of the non-zero coefficients
+                                   of each polyphase branch;
+         = fir_dot4(...)         : four dot-products with the same branch;
+         = fir_polyphase_block(...) : output samples of all branches for
+                                   a range of input samples;
+         = fir_block_sse2(...), fir_block_avx2(...) : same as
+                                   fir_polyphase_block() for consecutive
+                                   input samples, with SSE2/AVX2;
+         = fir_fft_tables(...)   : shared tables of the FFT convolution
+                                   of long filters;
+         = fir_fft_init(...)     : set up the FFT convolution state;
+         = fir_fft_reset(...)    : clear the FFT convolution state;
+         = fir_cfft(...), fir_rfft(...), fir_irfft(...) : complex FFT,
+                                   real FFT and inverse real FFT;
+         = fir_fft_frame(...)    : FFT convolution of one input frame;
+         = fir_fft_kernel(...)   : kernel function for long 1:1 filters;
          = fir_upsampling_kernel(...) : kernel function for all FIR
                                    up-sampling procedures;
+         = fir_resampling_kernel(...) : kernel function for the rational
+                                   resamplers;
          = fir_downsampling_kernel(...) : kernel function for all FIR
                                    down-sampling procedures;
 
@@ -71,6 +94,33 @@ HISTORY:
 				   OpenVMS/AXP <simao@ctd.comsat.com>
     03.Dec.04 v2.3 Added correction in fir_downsampling_kernel() for sample-based 
 				   operation.	<Cyril Guillaume & Stephane Ragot - stephane.ragot@francetelecom.com>
+    17.Oct.26 v2.4 Polyphase kernels: the up- and down-sampling kernels only
+                   evaluate the non-zero coefficients of each polyphase
+                   branch, from tables built by fir_initialization(), and
+                   compute four output samples at a time. The results are
+                   unchanged.
+    17.Oct.26 v2.5 SSE2/AVX2 kernels for consecutive input samples (1:1
+                   filters and up-sampling), AVX2 selected at run time.
+                   The results are unchanged.
+    17.Oct.26 v2.6 FFT convolution of long 1:1 filters: the first
+                   coefficients are applied in direct form, the others by
+                   uniformly partitioned overlap-save. No delay is added
+                   and any segment length can be used. The results match
+                   the direct form within float rounding.
+    17.Oct.26 v2.7 Kernel for rational (up/down) resamplers, hswitch 'R'.
+    17.Oct.26 v2.8 Registry of shared coefficient tables: the
+                   coefficients, polyphase tables and FFT partitions are
+                   built once for each set of coefficients and shared
+                   (read-only) by all the filters using it. A filter only
+                   allocates its delay line and FFT convolution state.
+    17.Oct.26 v2.9 The registry is locked (mutex), so that filters can be
+                   created and released by several threads. A set of
+                   tables is deallocated with its last filter;
+                   hq_free_tables() removed.
+    17.Oct.26 v2.10 The FFT convolution is only compiled with FIR_FFT,
+                    with one threshold (FIR_FFT_MIN_TAPS) for all the
+                    kernels. The default direct form is bit-exact with
+                    the previous versions, whatever the kernel.
 
   =============================================================================
 */
@@ -81,9 +131,110 @@ HISTORY:
  */
 #include <stdio.h>
 #include <stdlib.h>		/* General utility definitions */
+#include <math.h>		/* cos(), sin(), atan() */
 
 #include "firflt.h"		/* Global definitions for FIR-FIR filter */
 
+/* SIMD kernels on x86-64, where the scalar code also uses SSE arithmetic;
+ * define FIR_NO_SIMD to compile the portable C code only. The AVX2
+ * kernel is compiled in any case and used if the CPU supports it. */
+#if !defined(FIR_NO_SIMD) && (defined(__x86_64__) || defined(_M_X64))
+#include <emmintrin.h>
+#define FIR_SIMD_SSE2
+#if defined(__GNUC__) || defined(_MSC_VER)
+#include <immintrin.h>
+#define FIR_SIMD_AVX2
+#if defined(__GNUC__)
+#define FIR_AVX2_TARGET __attribute__((target("avx2")))
+#else
+#include <intrin.h>
+#define FIR_AVX2_TARGET
+#endif
+#endif
+#endif
+
+/* With FIR_FFT defined, 1:1 filters with at least this number of
+ * coefficients use the FFT convolution, whatever the direct-form kernel.
+ * By default all filters use the direct form. */
+#ifndef FIR_FFT_MIN_TAPS
+#define FIR_FFT_MIN_TAPS 640
+#endif
+
+/* Lock of the registry of shared tables, taken by the initialization
+ * functions and hq_free(); define FIR_NO_LOCK on systems without
+ * threads */
+#if defined(FIR_NO_LOCK)
+#define FIR_LOCK()
+#define FIR_UNLOCK()
+#elif defined(_WIN32)
+#include <windows.h>
+static SRWLOCK  fir_lock = SRWLOCK_INIT;
+#define FIR_LOCK()    AcquireSRWLockExclusive(&fir_lock)
+#define FIR_UNLOCK()  ReleaseSRWLockExclusive(&fir_lock)
+#else
+#include <pthread.h>
+static pthread_mutex_t fir_lock = PTHREAD_MUTEX_INITIALIZER;
+#define FIR_LOCK()    pthread_mutex_lock(&fir_lock)
+#define FIR_UNLOCK()  pthread_mutex_unlock(&fir_lock)
+#endif
+
+
+/*
+ * ......... Local type definitions .........
+ */
+
+/* State of the FFT convolution: the coefficients h0[P..lenh0-1] are
+ * split into K partitions of P coefficients, and the input into frames
+ * of P samples. The spectra of the last K frames (each FFT taken over
+ * the frame and the one before it) are kept in X[], as a circular
+ * buffer whose newest entry is slot fdl. */
+struct fir_fft
+{
+  long            P;		/* partition length, FFT size 2*P */
+  long            K;		/* number of partitions */
+  long            nhead;	/* non-zero coefficients among h0[0..P-1] */
+  long            pos;		/* index of the next input sample in the
+				 * current frame */
+  long            fdl;		/* slot of the newest spectrum in X[] */
+  long           *rev;		/* bit-reversal permutation of P entries */
+  double         *wr, *wi;	/* cos(pi*k/P) and sin(pi*k/P), k < P */
+  double         *H;		/* spectra of the partitions, scaled by
+				 * 1/(2*P), K slots of 2*P+2 values */
+				/* (rev, wr, wi and H are shared) */
+  double         *X;		/* spectra of the last K input frames */
+  double         *Y;		/* output spectrum, 2*P+2 values */
+  double         *xin;		/* last two input frames, 2*P samples */
+  double         *tail;		/* contribution of the partitions to the
+				 * outputs of the current frame */
+};
+
+/* Read-only tables of a filter: the coefficients, their polyphase
+ * tables and the FFT partitions. They are built once for each set of
+ * coefficients and shared by all the filters that use it; a filter only
+ * allocates its delay line and FFT convolution state. The sets built
+ * form a list, the registry, and a set is deallocated when its last
+ * filter is released. */
+struct fir_coef
+{
+  long            lenh0;	/* number of FIR coefficients */
+  long            dwn_up;	/* down/up-sampling factor */
+  int             hswitch;	/* kernel, see fir_initialization() */
+  float          *h0;		/* FIR coefficients, times the gain */
+  long           *nph;		/* polyphase tables, see */
+  long           *oph;		/* fir_polyphase_tables() */
+  long           *kph;
+  float          *hph;
+  long            P;		/* FFT partition length */
+  long            K;		/* number of partitions, 0 for the direct
+				 * form */
+  long            nhead;	/* non-zero coefficients among h0[0..P-1] */
+  long           *rev;		/* bit-reversal permutation of P entries */
+  double         *wr;		/* cos(pi*k/P), then sin(pi*k/P), k < P,
+				 * then the spectra of the partitions */
+  long            nref;		/* number of filters using the tables */
+  struct fir_coef *next;	/* next set of the registry */
+};
+
 
 /*
  * ......... Local function prototypes .........
@@ -93,12 +244,57 @@ HISTORY:
 SCD_FIR *fir_initialization ARGS((long lenh0, float h0[], double gain, 
                                                  long idwnup, int hswitch));
 
+static struct fir_coef *fir_coef_get ARGS((long lenh0, float h0[],
+                      double gain, long idwnup, int hswitch));
+static struct fir_coef *fir_coef_build ARGS((long lenh0, float h0[],
+                      double gain, long idwnup, int hswitch));
+static void     fir_coef_free ARGS((struct fir_coef *coef));
+static int      fir_polyphase_tables ARGS((struct fir_coef *coef));
+static void     fir_dot4 ARGS((float *x_ptr, long xstep, long ntaps,
+                      long *kph_ptr, float *hph_ptr, float *y_ptr,
+                      long ystep));
+static long     fir_polyphase_block ARGS((float *x_ptr, long kfirst,
+                      long klast, long xstep, long nbranch, long *nph_ptr,
+                      long *kph_ptr, float *hph_ptr, float *y_ptr));
+#ifdef FIR_SIMD_SSE2
+static long     fir_block_sse2 ARGS((float *x_ptr, long kfirst, long klast,
+                      long nbranch, long *nph_ptr, long *kph_ptr,
+                      float *hph_ptr, float *y_ptr));
+#endif
+#ifdef FIR_SIMD_AVX2
+static int      fir_cpu_avx2 ARGS((void));
+static long     fir_block_avx2 ARGS((float *x_ptr, long kfirst, long klast,
+                      long nbranch, long *nph_ptr, long *kph_ptr,
+                      float *hph_ptr, float *y_ptr));
+
+static int      fir_avx2 = -1;	/* AVX2 kernel usable, -1 if unknown */
+#endif
+#ifdef FIR_FFT
+static int      fir_fft_tables ARGS((struct fir_coef *coef));
+static int      fir_fft_init ARGS((SCD_FIR *fir_ptr));
+#endif
+static void     fir_fft_reset ARGS((struct fir_fft *fft));
+static void     fir_cfft ARGS((double *a, long n, long *rev, double *wr,
+                      double *wi, double isign));
+static void     fir_rfft ARGS((double *a, struct fir_fft *fft));
+static void     fir_irfft ARGS((double *a, struct fir_fft *fft));
+static void     fir_fft_frame ARGS((struct fir_fft *fft));
+static long     fir_fft_kernel ARGS((long lenx, float *x_ptr, float *y_ptr,
+                      SCD_FIR *fir_ptr));
 static long     fir_upsampling_kernel ARGS((long lenx, float *x_ptr, 
-                      float *y_ptr, long lenh0, float *h0_ptr, float *T_ptr, 
-                      long iupfac));
+                      float *y_ptr, long lenh0, long *nph_ptr, long *kph_ptr,
+                      float *hph_ptr, float *T_ptr, long iupfac));
 static long     fir_downsampling_kernel ARGS((long lenx, float *x_ptr, 
-                      float *y_ptr, long lenh0, float *h0_ptr, float *T_ptr, 
-                      long downfac, long *k0_ptr));
+                      float *y_ptr, long lenh0, long *nph_ptr, long *kph_ptr,
+                      float *hph_ptr, float *T_ptr, long downfac,
+                      long *k0_ptr));
+static long     fir_resampling_kernel ARGS((long lenx, float *x_ptr,
+                      float *y_ptr, long lenh0, long *nph_ptr, long *oph_ptr,
+                      long *kph_ptr, float *hph_ptr, float *T_ptr,
+                      long iupfac, long idwnfac, long *k0_ptr));
+
+static struct fir_coef *fir_registry = NULL;	/* shared tables, see
+						 * FIR_LOCK() */
 
 
 /*
@@ -145,6 +341,8 @@ static long     fir_downsampling_kernel ARGS((long lenx, float *x_ptr,
         History:
         ~~~~~~~~
         28.Feb.92 v1.0 Release of 1st version <hf@pkinbg.uucp>
+        17.Oct.26 v1.1 FFT convolution of long filters.
+        17.Oct.26 v1.2 Rational resamplers.
 
  ============================================================================
 */
@@ -155,7 +353,30 @@ long            hq_kernel(lseg, x_ptr, fir_ptr, y_ptr)
   float          *y_ptr;
 {
 
-  if (fir_ptr->hswitch == 'U')	/* call up-sampling procedure */
+  if (fir_ptr->fft != NULL)	/* call FFT convolution */
+    return fir_fft_kernel(lseg, x_ptr, y_ptr, fir_ptr);
+  else if (fir_ptr->hswitch == 'R')	/* call resampling procedure */
+    return
+      fir_resampling_kernel(	/* returns number of output samples */
+			    lseg,	/* In   : length of input signal */
+			    x_ptr,	/* In   : array with input samples */
+			    y_ptr,	/* Out  : array with output samples */
+			    fir_ptr->lenh0,	/* In   : number of
+						 * FIR-coefficients */
+			    fir_ptr->nph,	/* In   : no. of taps per
+						 * branch */
+			    fir_ptr->oph,	/* In   : first tap of each
+						 * branch */
+			    fir_ptr->kph,	/* In   : delays of the taps */
+			    fir_ptr->hph,	/* In   : non-zero
+						 * FIR-coefficients */
+			    fir_ptr->T,	/* InOut: state variables */
+			    fir_ptr->dwn_up,	/* In   : upsampling factor */
+			    fir_ptr->dwn,	/* In   : downsampling factor */
+			    &(fir_ptr->k0)	/* InOut: position of the next
+						 * output sample */
+      );
+  else if (fir_ptr->hswitch == 'U')	/* call up-sampling procedure */
     return
       fir_upsampling_kernel(	/* returns number of output samples */
 			    lseg,	/* In   : length of input signal */
@@ -163,7 +384,10 @@ long            hq_kernel(lseg, x_ptr, fir_ptr, y_ptr)
 			    y_ptr,	/* Out  : array with output samples */
 			    fir_ptr->lenh0,	/* In   : number of
 						 * FIR-coefficients */
-			    fir_ptr->h0,	/* In   : array with
+			    fir_ptr->nph,	/* In   : no. of taps per
+						 * branch */
+			    fir_ptr->kph,	/* In   : delays of the taps */
+			    fir_ptr->hph,	/* In   : non-zero
 						 * FIR-coefficients */
 			    fir_ptr->T,	/* InOut: state variables */
 			    fir_ptr->dwn_up	/* In   : upsampling factor */
@@ -176,7 +400,9 @@ long            hq_kernel(lseg, x_ptr, fir_ptr, y_ptr)
 			      y_ptr,	/* Out  : array with output samples */
 			      fir_ptr->lenh0,	/* In   : number of
 						 * FIR-coefficients */
-			      fir_ptr->h0,	/* In   : array with
+			      fir_ptr->nph,	/* In   : no. of taps */
+			      fir_ptr->kph,	/* In   : delays of the taps */
+			      fir_ptr->hph,	/* In   : non-zero
 						 * FIR-coefficients */
 			      fir_ptr->T,	/* InOut: state variables */
 			      fir_ptr->dwn_up,	/* In   : downsampling factor */
@@ -215,15 +441,43 @@ long            hq_kernel(lseg, x_ptr, fir_ptr, y_ptr)
         History:
         ~~~~~~~~
         28.Feb.92 v1.0 Release of 1st version <hf@pkinbg.uucp>
+        17.Oct.26 v1.1 Free the polyphase tables.
+        17.Oct.26 v1.2 Free the FFT convolution state.
+        17.Oct.26 v1.3 Release the shared coefficient tables, which are
+                       kept in the registry.
+        17.Oct.26 v1.4 Deallocate the shared tables with their last
+                       filter, under the lock of the registry.
 
  ============================================================================
 */
 void            hq_free(fir_ptr)
   SCD_FIR        *fir_ptr;
 {
+  struct fir_coef **link, *coef;
+
+  if (fir_ptr->fft != NULL)	/* free FFT convolution state */
+  {
+    free(fir_ptr->fft->X);
+    free(fir_ptr->fft);
+  }
+
+  /* Release the shared tables; the last filter unlinks them from the
+   * registry */
+  coef = fir_ptr->coef;
+  FIR_LOCK();
+  if (--coef->nref == 0)
+  {
+    for (link = &fir_registry; *link != coef; link = &(*link)->next)
+      ;
+    *link = coef->next;
+  }
+  else
+    coef = NULL;
+  FIR_UNLOCK();
+  if (coef != NULL)
+    fir_coef_free(coef);
 
   free(fir_ptr->T);		/* free state variables */
-  free(fir_ptr->h0);		/* free state impulse response */
   free(fir_ptr);		/* free allocated struct */
 }
 /* .......................... End of hq_free() .......................... */
@@ -256,6 +510,7 @@ void            hq_free(fir_ptr)
         History:
         ~~~~~~~~
         28.Feb.92 v1.0 Release of 1st version <hf@pkinbg.uucp>
+        17.Oct.26 v1.1 Clear the FFT convolution state.
 
  ============================================================================
 */
@@ -266,6 +521,8 @@ void            hq_reset(fir_ptr)
   for (k = 0; k < fir_ptr->lenh0 - 1; k++)	/* clear delay line */
     fir_ptr->T[k] = 0.0;	/* (= state variables) */
   fir_ptr->k0 = 0;		/* default starting index in x-array */
+  if (fir_ptr->fft != NULL)
+    fir_fft_reset(fir_ptr->fft);
 }
 /* .......................... End of hq_reset() .......................... */
 
@@ -289,7 +546,10 @@ void            hq_reset(fir_ptr)
         gain: ........ (In) gain factor for FIR-coeffic.
         idwnup: ...... (In) Down-/Up-sampling factor
         hswitch: ..... (In) switch to up/downsampling
-                            procedure in "hq_kernel"
+                            procedure in "hq_kernel": 'D' (down-
+                            sampling, also 1:1), 'U' (up-sampling) or
+                            'R' (up-sampling by idwnup, then down-
+                            sampling by the factor stored in dwn)
 
         Return value:
         ~~~~~~~~~~~~~
@@ -302,6 +562,13 @@ void            hq_reset(fir_ptr)
         ~~~~~~~~
         28.Feb.92 v1.0 Release of 1st version <hf@pkinbg.uucp>
         12.Mar.92 v1.1 Corrected casting of malloc.
+        17.Oct.26 v1.2 Build the polyphase tables of the kernels.
+        17.Oct.26 v1.3 Check for AVX2 support.
+        17.Oct.26 v1.4 FFT convolution for long 1:1 filters.
+        17.Oct.26 v1.5 Rational resamplers (hswitch 'R', the down-sampling
+                       factor being set afterwards in dwn).
+        17.Oct.26 v1.6 The coefficient tables are shared, only the delay
+                       line and FFT convolution state are allocated.
 
  ============================================================================
 */
@@ -313,6 +580,7 @@ SCD_FIR *fir_initialization(lenh0, h0, gain, idwnup, hswitch)
   int /* char */  hswitch;
 {
   SCD_FIR        *ptrFIR;	/* pointer to the new struct */
+  struct fir_coef *coef;	/* shared tables */
   float           fak;
   long            k;
 
@@ -327,15 +595,16 @@ SCD_FIR *fir_initialization(lenh0, h0, gain, idwnup, hswitch)
     return 0;
   }
 
-  /* Allocate memory for delay line */
-  if ((ptrFIR->T = (float *) malloc((lenh0 - 1) * sizeof(fak))) == (float *) 0)
+  /* Allocate memory for delay line; the kernels append up to lenh0
+   * input samples to it */
+  if ((ptrFIR->T = (float *) malloc((2 * lenh0 - 1) * sizeof(fak))) == (float *) 0)
   {
     free(ptrFIR);		/* deallocate struct FIR */
     return 0;
   }
 
-  /* Allocate memory for impulse response */
-  if ((ptrFIR->h0 = (float *) malloc(lenh0 * sizeof(fak))) == (float *) 0)
+  /* Find or build the tables of the coefficients */
+  if ((coef = fir_coef_get(lenh0, h0, gain, idwnup, hswitch)) == NULL)
   {
     free(ptrFIR->T);		/* deallocate delay line */
     free(ptrFIR);		/* deallocate struct FIR */
@@ -349,10 +618,15 @@ SCD_FIR *fir_initialization(lenh0, h0, gain, idwnup, hswitch)
   /* Store number of FIR-coefficients */
   ptrFIR->lenh0 = lenh0;
 
-  /* Fill FIR coefficients into struct; for upsampling tasks the
+  /* FIR coefficients and polyphase tables, shared with the other filters
+   * with the same coefficients; for upsampling tasks the
    * FIR-coefficients are multiplied by the upsampling factor 'gain' */
-  for (k = 0; k <= ptrFIR->lenh0 - 1; k++)
-    ptrFIR->h0[k] = gain * h0[k];
+  ptrFIR->coef = coef;
+  ptrFIR->h0 = coef->h0;
+  ptrFIR->nph = coef->nph;
+  ptrFIR->oph = coef->oph;
+  ptrFIR->kph = coef->kph;
+  ptrFIR->hph = coef->hph;
 
   /* Store down-/up-sampling factor */
   ptrFIR->dwn_up = idwnup;
@@ -360,6 +634,10 @@ SCD_FIR *fir_initialization(lenh0, h0, gain, idwnup, hswitch)
   /* Store switch to FIR-kernel (up- or downsampling function) */
   ptrFIR->hswitch = hswitch;
 
+  /* Down-sampling factor of rational resamplers, set by their
+   * initialization function */
+  ptrFIR->dwn = 1;
+
   /* Clear Delay Line */
   for (k = 0; k < ptrFIR->lenh0 - 1; k++)
     ptrFIR->T[k] = 0.0;
@@ -370,6 +648,16 @@ SCD_FIR *fir_initialization(lenh0, h0, gain, idwnup, hswitch)
    * the next input segment to be processed */
   ptrFIR->k0 = 0;
 
+  /* Long 1:1 filters use the FFT convolution */
+  ptrFIR->fft = NULL;
+#ifdef FIR_FFT
+  if (coef->K > 0 && fir_fft_init(ptrFIR) != 0)
+  {
+    hq_free(ptrFIR);		/* deallocate everything */
+    return 0;
+  }
+#endif
+
   /* Return pointer to struct */
   return (ptrFIR);
 }
@@ -379,283 +667,1572 @@ SCD_FIR *fir_initialization(lenh0, h0, gain, idwnup, hswitch)
 /*
   ============================================================================
 
-        long fir_downsampling_kernel (long lenx, float *x_ptr, float *y_ptr,
-        ~~~~~~~~~~~~~~~~~~~~~~~~~~~~  long lenh0, float *h0_ptr, float *T_ptr,
-                                      long downfac, long *k0_ptr);
+        struct fir_coef *fir_coef_get (long lenh0, float h0[], double gain,
+        ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~  long idwnup, int hswitch);
 
         Description:
         ~~~~~~~~~~~~
 
-        FIR-Filter (kernel) (for down-sampling, including downsampling
-        factor 1).
+        Returns the shared tables of the FIR-coefficients gain*h0[], for
+        the kernel given by idwnup and hswitch. The registry is searched
+        for a set with the same coefficients, which are compared by
+        value (so the tables designed at run time, as those of the
+        resamplers, are shared as well). If there is none, the tables
+        are built and added to the registry. The number of filters using
+        the set is incremented. The registry is locked meanwhile.
 
         Parameters:
         ~~~~~~~~~~~
-        lenx: ..... (In)    length of input signal
-        x: ........ (In)    array with input samples
-        y: ........ (Out)   array with output samples
-        lenh0: .... (In)    number of  FIR-coefficients
-        h0: ....... (In)    array with FIR-coefficients
-        T: ........ (InOut) state variables
-        downfac: .. (In)    downsampling factor
-        k0: ....... (InOut) offset in x-array
+        lenh0, h0, gain, idwnup, hswitch: as for fir_initialization()
 
         Return value:
         ~~~~~~~~~~~~~
-        Number of filtered samples.
-
-        Author: <hf@pkinbg.uucp>
-        ~~~~~~~
+        Pointer to the tables, NULL if the memory could not be
+        allocated.
 
         History:
         ~~~~~~~~
-        28.Feb.1992 v1.0 Release of 1st version <hf@pkinbg.uucp>
-        12.Jul.2000 -    Bug identified; correction solicited  <simao>
-		03.Dec.2004 v2.3 Sample-based bug solved. <Cyril Guillaume & Stephane Ragot - stephane.ragot@francetelecom.com>
+        17.Oct.26 v1.0 Release of 1st version
+        17.Oct.26 v1.1 Lock the registry, tables built by fir_coef_build().
 
  ============================================================================
 */
-static long     fir_downsampling_kernel(lenx, x, y, lenh0, h0, T, downfac, k0)
-  long            lenx;
-  float          *x;
-  float          *y;
+static struct fir_coef *fir_coef_get(lenh0, h0, gain, idwnup, hswitch)
   long            lenh0;
-  float          *h0;
-  float          *T;
-  long            downfac;
-  long           *k0;
+  float           h0[];
+  double          gain;
+  long            idwnup;
+  int             hswitch;
 {
-  long            ktrans, kx, kStart, ky, kappa;	/* loop indices */
-
-
-/*
-  * ......... First Step: Transition from k=0 ... k=lenh0-2 .........
-  */
+  struct fir_coef *coef;
+  long            k;
 
-  kStart = *k0;
-  ky = 0;			/* starting index in output array (y) */
-  ktrans = lenh0 - 1;
-  if (ktrans > lenx - 1)
-    ktrans = lenx - 1;		/* x[*] less than h0[*]? */
+  FIR_LOCK();
 
-  for (kx = *k0; kx <= ktrans; kx += downfac)
+  /* Look for the same coefficients in the registry */
+  for (coef = fir_registry; coef != NULL; coef = coef->next)
   {
-    y[ky] = x[kx] * h0[0];	/* first part in dot-product */
-    for (kappa = 1; kappa <= kx; kappa++)	/* first part from x-array */
-    {
-      y[ky] += x[kx - kappa] * h0[kappa];
-    }
+    if (coef->lenh0 != lenh0 || coef->dwn_up != idwnup ||
+	coef->hswitch != hswitch)
+      continue;
+    for (k = 0; k < lenh0 && coef->h0[k] == (float) (gain * h0[k]); k++)
+      ;
+    if (k == lenh0)
+      break;
+  }
 
-    for (kappa = kx + 1; kappa < lenh0; kappa++)	/* second part from
-							 * T-array */
-    {
-      y[ky] += T[lenh0 - 2 + kx + 1 - kappa] * h0[kappa];
-    }
-    ky++;
-    kStart = kx;		/* Save index of last processed sample */
+  if (coef != NULL)
+    coef->nref++;
+  else if ((coef = fir_coef_build(lenh0, h0, gain, idwnup, hswitch)) != NULL)
+  {
+    /* Add the new set to the registry */
+    coef->nref = 1;
+    coef->next = fir_registry;
+    fir_registry = coef;
   }
 
+  FIR_UNLOCK();
+  return coef;
+}
+/* ........................ End of fir_coef_get() ........................ */
+
 
 /*
-  * ......... Second Step: remaining part in x-array .........
-  */
+  ============================================================================
 
-  *k0 = kStart;
-  for (kx = kStart + downfac; kx <= lenx - 1; kx += downfac)
-  {
-    y[ky] = x[kx] * h0[0];	/* first part in dot-product */
-    for (kappa = 1; kappa <= lenh0 - 1; kappa++)
-    {
-      y[ky] += x[kx - kappa] * h0[kappa];	/* remaining part of
-						 * dot-product */
-    }
-    ky++;
-    *k0 = kx;
-  }
+        struct fir_coef *fir_coef_build (long lenh0, float h0[],
+        ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~  double gain, long idwnup,
+                                         int hswitch);
 
-  /* if the number of input samples is not a multiple of the down sampling
-   * factor, k0 points to the first sample in the next input segment to be
-   * processed */
-  if (*k0 <= lenx -1)
-  {
-      *k0 = *k0 + downfac;
-      *k0 = *k0 - lenx;
-  } else						/* if the offset was greater than the block length, nothing was done.
-								 * Just decrease the value of this offset with the size of this "skipped" block */
-  {
-	  *k0 = *k0 - lenx;
-  }
+        Description:
+        ~~~~~~~~~~~~
 
+        Builds the tables of the FIR-coefficients gain*h0[] for the
+        kernel given by idwnup and hswitch: the coefficients, their
+        polyphase tables and the FFT partitions. The set is not added to
+        the registry.
 
-/*
- * ......... Last Step: copy end of x-array into T-array .........
- *                      (update of delay line)
- */
+        Parameters:
+        ~~~~~~~~~~~
+        lenh0, h0, gain, idwnup, hswitch: as for fir_initialization()
 
-  if (lenx >= lenh0 - 1)	/* ... all samples taken from x-array */
+        Return value:
+        ~~~~~~~~~~~~~
+        Pointer to the tables, NULL if the memory could not be
+        allocated.
+
+        History:
+        ~~~~~~~~
+        17.Oct.26 v1.0 Release of 1st version (from fir_coef_get())
+
+ ============================================================================
+*/
+static struct fir_coef *fir_coef_build(lenh0, h0, gain, idwnup, hswitch)
+  long            lenh0;
+  float           h0[];
+  double          gain;
+  long            idwnup;
+  int             hswitch;
+{
+  struct fir_coef *coef;
+  long            k;
+
+  if ((coef = (struct fir_coef *) malloc(sizeof(struct fir_coef))) == NULL)
+    return NULL;
+  coef->lenh0 = lenh0;
+  coef->dwn_up = idwnup;
+  coef->hswitch = hswitch;
+  coef->nph = coef->oph = coef->kph = coef->rev = (long *) 0;
+  coef->hph = (float *) 0;
+  coef->wr = (double *) 0;
+  coef->P = coef->K = coef->nhead = 0;
+  coef->nref = 0;
+  coef->next = NULL;
+
+  if ((coef->h0 = (float *) malloc(lenh0 * sizeof(float))) == (float *) 0)
   {
-    for (kappa = 0; kappa <= lenh0 - 2; kappa++)
-    {
-      T[kappa] = x[lenx + 1 - lenh0 + kappa];
-    }
+    free(coef);
+    return NULL;
   }
-  else
+  for (k = 0; k < lenh0; k++)
+    coef->h0[k] = gain * h0[k];
+
+#ifdef FIR_SIMD_AVX2
+  /* Check once whether the AVX2 kernel can be used */
+  if (fir_avx2 < 0)
+    fir_avx2 = fir_cpu_avx2();
+#endif
+
+  /* Tables of the non-zero coefficients, used by the kernels, and of
+   * the FFT convolution of long 1:1 filters */
+  if (fir_polyphase_tables(coef) != 0
+#ifdef FIR_FFT
+      || fir_fft_tables(coef) != 0
+#endif
+    )
   {
-    /* Left-Shift of T-array */
-    for (kappa = 0; kappa <= lenh0 - 2 - lenx; kappa++)
-    {
-      T[kappa] = T[kappa + lenx];
-    }
-
-    /* Copy complete x-array -> T-array */
-    for (kappa = lenh0 - 1 - lenx; kappa <= lenh0 - 2; kappa++)
-    {
-      T[kappa] = x[lenx - 1 + kappa - (lenh0 - 2)];
-    }
+    fir_coef_free(coef);
+    return NULL;
   }
 
-  /* Return number of output samples */
-  return ky;
+  return coef;
 }
-/* ................... End of fir_downsampling_kernel() ................... */
-
+/* ....................... End of fir_coef_build() ....................... */
 
 
 /*
   ============================================================================
 
-        long fir_upsampling_kernel (long lenx, float *x_ptr, float *y_ptr,
-        ~~~~~~~~~~~~~~~~~~~~~~~~~~  long lenh0, float *h0_ptr, float *T_ptr,
-                                    long iupfac);
+        void fir_coef_free (struct fir_coef *coef);
+        ~~~~~~~~~~~~~~~~~~
 
         Description:
         ~~~~~~~~~~~~
 
-        FIR-Filter (kernel) for upsampling routine.
+        Deallocates a set of shared tables, which must not be in the
+        registry.
 
         Parameters:
         ~~~~~~~~~~~
-        lenx: .... (In)    length of input signal
-        x: ....... (In)    array with input samples
-        y: ....... (Out)   array with output samples
-        lenh0: ... (In)    number of  FIR-coefficients
-        h0: ...... (In)    array with FIR-coefficients
-        T: ....... (InOut) state variables
-        iupfac: .. (In)    upsampling factor
+        coef: .... (In) tables to deallocate
 
         Return value:
         ~~~~~~~~~~~~~
-        Number of filtered samples.
-
-        Author: <hf@pkinbg.uucp>
-        ~~~~~~~
+        None.
 
         History:
         ~~~~~~~~
-        28.Feb.92 v1.0 Release of 1st version <hf@pkinbg.uucp>
+        17.Oct.26 v1.0 Release of 1st version
 
  ============================================================================
 */
-static long     fir_upsampling_kernel(lenx, x, y, lenh0, h0, T, iupfac)
-  long            lenx;
-  float          *x, *y;
-  long            lenh0;
-  float          *h0, *T;
-  long            iupfac;
+static void     fir_coef_free(coef)
+  struct fir_coef *coef;
 {
-  long            ktrans, iup, kx, kStart, ky, kappa;	/* loop indices */
-
+  free(coef->wr);
+  free(coef->rev);
+  free(coef->hph);
+  free(coef->kph);
+  free(coef->oph);
+  free(coef->nph);
+  free(coef->h0);
+  free(coef);
+}
+/* ....................... End of fir_coef_free() ........................ */
 
-  ky = 0;			/* starting index in output array (y) */
 
 /*
-  * ......... FIRST STEP: Transition from k=(0..lenh0/iupasm-2) .........
-  */
+  ============================================================================
 
-  kStart = 0;
-  ktrans = (lenh0 / iupfac > lenx ?	/* length of transition */
-	    lenx :
-	    lenh0 / iupfac);
-  for (kx = 0; kx <= ktrans - 1; kx++)
-  {
-    /* Loop over #iupfac partial FIR coefficients */
-    for (iup = 0; iup <= iupfac - 1; iup++)
-    {
-      /* ... first contribution in dot-product */
-      y[ky] = x[kx] * h0[iup];
+        int fir_polyphase_tables (struct fir_coef *coef);
+        ~~~~~~~~~~~~~~~~~~~~~~~~
 
-      /* ... compute partial dot-product with source data from x-array */
-      for (kappa = 1; kappa <= kx; kappa++)
-      {
-	y[ky] += x[kx - kappa] * h0[iup + kappa * iupfac];
-      }
+        Description:
+        ~~~~~~~~~~~~
+
+        Allocate and fill the tables of the non-zero FIR-coefficients
+        used by the kernels. An up-sampling filter (or rational
+        resampler) by a factor iupfac is split into iupfac polyphase
+        branches, branch iup holding the
+        coefficients h0[iup + kappa*iupfac], kappa=0..lenh0/iupfac-1; a
+        down-sampling filter has a single branch with all coefficients.
+        For each branch, nph[] gives the number of non-zero coefficients,
+        which are stored in hph[] with their delay kappa in kph[], in
+        increasing order of kappa, starting at index oph[]. The kernels thus add the same products
+        in the same order as the full dot-product, without the products
+        by zero.
+
+        Parameters:
+        ~~~~~~~~~~~
+        coef: .... (InOut) shared tables, with lenh0, h0, dwn_up and
+                           hswitch already set;
 
-      /* ... compute rest of dot-product with source data from T-array */
-      for (kappa = kx + 1; kappa < lenh0 / iupfac; kappa++)
+        Return value:
+        ~~~~~~~~~~~~~
+        0 on success, -1 if the tables could not be allocated.
+
+        History:
+        ~~~~~~~~
+        17.Oct.26 v1.0 Release of 1st version
+        17.Oct.26 v1.1 Branches of rational resamplers, index of the first
+                       coefficient of each branch.
+        17.Oct.26 v1.2 Tables in the shared struct fir_coef.
+
+ ============================================================================
+*/
+static int      fir_polyphase_tables(coef)
+  struct fir_coef *coef;
+{
+  long            nbranch, lensub, iup, kappa, j;
+
+  /* Number and length of the polyphase branches */
+  nbranch = (coef->hswitch == 'U' || coef->hswitch == 'R')
+    ? coef->dwn_up : 1;
+  lensub = coef->lenh0 / nbranch;
+
+  coef->nph = (long *) malloc(nbranch * sizeof(long));
+  coef->oph = (long *) malloc(nbranch * sizeof(long));
+  coef->kph = (long *) malloc(coef->lenh0 * sizeof(long));
+  coef->hph = (float *) malloc(coef->lenh0 * sizeof(float));
+  if (coef->nph == (long *) 0 || coef->oph == (long *) 0 ||
+      coef->kph == (long *) 0 || coef->hph == (float *) 0)
+    return -1;			/* freed by fir_coef_free() */
+
+  /* Keep the non-zero coefficients of each branch */
+  for (j = 0, iup = 0; iup < nbranch; iup++)
+  {
+    coef->nph[iup] = 0;
+    coef->oph[iup] = j;
+    for (kappa = 0; kappa < lensub; kappa++)
+    {
+      if (coef->h0[iup + kappa * nbranch] != 0.0)
       {
-	y[ky] += T[lenh0 / iupfac - 2 + kx + 1 - kappa]
-	  * h0[iup + kappa * iupfac];
+        coef->kph[j] = kappa;
+        coef->hph[j] = coef->h0[iup + kappa * nbranch];
+        coef->nph[iup]++;
+        j++;
       }
-      ky++;
     }
-    kStart = kx;		/* Save index of last processed sample */
   }
 
+  return 0;
+}
+/* .................... End of fir_polyphase_tables() .................... */
+
 
 /*
- * ......... SECOND STEP: compute remaining dot-products ..........
- *                        completely with data from x[*]
- */
+  ============================================================================
 
-  for (kx = kStart + 1; kx <= lenx - 1; kx++)
-  {
-    for (iup = 0; iup <= iupfac - 1; iup++)
-    {
-      /* ... first contribution in dot-product */
-      y[ky] = x[kx] * h0[iup];
+        void fir_dot4 (float *x_ptr, long xstep, long ntaps, long *kph_ptr,
+        ~~~~~~~~~~~~~  float *hph_ptr, float *y_ptr, long ystep);
 
-      /* ... compute partial dot-product with source data from x-array */
-      for (kappa = 1; kappa <= lenh0 / iupfac - 1; kappa++)
-      {
-	y[ky] += x[kx - kappa] * h0[iup + kappa * iupfac];
-      }
-      ky++;
-    }
+        Description:
+        ~~~~~~~~~~~~
+
+        Computes the dot-products of one polyphase branch for the four
+        input samples x[0], x[xstep], x[2*xstep] and x[3*xstep], and
+        stores them in y[0], y[ystep], y[2*ystep] and y[3*ystep]. Each
+        dot-product adds its products in the same order as a single one,
+        so the results are identical; the four independent sums just keep
+        the floating-point unit busy. All the input samples must be in
+        the x-array.
+
+        Parameters:
+        ~~~~~~~~~~~
+        x: ....... (In)    pointer to the first input sample
+        xstep: ... (In)    distance between the four input samples
+        ntaps: ... (In)    number of non-zero FIR-coefficients
+        kph: ..... (In)    delays of the non-zero FIR-coefficients
+        hph: ..... (In)    non-zero FIR-coefficients
+        y: ....... (Out)   pointer to the first output sample
+        ystep: ... (In)    distance between the four output samples
+
+        Return value:
+        ~~~~~~~~~~~~~
+        None.
+
+        History:
+        ~~~~~~~~
+        17.Oct.26 v1.0 Release of 1st version
+
+ ============================================================================
+*/
+static void     fir_dot4(x, xstep, ntaps, kph, hph, y, ystep)
+  float          *x;
+  long            xstep, ntaps;
+  long           *kph;
+  float          *hph, *y;
+  long            ystep;
+{
+  float           acc0, acc1, acc2, acc3, *xp;
+  long            j;
+
+  acc0 = acc1 = acc2 = acc3 = 0.0;
+  for (j = 0; j < ntaps; j++)
+  {
+    xp = x - kph[j];
+    acc0 += xp[0] * hph[j];
+    acc1 += xp[xstep] * hph[j];
+    acc2 += xp[2 * xstep] * hph[j];
+    acc3 += xp[3 * xstep] * hph[j];
   }
+  y[0] = acc0;
+  y[ystep] = acc1;
+  y[2 * ystep] = acc2;
+  y[3 * ystep] = acc3;
+}
+/* .......................... End of fir_dot4() .......................... */
 
 
 /*
- * ......... Last Step: copy end of x-array into T-array .........
- *                        (update of delay line)
- */
+  ============================================================================
 
-  if (lenx >= lenh0 / iupfac - 1)
+        long fir_polyphase_block (float *x_ptr, long kfirst, long klast,
+        ~~~~~~~~~~~~~~~~~~~~~~~~  long xstep, long nbranch, long *nph_ptr,
+                                  long *kph_ptr, float *hph_ptr,
+                                  float *y_ptr);
+
+        Description:
+        ~~~~~~~~~~~~
+
+        Computes, for the input samples x[kx], kx = kfirst, kfirst+xstep,
+        ... up to klast, the output sample of each of the nbranch
+        polyphase branches, and stores them one after the other in y[].
+        Consecutive input samples (xstep = 1) go first to the SIMD
+        kernels, if available. Then four input samples are processed at
+        a time by fir_dot4(), the last ones one by one. x[kx - kph[j]]
+        must be valid for all these samples and taps.
+
+        Parameters:
+        ~~~~~~~~~~~
+        x: ....... (In)    array with input samples
+        kfirst: .. (In)    index of the first input sample
+        klast: ... (In)    index of the last possible input sample
+        xstep: ... (In)    step between input samples (down-sampling factor)
+        nbranch: . (In)    number of polyphase branches (up-sampling factor)
+        nph: ..... (In)    number of non-zero FIR-coefficients per branch
+        kph: ..... (In)    delays of the non-zero FIR-coefficients
+        hph: ..... (In)    non-zero FIR-coefficients
+        y: ....... (Out)   array with output samples
+
+        Return value:
+        ~~~~~~~~~~~~~
+        Number of output samples.
+
+        History:
+        ~~~~~~~~
+        17.Oct.26 v1.0 Release of 1st version
+        17.Oct.26 v1.1 SIMD kernels for consecutive input samples.
+
+ ============================================================================
+*/
+static long     fir_polyphase_block(x, kfirst, klast, xstep, nbranch, nph,
+                                    kph, hph, y)
+  float          *x;
+  long            kfirst, klast, xstep, nbranch;
+  long           *nph, *kph;
+  float          *hph, *y;
+{
+  long            kx, ky, iup, j;
+  long           *kp;		/* taps of the current branch */
+  float          *hp, acc;
+
+  ky = 0;
+  kx = kfirst;
+
+#ifdef FIR_SIMD_SSE2
+  /* 16 (AVX2) or 8 (SSE2) consecutive input samples at a time */
+  if (xstep == 1)
   {
-    /* ... all samples taken from x-array */
-    for (kappa = 0; kappa <= lenh0 / iupfac - 2; kappa++)
+#ifdef FIR_SIMD_AVX2
+    if (fir_avx2 > 0)
     {
-      T[kappa] = x[lenx + 1 - lenh0 / iupfac + kappa];
+      j = fir_block_avx2(x, kx, klast, nbranch, nph, kph, hph, y);
+      kx += j;
+      ky += j * nbranch;
     }
+#endif
+    j = fir_block_sse2(x, kx, klast, nbranch, nph, kph, hph, &y[ky]);
+    kx += j;
+    ky += j * nbranch;
   }
-  else
+#endif
+
+  /* Four input samples at a time, branch after branch */
+  for (; kx + 3 * xstep <= klast; kx += 4 * xstep)
   {
-    /* ... left-Shift of T-array */
-    for (kappa = 0; kappa <= lenh0 / iupfac - 2 - lenx; kappa++)
+    for (kp = kph, hp = hph, iup = 0; iup < nbranch; iup++)
     {
-      T[kappa] = T[kappa + lenx];
+      fir_dot4(&x[kx], xstep, nph[iup], kp, hp, &y[ky + iup], nbranch);
+      kp += nph[iup];		/* next polyphase branch */
+      hp += nph[iup];
     }
+    ky += 4 * nbranch;
+  }
 
-    /* ... copy complete x-array -> T-array */
-    for (kappa = lenh0 / iupfac - 1 - lenx;
-	 kappa <= lenh0 / iupfac - 2; kappa++)
+  /* Last input samples */
+  for (; kx <= klast; kx += xstep)
+  {
+    for (kp = kph, hp = hph, iup = 0; iup < nbranch; iup++)
     {
-      T[kappa] = x[lenx - 1 + kappa - (lenh0 / iupfac - 2)];
+      acc = 0.0;
+      for (j = 0; j < nph[iup]; j++)
+      {
+        acc += x[kx - kp[j]] * hp[j];
+      }
+      y[ky++] = acc;
+      kp += nph[iup];		/* next polyphase branch */
+      hp += nph[iup];
     }
   }
 
   return ky;
 }
-/* ................. End of fir_upsampling_kernel() .................. */
+/* ..................... End of fir_polyphase_block() ..................... */
+
+
+#ifdef FIR_SIMD_SSE2
+/*
+  ============================================================================
+
+        long fir_block_sse2 (float *x_ptr, long kfirst, long klast,
+        ~~~~~~~~~~~~~~~~~~~  long nbranch, long *nph_ptr, long *kph_ptr,
+                             float *hph_ptr, float *y_ptr);
+
+        long fir_block_avx2 (float *x_ptr, long kfirst, long klast,
+        ~~~~~~~~~~~~~~~~~~~  long nbranch, long *nph_ptr, long *kph_ptr,
+                             float *hph_ptr, float *y_ptr);
+
+        Description:
+        ~~~~~~~~~~~~
+
+        Same as fir_polyphase_block() with xstep = 1, for groups of 8
+        (SSE2) or 16 (AVX2) input samples, as long as a whole group fits
+        before klast. Each vector lane computes the dot-product of one
+        input sample: it adds the same products in the same order as the
+        scalar code, with separate multiplications and additions, so the
+        results are identical. The samples of a group are read with
+        unaligned loads from the contiguous x-array (or delay line), and
+        each coefficient is broadcast to all lanes.
+
+        Parameters:
+        ~~~~~~~~~~~
+        See fir_polyphase_block().
+
+        Return value:
+        ~~~~~~~~~~~~~
+        Number of input samples processed, a multiple of the group size.
+
+        History:
+        ~~~~~~~~
+        17.Oct.26 v1.0 Release of 1st version
+
+ ============================================================================
+*/
+static long     fir_block_sse2(x, kfirst, klast, nbranch, nph, kph, hph, y)
+  float          *x;
+  long            kfirst, klast, nbranch;
+  long           *nph, *kph;
+  float          *hph, *y;
+{
+  long            kx, ky, iup, j, m;
+  long           *kp;		/* taps of the current branch */
+  float          *hp, *xp, t[8];
+  __m128          acc0, acc1, h;
+
+  ky = 0;
+  for (kx = kfirst; kx + 7 <= klast; kx += 8)
+  {
+    for (kp = kph, hp = hph, iup = 0; iup < nbranch; iup++)
+    {
+      acc0 = acc1 = _mm_setzero_ps();
+      for (j = 0; j < nph[iup]; j++)
+      {
+        xp = &x[kx - kp[j]];
+        h = _mm_set1_ps(hp[j]);
+        acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(xp), h));
+        acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(xp + 4), h));
+      }
+      if (nbranch == 1)
+      {
+        _mm_storeu_ps(&y[ky], acc0);
+        _mm_storeu_ps(&y[ky + 4], acc1);
+      }
+      else
+      {
+        _mm_storeu_ps(t, acc0);	/* outputs of the branch are */
+        _mm_storeu_ps(t + 4, acc1);	/* nbranch samples apart */
+        for (m = 0; m < 8; m++)
+          y[ky + iup + m * nbranch] = t[m];
+      }
+      kp += nph[iup];		/* next polyphase branch */
+      hp += nph[iup];
+    }
+    ky += 8 * nbranch;
+  }
+
+  return kx - kfirst;
+}
+/* ....................... End of fir_block_sse2() ....................... */
+#endif
+
+
+#ifdef FIR_SIMD_AVX2
+FIR_AVX2_TARGET
+static long     fir_block_avx2(float *x, long kfirst, long klast,
+                               long nbranch, long *nph, long *kph,
+                               float *hph, float *y)
+{
+  long            kx, ky, iup, j, m;
+  long           *kp;		/* taps of the current branch */
+  float          *hp, *xp, t[16];
+  __m256          acc0, acc1, h;
+
+  ky = 0;
+  for (kx = kfirst; kx + 15 <= klast; kx += 16)
+  {
+    for (kp = kph, hp = hph, iup = 0; iup < nbranch; iup++)
+    {
+      acc0 = acc1 = _mm256_setzero_ps();
+      for (j = 0; j < nph[iup]; j++)
+      {
+        xp = &x[kx - kp[j]];
+        h = _mm256_set1_ps(hp[j]);
+        acc0 = _mm256_add_ps(acc0, _mm256_mul_ps(_mm256_loadu_ps(xp), h));
+        acc1 = _mm256_add_ps(acc1, _mm256_mul_ps(_mm256_loadu_ps(xp + 8), h));
+      }
+      if (nbranch == 1)
+      {
+        _mm256_storeu_ps(&y[ky], acc0);
+        _mm256_storeu_ps(&y[ky + 8], acc1);
+      }
+      else
+      {
+        _mm256_storeu_ps(t, acc0);	/* outputs of the branch are */
+        _mm256_storeu_ps(t + 8, acc1);	/* nbranch samples apart */
+        for (m = 0; m < 16; m++)
+          y[ky + iup + m * nbranch] = t[m];
+      }
+      kp += nph[iup];		/* next polyphase branch */
+      hp += nph[iup];
+    }
+    ky += 16 * nbranch;
+  }
+
+  return kx - kfirst;
+}
+/* ....................... End of fir_block_avx2() ....................... */
+
+
+/*
+  ============================================================================
+
+        int fir_cpu_avx2 (void);
+        ~~~~~~~~~~~~~~~~
+
+        Description:
+        ~~~~~~~~~~~~
+
+        Tells whether the CPU and the operating system support AVX2.
+
+        Return value:
+        ~~~~~~~~~~~~~
+        1 if fir_block_avx2() can be used, 0 otherwise.
+
+        History:
+        ~~~~~~~~
+        17.Oct.26 v1.0 Release of 1st version
+
+ ============================================================================
+*/
+static int      fir_cpu_avx2()
+{
+#if defined(__GNUC__)
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("avx2") ? 1 : 0;
+#else
+  int             r[4];
+
+  __cpuid(r, 0);
+  if (r[0] < 7)
+    return 0;
+  __cpuid(r, 1);
+  if (!(r[2] & (1 << 27)) || !(r[2] & (1 << 28)))	/* OSXSAVE, AVX */
+    return 0;
+  if ((_xgetbv(0) & 6) != 6)	/* YMM state saved by the OS */
+    return 0;
+  __cpuidex(r, 7, 0);
+  return (r[1] >> 5) & 1;	/* AVX2 */
+#endif
+}
+/* ........................ End of fir_cpu_avx2() ........................ */
+#endif
+
+
+/*
+  ============================================================================
+
+        long fir_downsampling_kernel (long lenx, float *x_ptr, float *y_ptr,
+        ~~~~~~~~~~~~~~~~~~~~~~~~~~~~  long lenh0, long *nph_ptr,
+                                      long *kph_ptr, float *hph_ptr,
+                                      float *T_ptr, long downfac,
+                                      long *k0_ptr);
+
+        Description:
+        ~~~~~~~~~~~~
+
+        FIR-Filter (kernel) (for down-sampling, including downsampling
+        factor 1). Only the kept output samples are computed, using only
+        the non-zero FIR-coefficients.
+
+        Parameters:
+        ~~~~~~~~~~~
+        lenx: ..... (In)    length of input signal
+        x: ........ (In)    array with input samples
+        y: ........ (Out)   array with output samples
+        lenh0: .... (In)    number of  FIR-coefficients
+        nph: ...... (In)    number of non-zero FIR-coefficients
+        kph: ...... (In)    delays of the non-zero FIR-coefficients
+        hph: ...... (In)    non-zero FIR-coefficients
+        T: ........ (InOut) state variables
+        downfac: .. (In)    downsampling factor
+        k0: ....... (InOut) offset in x-array
+
+        Return value:
+        ~~~~~~~~~~~~~
+        Number of filtered samples.
+
+        Author: <hf@pkinbg.uucp>
+        ~~~~~~~
+
+        History:
+        ~~~~~~~~
+        28.Feb.1992 v1.0 Release of 1st version <hf@pkinbg.uucp>
+        12.Jul.2000 -    Bug identified; correction solicited  <simao>
+		03.Dec.2004 v2.3 Sample-based bug solved. <Cyril Guillaume & Stephane Ragot - stephane.ragot@francetelecom.com>
+        17.Oct.2026 v2.4 Dot-products over the non-zero coefficients only.
+
+ ============================================================================
+*/
+static long     fir_downsampling_kernel(lenx, x, y, lenh0, nph, kph, hph, T,
+                                        downfac, k0)
+  long            lenx;
+  float          *x;
+  float          *y;
+  long            lenh0;
+  long           *nph;
+  long           *kph;
+  float          *hph;
+  float          *T;
+  long            downfac;
+  long           *k0;
+{
+  long            ktrans, kx, kStart, ky, kappa, n;	/* loop indices */
+  float          *Tx;		/* delay line followed by x[0..ktrans] */
+
+
+/*
+  * ......... First Step: Transition from k=0 ... k=lenh0-2 .........
+  */
+
+  kStart = *k0;
+  ky = 0;			/* starting index in output array (y) */
+  ktrans = lenh0 - 1;
+  if (ktrans > lenx - 1)
+    ktrans = lenx - 1;		/* x[*] less than h0[*]? */
+
+  /* Append the first input samples to the delay line, so that
+   * Tx[kx - kappa] is x[kx - kappa] for kappa <= kx and the delay line
+   * for kappa > kx */
+  Tx = &T[lenh0 - 1];
+  for (kx = 0; kx <= ktrans; kx++)
+    Tx[kx] = x[kx];
+
+  n = fir_polyphase_block(Tx, *k0, ktrans, downfac, 1L, nph, kph, hph, y);
+  if (n > 0)
+    kStart = *k0 + (n - 1) * downfac;	/* Save index of last processed
+					 * sample */
+  ky += n;
+
+
+/*
+  * ......... Second Step: remaining part in x-array .........
+  */
+
+  n = fir_polyphase_block(x, kStart + downfac, lenx - 1, downfac, 1L,
+			  nph, kph, hph, &y[ky]);
+  *k0 = kStart + n * downfac;	/* index of last processed sample */
+  ky += n;
+
+  /* if the number of input samples is not a multiple of the down sampling
+   * factor, k0 points to the first sample in the next input segment to be
+   * processed */
+  if (*k0 <= lenx -1)
+  {
+      *k0 = *k0 + downfac;
+      *k0 = *k0 - lenx;
+  } else						/* if the offset was greater than the block length, nothing was done.
+								 * Just decrease the value of this offset with the size of this "skipped" block */
+  {
+	  *k0 = *k0 - lenx;
+  }
+
+
+/*
+ * ......... Last Step: copy end of x-array into T-array .........
+ *                      (update of delay line)
+ */
+
+  if (lenx >= lenh0 - 1)	/* ... all samples taken from x-array */
+  {
+    for (kappa = 0; kappa <= lenh0 - 2; kappa++)
+    {
+      T[kappa] = x[lenx + 1 - lenh0 + kappa];
+    }
+  }
+  else
+  {
+    /* Left-Shift of T-array */
+    for (kappa = 0; kappa <= lenh0 - 2 - lenx; kappa++)
+    {
+      T[kappa] = T[kappa + lenx];
+    }
+
+    /* Copy complete x-array -> T-array */
+    for (kappa = lenh0 - 1 - lenx; kappa <= lenh0 - 2; kappa++)
+    {
+      T[kappa] = x[lenx - 1 + kappa - (lenh0 - 2)];
+    }
+  }
+
+  /* Return number of output samples */
+  return ky;
+}
+/* ................... End of fir_downsampling_kernel() ................... */
+
+
+
+/*
+  ============================================================================
+
+        long fir_upsampling_kernel (long lenx, float *x_ptr, float *y_ptr,
+        ~~~~~~~~~~~~~~~~~~~~~~~~~~  long lenh0, long *nph_ptr,
+                                    long *kph_ptr, float *hph_ptr,
+                                    float *T_ptr, long iupfac);
+
+        Description:
+        ~~~~~~~~~~~~
+
+        FIR-Filter (kernel) for upsampling routine. Each input sample
+        gives iupfac output samples, one per polyphase branch, computed
+        from the non-zero FIR-coefficients of the branch only.
+
+        Parameters:
+        ~~~~~~~~~~~
+        lenx: .... (In)    length of input signal
+        x: ....... (In)    array with input samples
+        y: ....... (Out)   array with output samples
+        lenh0: ... (In)    number of  FIR-coefficients
+        nph: ..... (In)    number of non-zero FIR-coefficients per branch
+        kph: ..... (In)    delays of the non-zero FIR-coefficients
+        hph: ..... (In)    non-zero FIR-coefficients
+        T: ....... (InOut) state variables
+        iupfac: .. (In)    upsampling factor
+
+        Return value:
+        ~~~~~~~~~~~~~
+        Number of filtered samples.
+
+        Author: <hf@pkinbg.uucp>
+        ~~~~~~~
+
+        History:
+        ~~~~~~~~
+        28.Feb.92 v1.0 Release of 1st version <hf@pkinbg.uucp>
+        17.Oct.26 v2.4 Dot-products over the non-zero coefficients of each
+                       polyphase branch only.
+
+ ============================================================================
+*/
+static long     fir_upsampling_kernel(lenx, x, y, lenh0, nph, kph, hph, T,
+                                      iupfac)
+  long            lenx;
+  float          *x, *y;
+  long            lenh0;
+  long           *nph, *kph;
+  float          *hph, *T;
+  long            iupfac;
+{
+  long            ktrans, kx, kStart, ky, kappa;	/* loop indices */
+  float          *Tx;		/* delay line followed by x[0..ktrans-1] */
+
+
+  ky = 0;			/* starting index in output array (y) */
+
+/*
+  * ......... FIRST STEP: Transition from k=(0..lenh0/iupasm-2) .........
+  */
+
+  kStart = 0;
+  ktrans = (lenh0 / iupfac > lenx ?	/* length of transition */
+	    lenx :
+	    lenh0 / iupfac);
+
+  /* ... append the first input samples to the delay line, the
+   * dot-products then read Tx[kx - kappa] for all kappa */
+  Tx = &T[lenh0 / iupfac - 1];
+  for (kx = 0; kx <= ktrans - 1; kx++)
+    Tx[kx] = x[kx];
+
+  /* ... #iupfac partial dot-products per input sample */
+  ky += fir_polyphase_block(Tx, 0L, ktrans - 1, 1L, iupfac, nph, kph, hph, y);
+  if (ktrans > 0)
+    kStart = ktrans - 1;	/* Save index of last processed sample */
+
+
+/*
+ * ......... SECOND STEP: compute remaining dot-products ..........
+ *                        completely with data from x[*]
+ */
+
+  ky += fir_polyphase_block(x, kStart + 1, lenx - 1, 1L, iupfac,
+			    nph, kph, hph, &y[ky]);
+
+
+/*
+ * ......... Last Step: copy end of x-array into T-array .........
+ *                        (update of delay line)
+ */
+
+  if (lenx >= lenh0 / iupfac - 1)
+  {
+    /* ... all samples taken from x-array */
+    for (kappa = 0; kappa <= lenh0 / iupfac - 2; kappa++)
+    {
+      T[kappa] = x[lenx + 1 - lenh0 / iupfac + kappa];
+    }
+  }
+  else
+  {
+    /* ... left-Shift of T-array */
+    for (kappa = 0; kappa <= lenh0 / iupfac - 2 - lenx; kappa++)
+    {
+      T[kappa] = T[kappa + lenx];
+    }
+
+    /* ... copy complete x-array -> T-array */
+    for (kappa = lenh0 / iupfac - 1 - lenx;
+	 kappa <= lenh0 / iupfac - 2; kappa++)
+    {
+      T[kappa] = x[lenx - 1 + kappa - (lenh0 / iupfac - 2)];
+    }
+  }
+
+  return ky;
+}
+/* ................. End of fir_upsampling_kernel() .................. */
+
+
+
+/*
+  ============================================================================
+
+        long fir_resampling_kernel (long lenx, float *x_ptr, float *y_ptr,
+        ~~~~~~~~~~~~~~~~~~~~~~~~~~  long lenh0, long *nph_ptr,
+                                    long *oph_ptr, long *kph_ptr,
+                                    float *hph_ptr, float *T_ptr,
+                                    long iupfac, long idwnfac,
+                                    long *k0_ptr);
+
+        Description:
+        ~~~~~~~~~~~~
+
+        FIR-Filter (kernel) for rational resampling by iupfac/idwnfac.
+        The output samples are every idwnfac-th sample of the input
+        up-sampled by iupfac, so only these are computed: output sample
+        at the up-sampled time t = kx*iupfac + iph uses polyphase branch
+        iph and the input samples x[kx-kappa]. k0 holds the up-sampled
+        time of the next output sample, relative to the first input
+        sample of the segment, so segments of any length can be
+        processed in succession.
+
+        Parameters:
+        ~~~~~~~~~~~
+        lenx: .... (In)    length of input signal
+        x: ....... (In)    array with input samples
+        y: ....... (Out)   array with output samples
+        lenh0: ... (In)    number of  FIR-coefficients
+        nph: ..... (In)    number of non-zero FIR-coefficients per branch
+        oph: ..... (In)    index of the first coefficient of each branch
+        kph: ..... (In)    delays of the non-zero FIR-coefficients
+        hph: ..... (In)    non-zero FIR-coefficients
+        T: ....... (InOut) state variables
+        iupfac: .. (In)    upsampling factor
+        idwnfac: . (In)    downsampling factor
+        k0: ...... (InOut) up-sampled time of the next output sample
+
+        Return value:
+        ~~~~~~~~~~~~~
+        Number of filtered samples, at most ceil(lenx*iupfac/idwnfac).
+
+        History:
+        ~~~~~~~~
+        17.Oct.26 v1.0 Release of 1st version
+
+ ============================================================================
+*/
+static long     fir_resampling_kernel(lenx, x, y, lenh0, nph, oph, kph, hph,
+                                      T, iupfac, idwnfac, k0)
+  long            lenx;
+  float          *x, *y;
+  long            lenh0;
+  long           *nph, *oph, *kph;
+  float          *hph, *T;
+  long            iupfac, idwnfac;
+  long           *k0;
+{
+  long            lensub, ktrans, kx, ky, iph, kappa, j, t;
+  float          *Tx, *xp, *hp, acc;
+  long           *kp;
+
+
+  lensub = lenh0 / iupfac;
+
+  /* Append the first input samples to the delay line, so that
+   * Tx[kx - kappa] is valid for kx < ktrans and all kappa */
+  ktrans = (lensub - 1 > lenx) ? lenx : lensub - 1;
+  Tx = &T[lensub - 1];
+  for (kx = 0; kx < ktrans; kx++)
+    Tx[kx] = x[kx];
+
+  /* Output samples of the segment */
+  for (ky = 0, t = *k0; t < lenx * iupfac; t += idwnfac, ky++)
+  {
+    kx = t / iupfac;
+    iph = t - kx * iupfac;
+    xp = (kx < ktrans) ? &Tx[kx] : &x[kx];
+    kp = &kph[oph[iph]];
+    hp = &hph[oph[iph]];
+    acc = 0.0;
+    for (j = 0; j < nph[iph]; j++)
+      acc += xp[-kp[j]] * hp[j];
+    y[ky] = acc;
+  }
+  *k0 = t - lenx * iupfac;
+
+  /* Update of the delay line with the end of the x-array */
+  if (lenx >= lensub - 1)
+  {
+    for (kappa = 0; kappa <= lensub - 2; kappa++)
+      T[kappa] = x[lenx + 1 - lensub + kappa];
+  }
+  else
+  {
+    for (kappa = 0; kappa <= lensub - 2 - lenx; kappa++)
+      T[kappa] = T[kappa + lenx];
+    for (kappa = lensub - 1 - lenx; kappa <= lensub - 2; kappa++)
+      T[kappa] = x[lenx - 1 + kappa - (lensub - 2)];
+  }
+
+  return ky;
+}
+/* ................. End of fir_resampling_kernel() .................. */
+
+
+#ifdef FIR_FFT
+/*
+  ============================================================================
+
+        int fir_fft_tables (struct fir_coef *coef);
+        ~~~~~~~~~~~~~~~~~~
+
+        Description:
+        ~~~~~~~~~~~~
+
+        Decides whether a filter uses the FFT convolution, which is done
+        for the 1:1 filters with at least FIR_FFT_MIN_TAPS coefficients
+        when compiled with FIR_FFT, and builds its shared tables. The output is split as
+        y[k] = sum(h0[kappa]*x[k-kappa], kappa<P) + tail[k], where the
+        first sum is computed in direct form by the down-sampling kernel
+        from the first polyphase table entries, and tail[k] by uniformly
+        partitioned overlap-save: the coefficients h0[P..lenh0-1] are
+        split into K partitions of P coefficients, whose FFTs of size 2*P
+        are computed here. tail[k] only depends on x[k-P] and older
+        samples, so the contributions to a whole frame of P outputs are
+        known when the previous frame is complete; no delay is added.
+        The partition length, a power of 2 near sqrt(8*lenh0), gave the
+        shortest run times.
+
+        Parameters:
+        ~~~~~~~~~~~
+        coef: .... (InOut) shared tables, with the polyphase tables
+                           already built; K is left at 0 for the direct
+                           form
+
+        Return value:
+        ~~~~~~~~~~~~~
+        0 on success, -1 if the memory could not be allocated.
+
+        History:
+        ~~~~~~~~
+        17.Oct.26 v1.0 Release of 1st version (as fir_fft_init())
+        17.Oct.26 v1.1 Shared tables only, the state being allocated by
+                       fir_fft_init().
+        17.Oct.26 v1.2 One threshold for all the kernels; only compiled
+                       with FIR_FFT.
+
+ ============================================================================
+*/
+static int      fir_fft_tables(coef)
+  struct fir_coef *coef;
+{
+  struct fir_fft  fft;		/* for fir_rfft() */
+  double         *a, pi;
+  long            P, K, N, k, p, j, m;
+
+  /* Only long 1:1 filters */
+  if (coef->hswitch != 'D' || coef->dwn_up != 1
+      || coef->lenh0 < FIR_FFT_MIN_TAPS)
+    return 0;
+
+  /* Partition length, about sqrt(8*lenh0) */
+  for (P = 64; P * P < 8 * coef->lenh0 && 2 * P < coef->lenh0; P *= 2)
+    ;
+  N = 2 * P;
+  K = (coef->lenh0 - 1) / P;
+  if (K < 1)
+    return 0;			/* too short, keep the direct form */
+
+  /* Allocate the tables */
+  coef->rev = (long *) malloc(P * sizeof(long));
+  coef->wr = (double *) malloc((2 * P + K * (N + 2)) * sizeof(double));
+  if (coef->rev == (long *) 0 || coef->wr == (double *) 0)
+    return -1;			/* freed by fir_coef_free() */
+  fft.P = coef->P = P;
+  fft.rev = coef->rev;
+  fft.wr = coef->wr;
+  fft.wi = fft.wr + P;
+  fft.H = fft.wi + P;
+
+  /* Twiddle factors and bit-reversal permutation */
+  pi = 4.0 * atan(1.0);
+  for (k = 0; k < P; k++)
+  {
+    fft.wr[k] = cos(pi * k / P);
+    fft.wi[k] = sin(pi * k / P);
+  }
+  for (k = 0; k < P; k++)
+  {
+    for (j = 0, m = 1; m < P; m <<= 1)
+      j = (j << 1) | ((k & m) != 0);
+    fft.rev[k] = j;
+  }
+
+  /* Spectra of the partitions, with the scaling of the inverse FFT */
+  for (p = 0; p < K; p++)
+  {
+    a = &fft.H[p * (N + 2)];
+    for (k = 0; k < N; k++)
+      a[k] = (k < P && (p + 1) * P + k < coef->lenh0) ?
+	coef->h0[(p + 1) * P + k] / (double) N : 0.0;
+    fir_rfft(a, &fft);
+  }
+
+  /* Number of non-zero coefficients among the first P */
+  for (coef->nhead = 0; coef->nhead < coef->nph[0] &&
+       coef->kph[coef->nhead] < P; coef->nhead++)
+    ;
+
+  coef->K = K;
+  return 0;
+}
+/* ........................ End of fir_fft_tables() ....................... */
+
+
+/*
+  ============================================================================
+
+        int fir_fft_init (SCD_FIR *fir_ptr);
+        ~~~~~~~~~~~~~~~~
+
+        Description:
+        ~~~~~~~~~~~~
+
+        Allocates and clears the FFT convolution state of a filter whose
+        shared tables have K > 0 partitions (see fir_fft_tables()).
+
+        Parameters:
+        ~~~~~~~~~~~
+        fir_ptr: (InOut) pointer to struct SCD_FIR, with its shared
+                         tables set;
+
+        Return value:
+        ~~~~~~~~~~~~~
+        0 on success, -1 if the memory could not be allocated.
+
+        History:
+        ~~~~~~~~
+        17.Oct.26 v1.0 Release of 1st version
+        17.Oct.26 v1.1 The tables are shared, see fir_fft_tables().
+
+ ============================================================================
+*/
+static int      fir_fft_init(fir_ptr)
+  SCD_FIR        *fir_ptr;
+{
+  struct fir_coef *coef = fir_ptr->coef;
+  struct fir_fft *fft;
+  long            P, K, N;
+
+  P = coef->P;
+  K = coef->K;
+  N = 2 * P;
+
+  /* Allocate the struct and its arrays */
+  if ((fft = (struct fir_fft *) malloc(sizeof(struct fir_fft))) == NULL)
+    return -1;
+  fft->X = (double *) malloc((K * (N + 2) + (N + 2) + N + P) *
+			     sizeof(double));
+  if (fft->X == (double *) 0)
+  {
+    free(fft);
+    return -1;
+  }
+  fir_ptr->fft = fft;
+  fft->P = P;
+  fft->K = K;
+  fft->nhead = coef->nhead;
+  fft->rev = coef->rev;
+  fft->wr = coef->wr;
+  fft->wi = fft->wr + P;
+  fft->H = fft->wi + P;
+  fft->Y = fft->X + K * (N + 2);
+  fft->xin = fft->Y + N + 2;
+  fft->tail = fft->xin + N;
+
+  fir_fft_reset(fft);
+  return 0;
+}
+/* ......................... End of fir_fft_init() ........................ */
+#endif
+
+
+/*
+  ============================================================================
+
+        void fir_fft_reset (struct fir_fft *fft);
+        ~~~~~~~~~~~~~~~~~~
+
+        Description:
+        ~~~~~~~~~~~~
+
+        Clears the input frames, their spectra and the contributions of
+        the partitions, as for a signal preceded by zeros.
+
+        Parameters:
+        ~~~~~~~~~~~
+        fft: ..... (InOut) FFT convolution state
+
+        Return value:
+        ~~~~~~~~~~~~~
+        None.
+
+        History:
+        ~~~~~~~~
+        17.Oct.26 v1.0 Release of 1st version
+
+ ============================================================================
+*/
+static void     fir_fft_reset(fft)
+  struct fir_fft *fft;
+{
+  long            k;
+
+  for (k = 0; k < fft->K * (2 * fft->P + 2); k++)
+    fft->X[k] = 0.0;
+  for (k = 0; k < 2 * fft->P; k++)
+    fft->xin[k] = 0.0;
+  for (k = 0; k < fft->P; k++)
+    fft->tail[k] = 0.0;
+  fft->pos = 0;
+  fft->fdl = 0;
+}
+/* ........................ End of fir_fft_reset() ........................ */
+
+
+/*
+  ============================================================================
+
+        void fir_cfft (double *a, long n, long *rev, double *wr, double *wi,
+        ~~~~~~~~~~~~~  double isign);
+
+        Description:
+        ~~~~~~~~~~~~
+
+        In-place radix-2 FFT of n complex values, stored as real and
+        imaginary parts one after the other in a[0..2*n-1]. The forward
+        transform (isign = 1) uses exp(-2*pi*i*j*k/n), the inverse one
+        (isign = -1) exp(2*pi*i*j*k/n), without scaling.
+
+        Parameters:
+        ~~~~~~~~~~~
+        a: ....... (InOut) complex values
+        n: ....... (In)    number of complex values, a power of 2
+        rev: ..... (In)    bit-reversal permutation of n entries
+        wr, wi: .. (In)    cos(pi*k/n) and sin(pi*k/n), k < n
+        isign: ... (In)    1 for the forward, -1 for the inverse FFT
+
+        Return value:
+        ~~~~~~~~~~~~~
+        None.
+
+        History:
+        ~~~~~~~~
+        17.Oct.26 v1.0 Release of 1st version
+
+ ============================================================================
+*/
+static void     fir_cfft(a, n, rev, wr, wi, isign)
+  double         *a;
+  long            n;
+  long           *rev;
+  double         *wr, *wi;
+  double          isign;
+{
+  double          c, s, tr, ti, ur, ui, *u, *v;
+  long            len, half, step, i, j;
+
+  /* Bit-reversal permutation */
+  for (i = 0; i < n; i++)
+  {
+    j = rev[i];
+    if (i < j)
+    {
+      tr = a[2 * i];
+      ti = a[2 * i + 1];
+      a[2 * i] = a[2 * j];
+      a[2 * i + 1] = a[2 * j + 1];
+      a[2 * j] = tr;
+      a[2 * j + 1] = ti;
+    }
+  }
+
+  /* Butterflies */
+  for (len = 2; len <= n; len <<= 1)
+  {
+    half = len >> 1;
+    step = 2 * n / len;
+    for (i = 0; i < n; i += len)
+    {
+      u = &a[2 * i];
+      v = &a[2 * (i + half)];
+      for (j = 0; j < half; j++)
+      {
+	c = wr[j * step];
+	s = isign * wi[j * step];
+	ur = u[2 * j];
+	ui = u[2 * j + 1];
+	tr = v[2 * j] * c + v[2 * j + 1] * s;
+	ti = v[2 * j + 1] * c - v[2 * j] * s;
+	u[2 * j] = ur + tr;
+	u[2 * j + 1] = ui + ti;
+	v[2 * j] = ur - tr;
+	v[2 * j + 1] = ui - ti;
+      }
+    }
+  }
+}
+/* ........................... End of fir_cfft() .......................... */
+
+
+/*
+  ============================================================================
+
+        void fir_rfft (double *a, struct fir_fft *fft);
+        ~~~~~~~~~~~~~
+
+        Description:
+        ~~~~~~~~~~~~
+
+        In-place FFT of the 2*P real samples a[0..2*P-1]. They are
+        transformed as P complex values, whose FFT is then split into
+        the spectra of the even and odd samples. The result is the
+        spectrum at the frequencies 0..P, as real and imaginary parts in
+        a[0..2*P+1].
+
+        Parameters:
+        ~~~~~~~~~~~
+        a: ....... (InOut) real samples, then complex spectrum
+        fft: ..... (In)    FFT convolution state, for the tables
+
+        Return value:
+        ~~~~~~~~~~~~~
+        None.
+
+        History:
+        ~~~~~~~~
+        17.Oct.26 v1.0 Release of 1st version
+
+ ============================================================================
+*/
+static void     fir_rfft(a, fft)
+  double         *a;
+  struct fir_fft *fft;
+{
+  double          er, ei, odr, odi, tr, ti, c, s;
+  long            P, k;
+
+  P = fft->P;
+  fir_cfft(a, P, fft->rev, fft->wr, fft->wi, 1.0);
+
+  /* Frequencies 0 and P */
+  a[2 * P] = a[0] - a[1];
+  a[2 * P + 1] = 0.0;
+  a[0] = a[0] + a[1];
+  a[1] = 0.0;
+
+  /* Frequencies k and P-k, from the spectra of the even samples
+   * (e) and of the odd samples (o) */
+  for (k = 1; 2 * k <= P; k++)
+  {
+    er = 0.5 * (a[2 * k] + a[2 * (P - k)]);
+    ei = 0.5 * (a[2 * k + 1] - a[2 * (P - k) + 1]);
+    odr = 0.5 * (a[2 * k + 1] + a[2 * (P - k) + 1]);
+    odi = -0.5 * (a[2 * k] - a[2 * (P - k)]);
+    c = fft->wr[k];
+    s = fft->wi[k];
+    tr = odr * c + odi * s;
+    ti = odi * c - odr * s;
+    a[2 * k] = er + tr;
+    a[2 * k + 1] = ei + ti;
+    a[2 * (P - k)] = er - tr;
+    a[2 * (P - k) + 1] = ti - ei;
+  }
+}
+/* ........................... End of fir_rfft() .......................... */
+
+
+/*
+  ============================================================================
+
+        void fir_irfft (double *a, struct fir_fft *fft);
+        ~~~~~~~~~~~~~~
+
+        Description:
+        ~~~~~~~~~~~~
+
+        Inverse of fir_rfft(), scaled by 2*P: the spectrum at the
+        frequencies 0..P in a[0..2*P+1] gives 2*P times the real samples
+        in a[0..2*P-1].
+
+        Parameters:
+        ~~~~~~~~~~~
+        a: ....... (InOut) complex spectrum, then real samples
+        fft: ..... (In)    FFT convolution state, for the tables
+
+        Return value:
+        ~~~~~~~~~~~~~
+        None.
+
+        History:
+        ~~~~~~~~
+        17.Oct.26 v1.0 Release of 1st version
+
+ ============================================================================
+*/
+static void     fir_irfft(a, fft)
+  double         *a;
+  struct fir_fft *fft;
+{
+  double          er, ei, dr, di, odr, odi, c, s;
+  long            P, k;
+
+  P = fft->P;
+
+  /* Frequencies 0 and P */
+  er = a[0] + a[2 * P];
+  odr = a[0] - a[2 * P];
+  a[0] = er;
+  a[1] = odr;
+
+  /* Spectra of the even samples (e) and of the odd samples (o), times
+   * 2, combined as e + i*o */
+  for (k = 1; 2 * k <= P; k++)
+  {
+    er = a[2 * k] + a[2 * (P - k)];
+    ei = a[2 * k + 1] - a[2 * (P - k) + 1];
+    dr = a[2 * k] - a[2 * (P - k)];
+    di = a[2 * k + 1] + a[2 * (P - k) + 1];
+    c = fft->wr[k];
+    s = fft->wi[k];
+    odr = dr * c - di * s;
+    odi = di * c + dr * s;
+    a[2 * k] = er - odi;
+    a[2 * k + 1] = ei + odr;
+    a[2 * (P - k)] = er + odi;
+    a[2 * (P - k) + 1] = odr - ei;
+  }
+
+  fir_cfft(a, P, fft->rev, fft->wr, fft->wi, -1.0);
+}
+/* .......................... End of fir_irfft() .......................... */
+
+
+/*
+  ============================================================================
+
+        void fir_fft_frame (struct fir_fft *fft);
+        ~~~~~~~~~~~~~~~~~~
+
+        Description:
+        ~~~~~~~~~~~~
+
+        Called when an input frame is complete: stores the spectrum of
+        the last two frames as the newest entry of X[], and computes the
+        contributions of the K partitions to the outputs of the next
+        frame, i.e. the last P samples of the inverse FFT of the sum of
+        the products of the spectra of partition p and of the frame p
+        frames back, p = 0..K-1.
+
+        Parameters:
+        ~~~~~~~~~~~
+        fft: ..... (InOut) FFT convolution state
+
+        Return value:
+        ~~~~~~~~~~~~~
+        None.
+
+        History:
+        ~~~~~~~~
+        17.Oct.26 v1.0 Release of 1st version
+
+ ============================================================================
+*/
+static void     fir_fft_frame(fft)
+  struct fir_fft *fft;
+{
+  double         *x, *h, *y, xr, xi;
+  long            P, N, p, k;
+
+  P = fft->P;
+  N = 2 * P;
+
+  /* Spectrum of the last two frames */
+  fft->fdl = (fft->fdl + 1) % fft->K;
+  x = &fft->X[fft->fdl * (N + 2)];
+  for (k = 0; k < N; k++)
+    x[k] = fft->xin[k];
+  fir_rfft(x, fft);
+
+  /* Sum of the products of the spectra */
+  y = fft->Y;
+  for (k = 0; k < N + 2; k++)
+    y[k] = 0.0;
+  for (p = 0; p < fft->K; p++)
+  {
+    x = &fft->X[((fft->fdl + fft->K - p) % fft->K) * (N + 2)];
+    h = &fft->H[p * (N + 2)];
+    for (k = 0; k < N + 2; k += 2)
+    {
+      xr = x[k];
+      xi = x[k + 1];
+      y[k] += xr * h[k] - xi * h[k + 1];
+      y[k + 1] += xr * h[k + 1] + xi * h[k];
+    }
+  }
+
+  /* Contributions to the next frame, and shift of the input frames */
+  fir_irfft(y, fft);
+  for (k = 0; k < P; k++)
+  {
+    fft->tail[k] = y[P + k];
+    fft->xin[k] = fft->xin[P + k];
+  }
+}
+/* ........................ End of fir_fft_frame() ........................ */
+
+
+/*
+  ============================================================================
+
+        long fir_fft_kernel (long lenx, float *x_ptr, float *y_ptr,
+        ~~~~~~~~~~~~~~~~~~~  SCD_FIR *fir_ptr);
+
+        Description:
+        ~~~~~~~~~~~~
+
+        FIR-Filter (kernel) for long 1:1 filters: the first P
+        coefficients are applied by the down-sampling kernel, with the
+        first P-1 entries of the delay line; the contributions of the
+        other coefficients, computed frame by frame by fir_fft_frame(),
+        are then added. Any number of input samples can be processed
+        per call.
+
+        Parameters:
+        ~~~~~~~~~~~
+        lenx: .... (In)    length of input signal
+        x: ....... (In)    array with input samples
+        y: ....... (Out)   array with output samples
+        fir_ptr: . (InOut) pointer to struct SCD_FIR
+
+        Return value:
+        ~~~~~~~~~~~~~
+        Number of filtered samples.
+
+        History:
+        ~~~~~~~~
+        17.Oct.26 v1.0 Release of 1st version
+
+ ============================================================================
+*/
+static long     fir_fft_kernel(lenx, x, y, fir_ptr)
+  long            lenx;
+  float          *x;
+  float          *y;
+  SCD_FIR        *fir_ptr;
+{
+  struct fir_fft *fft = fir_ptr->fft;
+  long            k;
+
+  /* Direct form for the first P coefficients */
+  fir_downsampling_kernel(lenx, x, y, fft->P, &fft->nhead, fir_ptr->kph,
+			  fir_ptr->hph, fir_ptr->T, 1L, &fir_ptr->k0);
+
+  /* Contributions of the partitions */
+  for (k = 0; k < lenx; k++)
+  {
+    y[k] = (float) (y[k] + fft->tail[fft->pos]);
+    fft->xin[fft->P + fft->pos] = x[k];
+    if (++fft->pos == fft->P)
+    {
+      fir_fft_frame(fft);
+      fft->pos = 0;
+    }
+  }
+
+  return lenx;
+}
+/* ........................ End of fir_fft_kernel() ....................... */
 
 
 /* **************************** END OF FIR-LIB.C ************************** */
@@ -0,0 +1,294 @@
+/*                                                            17.Oct.2026 v1.0
+  =============================================================================
+
+                          U    U   GGG    SSSS  TTTTT
+                          U    U  G       S       T
+                          U    U  G  GG   SSSS    T
+                          U    U  G   G       S   T
+                           UUU     GG     SSS     T
+
+                   ========================================
+                    ITU-T - USER'S GROUP ON SOFTWARE TOOLS
+                   ========================================
+
+       =============================================================
+       COPYRIGHT NOTE: This source code, and all of its derivations,
+       is subject to the "ITU-T General Public License". Please have
+       it  read  in    the  distribution  disk,   or  in  the  ITU-T
+       Recommendation G.191 on "SOFTWARE TOOLS FOR SPEECH AND  AUDIO
+       CODING STANDARDS".
+       =============================================================
+
+MODULE:         FIRFLT, HIGH QUALITY FIR UP/DOWN-SAMPLING FILTER
+                Sub-unit: Rational resampler
+
+DESCRIPTION:
+        This file contains the initialization of the resampler by an
+	arbitrary rational factor up/down, e.g. 160/441 from 44.1 kHz to
+	16 kHz. Its low-pass filter is designed at initialization (Kaiser
+	windowed sinc) and stored as up polyphase branches, which are
+	used by the resampling kernel of fir-lib.c.
+
+FUNCTIONS:
+  Global (have prototype in firflt.h)
+         = hq_resample_init(...);
+
+  Local (should be used only here -- prototypes only in this file)
+         = fill_resampler(...): design of the low-pass filter;
+         = rs_bessel_i0(...):   modified Bessel function of order 0;
+
+HISTORY:
+    17.Oct.2026 v1.0 Release of 1st version
+
+  =============================================================================
+*/
+
+
+/*
+ * ......... INCLUDES .........
+ */
+#include <stdio.h>
+#include <stdlib.h>		/* General utility definitions */
+#include <math.h>
+
+#include "firflt.h"		/* Global definitions for FIR-FIR filter */
+
+
+/*
+ * ......... Design parameters .........
+ */
+#define RS_ZEROS    48		/* zero crossings of the sinc on each side,
+				 * at the lower of the two rates */
+#define RS_ROLLOFF  0.94	/* cut-off (-6 dB) relative to the lower of
+				 * the two Nyquist frequencies */
+#define RS_BETA     8.6		/* Kaiser window: pass-band within 0.01 dB
+				 * up to 0.89, at least 87 dB attenuation
+				 * from 1.0 on (same relative frequency) */
+
+
+/*
+ * ......... Local function prototypes .........
+ */
+void fill_resampler ARGS((long up, long down, float **h0, long *lenh0));
+static double rs_bessel_i0 ARGS((double x));
+
+
+/*
+ * ..... Private function prototypes defined in other sub-unit .....
+ */
+extern SCD_FIR *fir_initialization ARGS((long lenh0, float h0[], double gain,
+                                                 long idwnup, int hswitch));
+
+
+/*
+ * ...................... BEGIN OF FUNCTIONS .........................
+ */
+
+/*
+  ============================================================================
+
+        double rs_bessel_i0 (double x);
+        ~~~~~~~~~~~~~~~~~~~
+
+        Description:
+        ~~~~~~~~~~~~
+
+        Modified Bessel function of the first kind and order 0, by its
+        power series, for the Kaiser window.
+
+        Parameters:
+        ~~~~~~~~~~~
+        x: ....... (In) argument
+
+        Return value:
+        ~~~~~~~~~~~~~
+        I0(x).
+
+        History:
+        ~~~~~~~~
+        17.Oct.2026 v1.0 Release of 1st version
+
+ ============================================================================
+*/
+static double   rs_bessel_i0(x)
+  double          x;
+{
+  double          sum, term;
+  long            k;
+
+  sum = term = 1.0;
+  for (k = 1; term > 1e-12 * sum; k++)
+  {
+    term *= (x / (2.0 * k)) * (x / (2.0 * k));
+    sum += term;
+  }
+  return sum;
+}
+/* ......................... End of rs_bessel_i0() ........................ */
+
+
+/*
+  ============================================================================
+
+        void fill_resampler (long up, long down, float **h0, long *lenh0);
+        ~~~~~~~~~~~~~~~~~~~
+
+        Description:
+        ~~~~~~~~~~~~
+
+        Designs the low-pass filter of the resampler by up/down, at the
+        up-sampled rate: a sinc with cut-off RS_ROLLOFF times the lower
+        of the input and output Nyquist frequencies, i.e.
+        fc = RS_ROLLOFF/(2*max(up,down)) relative to the up-sampled rate,
+        spanning RS_ZEROS zero crossings on each side, with a Kaiser
+        window. The length is rounded up to a multiple of up, so that
+        all the polyphase branches have the same length. The
+        coefficients are normalized to a DC gain of 1.
+
+        Parameters:
+        ~~~~~~~~~~~
+        up: ...... (In)  up-sampling factor
+        down: .... (In)  down-sampling factor
+        h0: ...... (Out) pointer to the allocated array with the FIR
+                         coefficients, NULL if it can't be allocated
+        lenh0: ... (Out) pointer to number of coefficients
+
+        Return value:
+        ~~~~~~~~~~~~~
+        None.
+
+        History:
+        ~~~~~~~~
+        17.Oct.2026 v1.0 Release of 1st version
+
+ ============================================================================
+*/
+void            fill_resampler(up, down, h0, lenh0)
+  long            up, down;
+  float         **h0;
+  long           *lenh0;
+{
+  double          fc, c, t, w, sum, pi, i0beta;
+  double         *h;
+  long            lensub, k;
+
+  pi = 4.0 * atan(1.0);
+
+  /* Cut-off and length */
+  fc = RS_ROLLOFF / (2.0 * (up > down ? up : down));
+  lensub = (long) ceil(2.0 * RS_ZEROS / (2.0 * fc * up));
+  *lenh0 = lensub * up;
+
+  *h0 = (float *) malloc(*lenh0 * sizeof(float));
+  h = (double *) malloc(*lenh0 * sizeof(double));
+  if (*h0 == (float *) 0 || h == (double *) 0)
+  {
+    free(*h0);
+    free(h);
+    *h0 = (float *) 0;
+    return;
+  }
+
+  /* Kaiser windowed sinc, centered between the first and the last
+   * coefficient */
+  c = (*lenh0 - 1) / 2.0;
+  i0beta = rs_bessel_i0(RS_BETA);
+  for (sum = 0.0, k = 0; k < *lenh0; k++)
+  {
+    t = k - c;
+    w = 1.0 - (t / c) * (t / c);
+    w = rs_bessel_i0(RS_BETA * sqrt(w > 0.0 ? w : 0.0)) / i0beta;
+    h[k] = (t == 0.0) ? 2.0 * fc : sin(2.0 * pi * fc * t) / (pi * t);
+    h[k] *= w;
+    sum += h[k];
+  }
+
+  /* DC gain of 1 */
+  for (k = 0; k < *lenh0; k++)
+    (*h0)[k] = (float) (h[k] / sum);
+
+  free(h);
+}
+/* ....................... End of fill_resampler() ....................... */
+
+
+/*
+  ============================================================================
+
+        SCD_FIR *hq_resample_init (long up, long down);
+        ~~~~~~~~~~~~~~~~~~~~~~~~~
+
+        Description:
+        ~~~~~~~~~~~~
+
+        Initialization routine for the resampling by the rational factor
+        up/down, e.g. hq_resample_init(160, 441) from 44.1 kHz to 16 kHz.
+        The factors are first divided by their greatest common divisor,
+        so the sampling rates can be given directly, e.g.
+        hq_resample_init(16000, 44100). The filter is a linear-phase
+        low-pass (see fill_resampler()), flat within 0.01 dB up to 0.89
+        times the lower of the two Nyquist frequencies, with at least
+        87 dB attenuation from that Nyquist frequency on. Its delay is (lenh0-1)/(2*down)
+        output samples.
+
+        hq_kernel() returns about lseg*up/down output samples per call,
+        at most ceil(lseg*up/down), for any segment length lseg.
+
+        Parameters:
+        ~~~~~~~~~~~
+        up: ...... (In) up-sampling factor (or output sampling rate)
+        down: .... (In) down-sampling factor (or input sampling rate)
+
+        Return value:
+        ~~~~~~~~~~~~~
+        Returns a pointer to struct SCD_FIR, or NULL if the factors are
+        not positive or memory can't be allocated.
+
+        History:
+        ~~~~~~~~
+        17.Oct.2026 v1.0 Release of 1st version
+
+ ============================================================================
+*/
+SCD_FIR        *hq_resample_init(up, down)
+  long            up, down;
+{
+  SCD_FIR        *ptrFIR;
+  float          *h0;		/* pointer to array with FIR coeff. */
+  long            lenh0;	/* number of FIR coefficients */
+  long            a, b, r;
+
+
+  if (up < 1 || down < 1)
+    return 0;
+
+  /* Reduce the factors by their greatest common divisor */
+  for (a = up, b = down; b != 0; a = b, b = r)
+    r = a % b;
+  up /= a;
+  down /= a;
+
+  /* Design the low-pass filter */
+  fill_resampler(up, down, &h0, &lenh0);
+  if (h0 == (float *) 0)
+    return 0;
+
+  ptrFIR =
+    fir_initialization(		/* Returns: pointer to SCD_FIR-struct */
+		       lenh0,	/* In: number of FIR-coefficients */
+		       h0,	/* In: pointer to array with FIR-cof. */
+		       (double) up,	/* In: gain factor for FIR-coeffic. */
+		       up,	/* In: Up-sampling factor */
+		       'R'	/* In: switch to resampling procedure */
+    );
+  free(h0);
+
+  /* Store the down-sampling factor */
+  if (ptrFIR != (SCD_FIR *) 0)
+    ptrFIR->dwn = down;
+
+  return ptrFIR;
+}
+/* ...................... End of hq_resample_init() ...................... */
+
+/* ************************** END OF FIR-RSMP.C *************************** */
@@ -5,4 +5,5 @@
 #include "fir-lib.c"
 #include "fir-pso.c"
 #include "fir-LP.c"
+#include "fir-rsmp.c"
 /* end of firflt.c */
@@ -18,6 +18,15 @@
    15.May.07	v2.4+	Added protoype for the [20Hz-20kHz] filter 
 						and the 1.5kHz, 14kHz. 20kHz LP filters	<Ericsson>
    31.Dec.2008  v2.5    Added LP filters (12kHz) for fs=48kHz < huawei >
+   17.Oct.2026  v2.6    Added polyphase tables of the non-zero coefficients
+                        to SCD_FIR
+   17.Oct.2026  v2.7    Added state of the FFT convolution of long filters
+                        to SCD_FIR
+   17.Oct.2026  v2.8    Added rational resampler (hq_resample_init)
+   17.Oct.2026  v2.9    The coefficient tables of SCD_FIR are shared
+                        between filters (coef), added hq_free_tables
+   17.Oct.2026  v2.10   Removed hq_free_tables, the tables are freed with
+                        their last filter
 
   ============================================================================
 */
@@ -45,8 +54,22 @@ typedef struct {
         long  k0;                       /* start index in next segment       */
                                         /* (needed in segmentwise filtering) */
         float *h0;                      /* pointer to array with FIR coeff.  */
+                                        /* (h0, nph, kph, hph and oph are    */
+                                        /* shared and read-only)             */
         float *T;                       /* pointer to delay line             */
         char  hswitch;                  /* switch to FIR-kernel              */
+        long  *nph;                     /* no. of non-zero coefficients in   */
+                                        /* each polyphase branch             */
+        long  *kph;                     /* delays of the non-zero coeff.     */
+        float *hph;                     /* non-zero FIR coefficients, one    */
+                                        /* branch after the other            */
+        struct fir_fft *fft;            /* FFT convolution state of long     */
+                                        /* filters, NULL for the direct form */
+        long  *oph;                     /* index of the first coefficient of */
+                                        /* each branch in kph[] and hph[]    */
+        long  dwn;                      /* down-sampling factor following up-*/
+                                        /* sampling by dwn_up (hswitch 'R')  */
+        struct fir_coef *coef;          /* shared coefficient tables         */
 } SCD_FIR;
 
 
@@ -87,6 +110,7 @@ SCD_FIR *LP20_48kHz_init ARGS((void));
 // FILTER_12k48k_HW
 SCD_FIR *LP12_48kHz_init ARGS((void));
 // FILTER_12k48k_HW
+SCD_FIR *hq_resample_init ARGS((long up, long down));
 void hq_free ARGS((SCD_FIR *fir_ptr));
 void hq_reset ARGS((SCD_FIR *fir_ptr));
 
@@ -54,9 +54,9 @@ FLTR = $(RUN) filter -q
 # List of files (source and object)
 # ------------------------------------------------
 FIR_SRC = fir-dsm.c fir-flat.c fir-irs.c fir-lib.c fir-pso.c fir-tia.c \
-	fir-hirs.c fir-wb.c fir-msin.c fir-LP.c
+	fir-hirs.c fir-wb.c fir-msin.c fir-LP.c fir-rsmp.c
 FIR_OBJ = fir-dsm.obj fir-flat.obj fir-irs.obj fir-pso.obj fir-lib.obj \
-	fir-tia.obj fir-hirs.obj fir-wb.obj fir-msin.obj fir-LP.obj
+	fir-tia.obj fir-hirs.obj fir-wb.obj fir-msin.obj fir-LP.obj fir-rsmp.obj
 IIR_OBJ = iir-lib.obj iir-g712.obj iir-dir.obj iir-flat.obj
 
 # ------------------------------------------------
@@ -44,6 +44,8 @@ Options:
             (3 = previous frame repetition, a few zero_indeces in first good frame ,no decoder state reset)
             
 -byte       Use legacy nonG192 G.722 format (byte oriented) without frame/synch headers.
+-wmops_json f  (WMOPS builds) write the complexity summary to JSON file f
+-wmops_log f   (WMOPS builds) write the complexity of every frame to CSV file f
 -h/-help    print help message
 
 Original author:
@@ -185,7 +187,8 @@ void display_usage()
    P(("USAGE: \n"));
    P(("  decg722 [-options] file.adp file.outp \n"));
    P(("or \n"));
-   P(("  decg722 [-mode ] [-plc] [-fsize N] [-byte] [-frames N2] file.adp.g192 file.outp \n\n"));
+   P(("  decg722 [-mode ] [-plc] [-fsize N] [-byte] [-frames N2] file.adp.g192 file.outp \n"));
+   P(("  WMOPS builds: [-wmops_json file.json] [-wmops_log file.csv] \n\n"));
 
    exit(-128);
 }
@@ -241,6 +244,7 @@ char *argv[];
 #ifdef WMOPS
     short spe1Id = -1;
     short spe2Id = -1;
+    char  *wmops_json = NULL, *wmops_log = NULL;
 #endif
 
 #ifdef VMS
@@ -315,6 +319,22 @@ char *argv[];
             /* Move argv over the option to the next argument */
             argv+=2;
             argc-=2;
+#ifdef WMOPS
+         } else if (strcmp(argv[1], "-wmops_json") == 0 && argc > 2) {
+            /* complexity summary file */
+            wmops_json = argv[2];
+
+            /* Move argv over the option to the next argument */
+            argv+=2;
+            argc-=2;
+         } else if (strcmp(argv[1], "-wmops_log") == 0 && argc > 2) {
+            /* per-frame complexity file */
+            wmops_log = argv[2];
+
+            /* Move argv over the option to the next argument */
+            argv+=2;
+            argc-=2;
+#endif
          } else if (strcmp(argv[1], "-q") == 0) {
             /* Don't print progress indicator */
             quiet = 1;
@@ -381,6 +401,8 @@ char *argv[];
     spe2Id = getCounterId("received frame processing");
     setCounter(spe2Id);
     Init_WMOPS_counter();
+    if (wmops_log != NULL)
+        WMOPS_frame_log(wmops_log);
 #endif
 
    /* Read an analysis frame of bits from input bit stream file and decode */
@@ -602,6 +624,13 @@ char *argv[];
       }
    }
 
+#ifdef WMOPS
+   if (wmops_log != NULL)
+       WMOPS_frame_log(NULL);
+   if (wmops_json != NULL)
+       WMOPS_output_json(0, FileIn, wmops_json);
+#endif
+
    /* Close input and output files */
    fclose(F_out);
    fclose(F_cod);
@@ -42,6 +42,8 @@ Options:
 -mode   #   Operating mode (1,2,3) (or rate 64, 56, 48 in kbps) . Default is mode 1 (= 64 kbps)
 -frames #   number of frames to process (values -1 or 0 processes the whole file )
 -byte       Provide encoder output data in legacy byte oriented format (default is g192). 			   
+-wmops_json f  (WMOPS builds) write the complexity summary to JSON file f
+-wmops_log f   (WMOPS builds) write the complexity of every frame to CSV file f
 -h/-help    print help message
 
 Original author:
@@ -103,7 +105,8 @@ void display_usage()
 	/* Quit program */
 	P(("USAGE: encg722 file.inp file.adp (all binary files).\n"));
 	P(("or \n"));
-	P(("       encg722 [-mode #] [-byte] [-fsize N] [-frames N2]  file.inp file.adp.g192 \n\n"));
+	P(("       encg722 [-mode #] [-byte] [-fsize N] [-frames N2]  file.inp file.adp.g192 \n"));
+	P(("       WMOPS builds: [-wmops_json file.json] [-wmops_log file.csv] \n\n"));
 
 	exit(-128);
 }
@@ -159,6 +162,7 @@ char *argv[];
 
 #ifdef WMOPS
     short spe1Id = -1;
+    char  *wmops_json = NULL, *wmops_log = NULL;
 #endif
 
 	/* *** ......... PARAMETERS FOR PROCESSING ......... *** */
@@ -218,6 +222,21 @@ char *argv[];
 				argv+=2;
 				argc-=2;
 			} 
+#ifdef WMOPS
+			else if (strcmp(argv[1], "-wmops_json") == 0 && argc > 2){
+				/* complexity summary file */
+				wmops_json = argv[2];
+				/* Move argv over the option to the next argument */
+				argv+=2;
+				argc-=2;
+			} else if (strcmp(argv[1], "-wmops_log") == 0 && argc > 2){
+				/* per-frame complexity file */
+				wmops_log = argv[2];
+				/* Move argv over the option to the next argument */
+				argv+=2;
+				argc-=2;
+			}
+#endif
 			else if (strcmp(argv[1], "-q") == 0){
 				/* Don't print progress indicator */
 				quiet = 1;
@@ -265,6 +284,8 @@ char *argv[];
     spe1Id = getCounterId("encoding");
     setCounter(spe1Id);
     Init_WMOPS_counter();
+    if (wmops_log != NULL)
+        WMOPS_frame_log(wmops_log);
 #endif
 
 	/* Read one frame of samples from input file and process */
@@ -365,6 +386,10 @@ char *argv[];
       setCounter(spe1Id);
       fwc();
       WMOPS_output(0);
+      if (wmops_log != NULL)
+          WMOPS_frame_log(NULL);
+      if (wmops_json != NULL)
+          WMOPS_output_json(0, FileIn, wmops_json);
 #endif
 
 	/* Close input and output files */
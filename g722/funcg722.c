@@ -49,6 +49,7 @@ History:
 
 /* Include state variable definition, function and operator prototypes */
 #include "g722.h"
+#include "g722_tab.h"
 #ifdef __FXAPI__
 
 #include <basop32.h>
@@ -416,6 +417,202 @@ g722_state *s;
 /* ........................ End of lsbdec() ........................ */
 
 
+#ifndef WMOPS
+/* ************* Folded tables of the block low-band decoder ************** */
+/* Signed inverse quantizer outputs of invqbl() for 6, 5 and 4 bits, i.e.
+ * +/- shl(oqN[rilN[i]], 3), indexed directly by the (shifted) codeword */
+static Word16   dq6l[64] =
+  {
+    -136, -136, -136, -136, -24808, -21904, -19008, -16704,
+    -14984, -13512, -12280, -11192, -10232, -9360, -8576, -7856,
+    -7192, -6576, -6000, -5456, -4944, -4464, -4008, -3576,
+    -3168, -2776, -2400, -2032, -1688, -1360, -1040, -728,
+    24808, 21904, 19008, 16704, 14984, 13512, 12280, 11192,
+    10232, 9360, 8576, 7856, 7192, 6576, 6000, 5456,
+    4944, 4464, 4008, 3576, 3168, 2776, 2400, 2032,
+    1688, 1360, 1040, 728, 432, 136, -432, -136};
+static Word16   dq5l[32] =
+  {
+    -280, -280, -23352, -17560, -14120, -11664, -9752, -8184,
+    -6864, -5712, -4696, -3784, -2960, -2208, -1520, -880,
+    23352, 17560, 14120, 11664, 9752, 8184, 6864, 5712,
+    4696, 3784, 2960, 2208, 1520, 880, 280, -280};
+static Word16   dq4l[16] =
+  {
+    0, -20456, -12896, -8968, -6288, -4240, -2584, -1200,
+    20456, 12896, 8968, 6288, 4240, 2584, 1200, 0};
+/* Log scale factor increments of logscl(), wl[ril4[i]] */
+static Word16   wl4l[16] =
+  {
+    -60, 3042, 1198, 538, 334, 172, 58, -30,
+    3042, 1198, 538, 334, 172, 58, -30, -60};
+/* scalel() output for every nbpl >> 6 (nbpl is limited to 0..18432) */
+static Word16   scll[289] =
+  {
+    32, 32, 32, 32, 32, 32, 36, 36,
+    36, 36, 36, 40, 40, 40, 40, 44,
+    44, 44, 44, 48, 48, 48, 48, 52,
+    52, 52, 56, 56, 56, 56, 60, 60,
+    64, 64, 64, 68, 68, 68, 72, 72,
+    76, 76, 76, 80, 80, 84, 84, 88,
+    88, 92, 92, 96, 96, 100, 100, 104,
+    104, 108, 112, 112, 116, 116, 120, 124,
+    128, 128, 132, 136, 136, 140, 144, 148,
+    152, 152, 156, 160, 164, 168, 172, 176,
+    180, 184, 188, 192, 196, 200, 204, 208,
+    212, 220, 224, 228, 232, 236, 244, 248,
+    256, 260, 264, 272, 276, 284, 288, 296,
+    304, 308, 316, 324, 332, 336, 344, 352,
+    360, 368, 376, 384, 392, 400, 412, 420,
+    428, 440, 448, 456, 468, 476, 488, 500,
+    512, 520, 532, 544, 556, 568, 580, 592,
+    608, 620, 632, 648, 664, 676, 692, 708,
+    724, 740, 756, 772, 788, 804, 824, 840,
+    860, 880, 896, 916, 936, 956, 980, 1000,
+    1024, 1044, 1068, 1092, 1116, 1140, 1164, 1188,
+    1216, 1244, 1268, 1296, 1328, 1356, 1384, 1416,
+    1448, 1480, 1512, 1544, 1576, 1612, 1648, 1684,
+    1720, 1760, 1796, 1836, 1876, 1916, 1960, 2004,
+    2048, 2092, 2136, 2184, 2232, 2280, 2332, 2380,
+    2432, 2488, 2540, 2596, 2656, 2712, 2772, 2832,
+    2896, 2960, 3024, 3088, 3156, 3228, 3296, 3368,
+    3444, 3520, 3596, 3676, 3756, 3836, 3920, 4008,
+    4096, 4184, 4276, 4372, 4464, 4564, 4664, 4764,
+    4868, 4976, 5084, 5196, 5312, 5428, 5548, 5668,
+    5792, 5920, 6048, 6180, 6316, 6456, 6596, 6740,
+    6888, 7040, 7192, 7352, 7512, 7676, 7844, 8016,
+    8192, 8372, 8556, 8744, 8932, 9128, 9328, 9532,
+    9740, 9956, 10172, 10396, 10624, 10856, 11096, 11336,
+    11584, 11840, 12100, 12364, 12632, 12912, 13192, 13484,
+    13776, 14080, 14388, 14704, 15024, 15352, 15688, 16032,
+    16384};
+/* ******************** End of folded low-band tables ********************* */
+#endif
+
+
+/*___________________________________________________________________________
+                                                                            
+    Function Name : lsbdec_block                                            
+                                                                            
+    Purpose :                                                               
+                                                                            
+     Decode n lower-subband codewords with a kernel specialized for the     
+     operation mode. The mode is resolved once per call; the kernels use    
+     the folded tables above in place of invqbl(), invqal(), logscl() and   
+     scalel(). The result is bit-exact with n calls of lsbdec() (rs = 0).   
+     WMOPS builds keep the per-sample lsbdec() path so that the complexity  
+     figures are those of the reference decoder.                            
+                                                                            
+    Inputs :                                                                
+      ilr  - ADPCM encodings of the low sub-band (6 bits each)              
+      n    - number of codewords                                            
+      mode - G.722 operation mode                                           
+      s    - pointer to state variable (read/write)                         
+                                                                            
+    Outputs :                                                               
+      rl   - decoded low-band samples                                       
+                                                                            
+    Return Value :                                                          
+      None.                                                                 
+ ___________________________________________________________________________
+*/
+#define AL   s->al
+#define BL   s->bl
+#define DETL s->detl
+#define DLT  s->dlt
+#define NBL  s->nbl
+#define PLT  s->plt
+#define RLT  s->rlt
+#define SL   s->sl
+#define SPL  s->spl
+#define SZL  s->szl
+
+/* Instantiate one kernel: dqtab is the inverse quantizer of the mode and
+ * shift the number of codeword LSBs it ignores */
+#define LSBDEC_KERNEL(name, dqtab, shift)                                   \
+static void                                                                 \
+name (ilr, rl, n, s)                                                        \
+Word16 *ilr;                                                                \
+Word16 *rl;                                                                 \
+Word16 n;                                                                   \
+g722_state *s;                                                              \
+{                                                                           \
+  Word16          j, il4, nbpl;                                             \
+                                                                            \
+  for (j = 0; j < n; j++)                                                   \
+  {                                                                         \
+    il4 = shr (ilr[j], 2);                                                  \
+    rl[j] = limit (add (SL, mult (DETL, dqtab[shr (ilr[j], shift)])));      \
+    DLT[0] = mult (DETL, dq4l[il4]);                                        \
+    nbpl = add (mult (NBL, 32512), wl4l[il4]);                              \
+    if (nbpl < 0)                                                           \
+      nbpl = 0;                                                             \
+    if (sub (nbpl, 18432) > 0)                                              \
+      nbpl = 18432;                                                         \
+    NBL = nbpl;                                                             \
+    DETL = scll[shr (nbpl, 6)];                                             \
+    PLT[0] = add (DLT[0], SZL);   /* parrec */                              \
+    RLT[0] = add (SL, DLT[0]);    /* recons */                              \
+    upzero (DLT, BL);                                                       \
+    uppol2 (AL, PLT);                                                       \
+    uppol1 (AL, PLT);                                                       \
+    SZL = filtez (DLT, BL);                                                 \
+    SPL = filtep (RLT, AL);                                                 \
+    SL = add (SPL, SZL);          /* predic */                              \
+  }                                                                         \
+}
+
+#ifndef WMOPS
+LSBDEC_KERNEL (lsbdec_64k, dq6l, 0)   /* mode 1: 6-bit inverse quantizer */
+LSBDEC_KERNEL (lsbdec_56k, dq5l, 1)   /* mode 2: 5-bit inverse quantizer */
+LSBDEC_KERNEL (lsbdec_48k, dq4l, 2)   /* mode 3: 4-bit inverse quantizer */
+#endif
+
+void
+lsbdec_block (ilr, rl, n, mode, s)
+Word16 *ilr;
+Word16 *rl;
+Word16 n;
+Word16 mode;
+g722_state *s;
+{
+#ifdef WMOPS
+  Word16          j;
+
+  FOR (j = 0; j < n; j++)
+  {
+    rl[j] = lsbdec (ilr[j], mode, 0, s);
+  }
+#else
+  switch (mode)
+  {
+  case 0:
+  case 1:
+    lsbdec_64k (ilr, rl, n, s);
+    break;
+  case 2:
+    lsbdec_56k (ilr, rl, n, s);
+    break;
+  default:                        /* default to mode 3, as invqbl() */
+    lsbdec_48k (ilr, rl, n, s);
+    break;
+  }
+#endif
+}
+#undef LSBDEC_KERNEL
+#undef AL
+#undef BL
+#undef DETL
+#undef DLT
+#undef NBL
+#undef PLT
+#undef RLT
+#undef SL
+#undef SPL
+#undef SZL
+/* ..................... End of lsbdec_block() ..................... */
+
+
 /*___________________________________________________________________________
                                                                             
     Function Name : hsbdec                                                  
@@ -569,6 +766,19 @@ Word16 detl;
      0x0026, 0x0025, 0x0024, 0x0023, 0x0022, 0x0021, 0x0020, 0x0000}
   };
 
+#ifdef G722_FAST_QUANTL
+ /* q6[] pre-shifted by 3 and padded to 32 entries with the last level,
+    for the binary search */
+  static Word16   q6s[32] =
+  {
+    0 * 8, 35 * 8, 72 * 8, 110 * 8, 150 * 8, 190 * 8, 233 * 8, 276 * 8,
+    323 * 8, 370 * 8, 422 * 8, 473 * 8, 530 * 8, 587 * 8, 650 * 8, 714 * 8,
+    786 * 8, 858 * 8, 940 * 8, 1023 * 8, 1121 * 8, 1219 * 8, 1339 * 8,
+    1458 * 8, 1612 * 8, 1765 * 8, 1980 * 8, 2195 * 8, 2557 * 8, 2919 * 8,
+    3200 * 8, 3200 * 8
+  };
+  Word16          step;
+#else
  /* 6 levels quantizer level od decision */
   static Word16   q6[31] =
   {
@@ -577,8 +787,7 @@ Word16 detl;
     786, 858, 940, 1023, 1121, 1219, 1339, 1458,
     1612, 1765, 1980, 2195, 2557, 2919, 3200
   };
-
-
+#endif
 
   Word16          sil, mil, wd, val;
 
@@ -596,6 +805,22 @@ Word16 detl;
 #ifdef WMOPS
     move16();
 #endif
+#ifdef G722_FAST_QUANTL
+  /* The decision levels mult(q6[i]<<3, detl) are non-decreasing in i, so
+   * mil (the number of levels not above wd, at most 30) is found by a
+   * 5-step binary search over q6s[] instead of the linear scan below.
+   * It always takes 5 comparisons instead of up to 31 (each one still
+   * branches on the data) and is bit-exact with the linear scan. */
+  FOR (step = 16; step > 0; step = shr(step, 1))
+  {
+    val = mult (q6s[add(mil, step) - 1], detl);
+    if (sub(val, wd) <= 0)
+    {
+      mil = add(mil, step);
+    }
+  }
+  mil = s_min(mil, 30);
+#else
   val = mult (shl(q6[mil], 3), detl);
   WHILE (sub(val,wd) <= 0)
   {
@@ -609,6 +834,7 @@ Word16 detl;
       val = mult (shl(q6[mil],3), detl);
     }
   }
+#endif
 
   sil = add(sil,1);
 #ifdef WMOPS
@@ -1173,7 +1399,7 @@ Word16 nbl;
 
 
 /* ************** Table ILA used by scalel and scaleh ******************** */
-static Word16   ila[353] =
+Word16          g722_ila[353] =
   {
     1, 1, 1, 1, 1, 1, 1, 1,
     1, 1, 1, 1, 1, 1, 1, 1,
@@ -1250,7 +1476,7 @@ Word16 nbpl;
 
   wd1 = s_and(shr(nbpl, 6), 511);
   wd2 = add(wd1, 64);
-  return (shl(add(ila[wd2], 1), 2));
+  return (shl(add(g722_ila[wd2], 1), 2));
 }
 /* ..................... End of scalel() ..................... */
 
@@ -1282,7 +1508,7 @@ Word16 nbph;
 
   wd = s_and(shr(nbph, 6), 511);
 
-  return (shl(add(ila[wd], 1), 2));
+  return (shl(add(g722_ila[wd], 1), 2));
 }
 /* ..................... End of scaleh() ..................... */
 
@@ -1495,13 +1721,13 @@ Word16 bl [];
 
 
 /* **** Coefficients for both transmission and reception QMF **** */
-static Word16   coef_qmf[24] =
+Word16          g722_coef_qmf[24] =
   {
     3 * 2, -11 * 2, -11 * 2, 53 * 2, 12 * 2, -156 * 2,
     32 * 2, 362 * 2, -210 * 2, -805 * 2, 951 * 2, 3876 * 2,
     3876 * 2, 951 * 2, -805 * 2, -210 * 2, 362 * 2, 32 * 2,
     -156 * 2, 12 * 2, 53 * 2, -11 * 2, -11 * 2, 3 * 2};
-/* ..................... End of table coef_qmf[] ..................... */
+/* .................. End of table g722_coef_qmf[] .................. */
 
 
 /*___________________________________________________________________________
@@ -1511,7 +1737,7 @@ static Word16   coef_qmf[24] =
     Purpose :                                                               
                                                                             
      G722 QMF analysis (encoder) filter. Uses coefficients in array         
-     coef_qmf[] defined above.                                              
+     g722_coef_qmf[] defined above.                                         
                                                                             
     Inputs :                                                                
      xin0 - first sample for the QMF filter (read-only)                     
@@ -1524,14 +1750,13 @@ static Word16   coef_qmf[24] =
      None.                                                                  
  ___________________________________________________________________________
 */
-#define delayx s->qmf_tx_delayx
-void 
-qmf_tx (xin0, xin1, xl, xh, s)
+static void 
+qmf_tx_dly (xin0, xin1, xl, xh, delayx)
 Word16 xin0;
 Word16 xin1;
 Word16 *xl;
 Word16 *xh;
-g722_state *s;
+Word16 *delayx;
 {
 
   /* Local variables */
@@ -1549,7 +1774,7 @@ g722_state *s;
 #endif
 
   /* QMF filtering */
-  pcoef = coef_qmf;
+  pcoef = g722_coef_qmf;
   pdelayx = delayx;
 #ifdef WMOPS
   move16();
@@ -1579,7 +1804,17 @@ g722_state *s;
   *xl = limit ((Word16) L_shr (comp_low, (Word16) 16));
   *xh = limit ((Word16) L_shr (comp_high, (Word16) 16));
 }
-#undef delayx
+
+void 
+qmf_tx (xin0, xin1, xl, xh, s)
+Word16 xin0;
+Word16 xin1;
+Word16 *xl;
+Word16 *xh;
+g722_state *s;
+{
+  qmf_tx_dly (xin0, xin1, xl, xh, s->qmf_tx_delayx);
+}
 /* ..................... End of qmf_tx() ..................... */
 
 
@@ -1588,7 +1823,7 @@ g722_state *s;
     Function Name : qmf_rx                                                  
                                                                             
      G722 QMF synthesis (decoder) filter. Uses coefficients in array        
-     coef_qmf[] defined above.                                              
+     g722_coef_qmf[] defined above.                                         
                                                                             
     Inputs :                                                                
      xout0 - first sample out of the QMF filter (write-only)                
@@ -1601,14 +1836,13 @@ g722_state *s;
      None.                                                                  
  ___________________________________________________________________________
 */
-#define delayx s->qmf_rx_delayx
-void 
-qmf_rx (rl, rh, xout1, xout2, s)
+static void 
+qmf_rx_dly (rl, rh, xout1, xout2, delayx)
 Word16 rl;
 Word16 rh;
 Word16 *xout1;
 Word16 *xout2;
-g722_state *s;
+Word16 *delayx;
 {
   Word16             i;
   Word32          accuma, accumb;
@@ -1625,7 +1859,7 @@ g722_state *s;
 #endif
 
   /* qmf_rx filtering */
-  pcoef = coef_qmf;
+  pcoef = g722_coef_qmf;
   pdelayx = delayx;
 #ifdef WMOPS
   move16();
@@ -1655,7 +1889,227 @@ g722_state *s;
   *xout2 = extract_h(comp_high);
 }
 
-#undef delayx
+void 
+qmf_rx (rl, rh, xout1, xout2, s)
+Word16 rl;
+Word16 rh;
+Word16 *xout1;
+Word16 *xout2;
+g722_state *s;
+{
+  qmf_rx_dly (rl, rh, xout1, xout2, s->qmf_rx_delayx);
+}
 /* ..................... End of qmf_rx() ..................... */
 
+/*___________________________________________________________________________
+                                                                            
+    Function Name : qmf_tx_block                                            
+                                                                            
+    Purpose :                                                               
+                                                                            
+     Block version of qmf_tx(): filters n sample pairs at once. The 22     
+     past samples of the delay line and the new input are laid out in     
+     time order in one contiguous buffer, so the 24-tap MACs run over     
+     plain forward pointers and the delay line is not shifted per pair.   
+     The delay line left is the same as after n calls of qmf_tx(), so     
+     both versions can be mixed. In WMOPS builds the per-sample qmf_tx()  
+     filter is used instead, so that its basic operators are counted.      
+                                                                            
+    Inputs :                                                                
+     xin  - 2*n input samples in time order (read-only)                     
+     xl   - n lower band samples (write-only)                               
+     xh   - n higher band samples (write-only)                              
+     n    - number of sample pairs                                          
+     delayx - QMF delay line of the encoder state, e.g. s->qmf_tx_delayx   
+              (read/write)                                                  
+                                                                            
+    Return Value :                                                          
+     None.                                                                  
+ ___________________________________________________________________________
+*/
+void 
+qmf_tx_block (xin, xl, xh, n, delayx)
+Word16 *xin;
+Word16 *xl;
+Word16 *xh;
+Word16 n;
+Word16 *delayx;
+{
+#ifdef WMOPS
+  Word16          j;
+
+  FOR (j = 0; j < n; j++)
+  {
+    qmf_tx_dly (xin[1], xin[0], &xl[j], &xh[j], delayx);
+    move16();
+    move16();
+    xin += 2;
+  }
+#else
+  Word16          buf[22 + 2 * G722_QMF_BLK];
+  Word16          i, j, m, len;
+  Word32          accuma, accumb;
+  Word32          comp_low, comp_high;
+  Word16          *q;
+
+  /* Past samples, oldest first */
+  FOR (i = 0; i < 22; i++)
+  {
+    buf[i] = delayx[23 - i];
+  }
+
+  FOR (j = 0; j < n; j += m)
+  {
+    m = s_min(sub(n, j), G722_QMF_BLK);
+    len = shl(m, 1);
+    FOR (i = 0; i < len; i++)
+    {
+      buf[22 + i] = *xin++;
+    }
+
+    /* QMF filtering. g722_coef_qmf[] is symmetric, so with the samples in
+     * time order the even taps still go to accumb and the odd ones to
+     * accuma. Neither sum can exceed 2^30, so the L_mac0() chain of
+     * qmf_tx() never saturates and a plain C MAC is bit-exact. */
+    FOR (i = 0; i < m; i++)
+    {
+      q = buf + 2 * i;
+      accuma = 0;
+      accumb = 0;
+      for (len = 0; len < 24; len += 2)
+      {
+        accumb += (Word32) g722_coef_qmf[len] * q[len];
+        accuma += (Word32) g722_coef_qmf[len + 1] * q[len + 1];
+      }
+      comp_low = L_add (accuma, accumb);
+      comp_low = L_add (comp_low, comp_low);
+      comp_high = L_sub (accuma, accumb);
+      comp_high = L_add (comp_high, comp_high);
+      *xl++ = limit ((Word16) L_shr (comp_low, (Word16) 16));
+      *xh++ = limit ((Word16) L_shr (comp_high, (Word16) 16));
+    }
+
+    /* Keep the last 22 samples as history for the next block */
+    len = shl(m, 1);
+    FOR (i = 0; i < 22; i++)
+    {
+      buf[i] = buf[len + i];
+    }
+  }
+
+  /* Write back the delay line as qmf_tx() would have left it */
+  FOR (i = 0; i < 22; i++)
+  {
+    delayx[23 - i] = buf[i];
+  }
+  IF (n > 0)
+  {
+    delayx[0] = buf[21];
+    delayx[1] = buf[20];
+  }
+#endif
+}
+/* ..................... End of qmf_tx_block() ..................... */
+
+
+/*___________________________________________________________________________
+                                                                            
+    Function Name : qmf_rx_block                                            
+                                                                            
+    Purpose :                                                               
+                                                                            
+     Block version of qmf_rx(): synthesizes n sample pairs at once, using  
+     the same contiguous time-ordered buffer as qmf_tx_block(). The delay  
+     line left is the same as after n calls of qmf_rx(). In WMOPS builds  
+     the per-sample qmf_rx() filter is used, as in qmf_tx_block().       
+                                                                            
+    Inputs :                                                                
+     rl   - n lower band samples (read-only)                                
+     rh   - n higher band samples (read-only)                               
+     xout - 2*n output samples in time order (write-only)                   
+     n    - number of sample pairs                                          
+     delayx - QMF delay line of the decoder state, e.g. s->qmf_rx_delayx   
+              (read/write)                                                  
+                                                                            
+    Return Value :                                                          
+     None.                                                                  
+ ___________________________________________________________________________
+*/
+void 
+qmf_rx_block (rl, rh, xout, n, delayx)
+Word16 *rl;
+Word16 *rh;
+Word16 *xout;
+Word16 n;
+Word16 *delayx;
+{
+#ifdef WMOPS
+  Word16          j;
+
+  FOR (j = 0; j < n; j++)
+  {
+    qmf_rx_dly (rl[j], rh[j], &xout[0], &xout[1], delayx);
+    xout += 2;
+  }
+#else
+  Word16          buf[22 + 2 * G722_QMF_BLK];
+  Word16          i, j, m, len;
+  Word32          accuma, accumb;
+  Word16          *q;
+
+  /* Past samples, oldest first */
+  FOR (i = 0; i < 22; i++)
+  {
+    buf[i] = delayx[23 - i];
+  }
+
+  FOR (j = 0; j < n; j += m)
+  {
+    m = s_min(sub(n, j), G722_QMF_BLK);
+
+    /* compute sum and difference from lower-band (rl) and higher-band 
+       (rh) signals */
+    FOR (i = 0; i < m; i++)
+    {
+      buf[22 + 2 * i] = add (*rl, *rh);
+      buf[23 + 2 * i] = sub (*rl++, *rh++);
+    }
+
+    /* qmf_rx filtering, see qmf_tx_block() for the tap ordering */
+    FOR (i = 0; i < m; i++)
+    {
+      q = buf + 2 * i;
+      accuma = 0;
+      accumb = 0;
+      for (len = 0; len < 24; len += 2)
+      {
+        accumb += (Word32) g722_coef_qmf[len] * q[len];
+        accuma += (Word32) g722_coef_qmf[len + 1] * q[len + 1];
+      }
+      *xout++ = extract_h (L_shl (accuma, 4));
+      *xout++ = extract_h (L_shl (accumb, 4));
+    }
+
+    /* Keep the last 22 samples as history for the next block */
+    len = shl(m, 1);
+    FOR (i = 0; i < 22; i++)
+    {
+      buf[i] = buf[len + i];
+    }
+  }
+
+  /* Write back the delay line as qmf_rx() would have left it */
+  FOR (i = 0; i < 22; i++)
+  {
+    delayx[23 - i] = buf[i];
+  }
+  IF (n > 0)
+  {
+    delayx[0] = buf[21];
+    delayx[1] = buf[20];
+  }
+#endif
+}
+/* ..................... End of qmf_rx_block() ..................... */
+
 /* ******************** End of funcg722.c ***************************** */
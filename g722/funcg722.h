@@ -88,6 +88,8 @@ Word16 lsbcod ARGS((Word16 xl, Word16 rs, g722_state *s));
 Word16 hsbcod ARGS((Word16 xh, Word16 rs, g722_state *s));
 Word16 lsbdec ARGS((Word16 ilr, Word16 mode, Word16 rs, g722_state *s));
 Word16 hsbdec ARGS((Word16 ih, Word16 rs, g722_state *s));
+void lsbdec_block ARGS((Word16 *ilr, Word16 *rl, Word16 n, Word16 mode,
+                        g722_state *s));
 Word16 quantl ARGS((Word16 el, Word16 detl));
 Word16 quanth ARGS((Word16 eh, Word16 deth));
 Word16 filtep ARGS((Word16 rlt [], Word16 al []));
@@ -108,5 +110,14 @@ void qmf_tx ARGS((Word16 xin0, Word16 xin1, Word16 *xl, Word16 *xh,
 void qmf_rx ARGS((Word16 rl, Word16 rh, Word16 *xout1, Word16 *xout2, 
 		  g722_state *s));
 
+/* Block QMF: number of sample pairs filtered per internal chunk */
+#ifndef G722_QMF_BLK
+#define G722_QMF_BLK 80
+#endif
+void qmf_tx_block ARGS((Word16 *xin, Word16 *xl, Word16 *xh, Word16 n,
+		  Word16 *delayx));
+void qmf_rx_block ARGS((Word16 *rl, Word16 *rh, Word16 *xout, Word16 n,
+		  Word16 *delayx));
+
 #endif /* FUNCG722_H */
 /* ........................ End of file funcg722.h ......................... */
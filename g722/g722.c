@@ -41,6 +41,9 @@ History:
                       <{balazs.kovesi,stephane.ragot}@orange-ftgroup.com>
   ============================================================================
 */
+#include <stddef.h>
+#include <string.h>
+
 #include "g722.h"
 #include "stl.h"
 
@@ -69,20 +72,22 @@ g722_state *encoder;
 /* .................... end of g722_reset_encoder() ....................... */
 
 
-Word32 g722_encode(incode,code,read1,encoder)
+/* Encoder loop shared by g722_encode() and g722_enc_encode(): encoder is
+ * the ADPCM part of the state and delayx its QMF delay line */
+static Word32 g722_encode_state(incode,code,read1,encoder,delayx)
   short *incode;
   short *code;
   Word32 read1;
   g722_state     *encoder;
+  Word16         *delayx;
 {
   /* Encoder variables */
-  Word16          xl, il;
-  Word16          xh, ih;
-  Word16          xin0, xin1;
+  Word16          xl[G722_QMF_BLK], il;
+  Word16          xh[G722_QMF_BLK], ih;
 
   /* Auxiliary variables */
   Word32             i;
-  Word16          *p_incode;
+  Word16          j, m;
 #ifdef __FXAPI__
   fx_init_dsp_mode();
 #endif
@@ -90,38 +95,44 @@ Word32 g722_encode(incode,code,read1,encoder)
   read1 = L_shr(read1, 1);
 
   /* Main loop - never reset */
-	p_incode = incode;
-#ifdef WMOPS
-    move16();
-#endif
-  FOR (i = 0; i < read1; i++)
+  FOR (i = 0; i < read1; i += m)
   {
-    xin1 = *incode++;
-    xin0 = *incode++;
-#ifdef WMOPS
-    move16();
-    move16();
-#endif
+    m = extract_l(L_min(L_sub(read1, i), G722_QMF_BLK));
 
-    /* Calculation of the synthesis QMF samples */
-    qmf_tx (xin0, xin1, &xl, &xh, encoder);
+    /* Calculation of the synthesis QMF samples for the whole block */
+    qmf_tx_block (incode, xl, xh, m, delayx);
+    incode += shl(m, 1);
 
-    /* Call the upper and lower band ADPCM encoders */
-    il = lsbcod (xl, 0, encoder);
-    ih = hsbcod (xh, 0, encoder);
+    FOR (j = 0; j < m; j++)
+    {
+      /* Call the upper and lower band ADPCM encoders */
+      il = lsbcod (xl[j], 0, encoder);
+      ih = hsbcod (xh[j], 0, encoder);
 
-    /* Mount the output G722 codeword: bits 0 to 5 are the lower-band
-     * portion of the encoding, and bits 6 and 7 are the upper-band
-     * portion of the encoding */
-    code[i] = s_and(add(shl(ih, 6), il), 0xFF);
+      /* Mount the output G722 codeword: bits 0 to 5 are the lower-band
+       * portion of the encoding, and bits 6 and 7 are the upper-band
+       * portion of the encoding */
+      code[i + j] = s_and(add(shl(ih, 6), il), 0xFF);
 #ifdef WMOPS
-    move16();
+      move16();
 #endif
+    }
   }
 
   /* Return number of samples read */
   return(read1);
 }
+
+
+Word32 g722_encode(incode,code,read1,encoder)
+  short *incode;
+  short *code;
+  Word32 read1;
+  g722_state     *encoder;
+{
+  return(g722_encode_state(incode, code, read1, encoder,
+                           encoder->qmf_tx_delayx));
+}
 /* .................... end of g722_encode() .......................... */
 
 
@@ -150,50 +161,225 @@ g722_state *decoder;
 /* .................... end of g722_reset_decoder() ....................... */
 
 
-short g722_decode(code,outcode,mode,read1,decoder)
+/* Decoder loop shared by g722_decode() and g722_dec_decode(): decoder is
+ * the ADPCM part of the state and delayx its QMF delay line */
+static void g722_decode_state(code,outcode,mode,read1,decoder,delayx)
   short *code;
   short *outcode;
   short mode;
-  short read1;
+  Word32 read1;
   g722_state     *decoder;
+  Word16         *delayx;
 {
   /* Decoder variables */
-  Word16          il, ih;
-  Word16          rl, rh;
-  Word16          xout1, xout2;
+  Word16          il[G722_QMF_BLK], ih;
+  Word16          rl[G722_QMF_BLK], rh[G722_QMF_BLK];
     
   /* Auxiliary variables */
-  short             i;  
+  Word32            i;  
+  Word16          j, m;
 #ifdef __FXAPI__
   fx_init_dsp_mode();
 #endif  
   /* Decode - reset is never applied here */
-  FOR (i = 0; i < read1; i++)
+  FOR (i = 0; i < read1; i += m)
   {
-    /* Separate the input G722 codeword: bits 0 to 5 are the lower-band
-     * portion of the encoding, and bits 6 and 7 are the upper-band
-     * portion of the encoding */
-    il = s_and(code[i], 0x3F);	/* 6 bits of low SB */
-    ih = s_and(lshr(code[i], 6), 0x03);/* 2 bits of high SB */
-
-    /* Call the upper and lower band ADPCM decoders */
-    rl = lsbdec (il, mode, 0, decoder);
-    rh = hsbdec (ih, 0, decoder);
-      
-    /* Calculation of output samples from QMF filter */
-    qmf_rx (rl, rh, &xout1, &xout2, decoder);
-
-    /* Save samples in output vector */
-    *outcode++ = xout1;
-    *outcode++ = xout2;
+    m = extract_l(L_min(L_sub(read1, i), G722_QMF_BLK));
+
+    FOR (j = 0; j < m; j++)
+    {
+      /* Separate the input G722 codeword: bits 0 to 5 are the lower-band
+       * portion of the encoding, and bits 6 and 7 are the upper-band
+       * portion of the encoding */
+      il[j] = s_and(code[i + j], 0x3F);	/* 6 bits of low SB */
+      ih = s_and(lshr(code[i + j], 6), 0x03);/* 2 bits of high SB */
+
+      /* Call the upper band ADPCM decoder */
+      rh[j] = hsbdec (ih, 0, decoder);
 #ifdef WMOPS
-    move16();
-    move16();
+      move16();
+      move16();
 #endif      
+    }
+
+    /* Call the lower band ADPCM decoder specialized for the mode */
+    lsbdec_block (il, rl, m, mode, decoder);
+
+    /* Calculation of output samples from QMF filter for the whole block */
+    qmf_rx_block (rl, rh, outcode, m, delayx);
+    outcode += shl(m, 1);
   }
-    
+}
+
+
+short g722_decode(code,outcode,mode,read1,decoder)
+  short *code;
+  short *outcode;
+  short mode;
+  short read1;
+  g722_state     *decoder;
+{
+  g722_decode_state(code, outcode, mode, read1, decoder,
+                    decoder->qmf_rx_delayx);
+
   /* Return number of samples read */
   return(shl(read1,1));
 }
 /* .................... end of g722_decode() .......................... */
 
+
+
+/* The packed variants run the codec loops above on blocks of at most
+ * G722_QMF_BLK codewords, packing (or unpacking) them in a separate pass */
+Word32 g722_encode_packed(incode,code,read1,encoder)
+  short *incode;
+  unsigned char *code;
+  Word32 read1;
+  g722_state     *encoder;
+{
+  short           cw[G722_QMF_BLK];
+  Word32          i;
+  Word16          j, m;
+
+  /* Divide sample counter by 2 to account for QMF operation */
+  read1 = L_shr(read1, 1);
+
+  FOR (i = 0; i < read1; i += m)
+  {
+    m = extract_l(L_min(L_sub(read1, i), G722_QMF_BLK));
+
+    g722_encode_state(incode, cw, L_shl(m, 1), encoder,
+                      encoder->qmf_tx_delayx);
+    incode += shl(m, 1);
+
+    /* One codeword per byte */
+    FOR (j = 0; j < m; j++)
+    {
+      code[i + j] = (unsigned char) cw[j];
+#ifdef WMOPS
+      move16();
+#endif
+    }
+  }
+
+  /* Return number of samples read */
+  return(read1);
+}
+/* .................... end of g722_encode_packed() ................... */
+
+
+Word32 g722_decode_packed(code,outcode,mode,read1,decoder)
+  unsigned char *code;
+  short *outcode;
+  short mode;
+  Word32 read1;
+  g722_state     *decoder;
+{
+  short           cw[G722_QMF_BLK];
+  Word32          i;
+  Word16          j, m;
+
+  FOR (i = 0; i < read1; i += m)
+  {
+    m = extract_l(L_min(L_sub(read1, i), G722_QMF_BLK));
+
+    FOR (j = 0; j < m; j++)
+    {
+      cw[j] = code[i + j];
+#ifdef WMOPS
+      move16();
+#endif
+    }
+
+    g722_decode_state(cw, outcode, mode, m, decoder,
+                      decoder->qmf_rx_delayx);
+    outcode += shl(m, 1);
+  }
+    
+  /* Return number of samples decoded */
+  return(L_shl(read1,1));
+}
+/* .................... end of g722_decode_packed() ................... */
+
+
+/* The compact states begin with the same ADPCM fields as g722_state
+ * (G722_ADPCM_STATE), but are different types: the band-level functions
+ * run on a g722_state that holds a copy of these fields, which is copied
+ * back afterwards. The QMF delay line is used in place. */
+#define G722_ADPCM_SIZE offsetof(g722_state, qmf_tx_delayx)
+
+void g722_enc_reset(encoder)
+g722_enc_state *encoder;
+{
+  g722_state      s;
+  Word16          j;
+
+  FOR (j = 0; j < 24; j++)
+  {
+    encoder->qmf_tx_delayx[j] = 0;
+#ifdef WMOPS
+    move16();
+#endif
+  }
+  lsbcod (0, 1, &s);
+  hsbcod (0, 1, &s);
+  memcpy (encoder, &s, G722_ADPCM_SIZE);
+}
+/* .................... end of g722_enc_reset() ....................... */
+
+
+Word32 g722_enc_encode(incode,code,read1,encoder)
+  short *incode;
+  short *code;
+  Word32 read1;
+  g722_enc_state *encoder;
+{
+  g722_state      s;
+
+  memcpy (&s, encoder, G722_ADPCM_SIZE);
+  read1 = g722_encode_state(incode, code, read1, &s,
+                            encoder->qmf_tx_delayx);
+  memcpy (encoder, &s, G722_ADPCM_SIZE);
+  return(read1);
+}
+/* .................... end of g722_enc_encode() .......................... */
+
+
+void g722_dec_reset(decoder)
+g722_dec_state *decoder;
+{
+  g722_state      s;
+  Word16          j;
+
+  FOR (j = 0; j < 24; j++)
+  {
+    decoder->qmf_rx_delayx[j] = 0;
+#ifdef WMOPS
+    move16();
+#endif
+  }
+  lsbdec (0, (Word16)0, 1, &s);
+  hsbdec (0, 1, &s);
+  memcpy (decoder, &s, G722_ADPCM_SIZE);
+}
+/* .................... end of g722_dec_reset() ....................... */
+
+
+Word32 g722_dec_decode(code,outcode,mode,read1,decoder)
+  short *code;
+  short *outcode;
+  short mode;
+  Word32 read1;
+  g722_dec_state *decoder;
+{
+  g722_state      s;
+
+  memcpy (&s, decoder, G722_ADPCM_SIZE);
+  g722_decode_state(code, outcode, mode, read1, &s,
+                    decoder->qmf_rx_delayx);
+  memcpy (decoder, &s, G722_ADPCM_SIZE);
+
+  /* Return number of samples decoded */
+  return(L_shl(read1,1));
+}
+/* .................... end of g722_dec_decode() .......................... */
@@ -32,33 +32,65 @@
 /* #include "operg722.h" */
 #include "stl.h"
 
+/* ADPCM (band) part of the G.722 state; it is the leading part of every
+ * state type below. The band-level functions of funcg722.c (lsbcod(),
+ * hsbdec(), ...) operate on a g722_state; g722.c copies this part of
+ * the compact states to and from one */
+#define G722_ADPCM_STATE \
+  Word16          al[3]; \
+  Word16          bl[7]; \
+  Word16          detl; \
+  Word16          dlt[7]; /* dlt[0]=dlt */ \
+  Word16          nbl; \
+  Word16          plt[3]; /* plt[0]=plt */ \
+  Word16          rlt[3]; \
+  Word16          ah[3]; \
+  Word16          bh[7]; \
+  Word16          deth; \
+  Word16          dh[7]; /* dh[0]=dh */ \
+  Word16          ph[3]; /* ph[0]=ph */ \
+  Word16          rh[3]; \
+  Word16          sl; \
+  Word16          spl; \
+  Word16          szl; \
+  Word16          nbh; \
+  Word16          sh; \
+  Word16          sph; \
+  Word16          szh;
+
 /* Define type for G.722 state structure */
 typedef struct
 {
-  Word16          al[3];
-  Word16          bl[7];
-  Word16          detl;
-  Word16          dlt[7]; /* dlt[0]=dlt */
-  Word16          nbl;
-  Word16          plt[3]; /* plt[0]=plt */
-  Word16          rlt[3];
-  Word16          ah[3];
-  Word16          bh[7];
-  Word16          deth;
-  Word16          dh[7]; /* dh[0]=dh */
-  Word16          ph[3]; /* ph[0]=ph */
-  Word16          rh[3];
-  Word16          sl;
-  Word16          spl;
-  Word16          szl;
-  Word16          nbh;
-  Word16          sh;
-  Word16          sph;
-  Word16          szh;
+  G722_ADPCM_STATE
   Word16          qmf_tx_delayx[24];
   Word16          qmf_rx_delayx[24];
 }          g722_state;
 
+/* Cache line size the compact state types are aligned to */
+#ifndef G722_CACHE_LINE
+#define G722_CACHE_LINE 64
+#endif
+#if defined(__GNUC__) || defined(__clang__)
+#define G722_CACHE_ALIGNED __attribute__ ((aligned (G722_CACHE_LINE)))
+#else
+#define G722_CACHE_ALIGNED
+#endif
+
+/* Compact encoder-only and decoder-only states: the ADPCM part plus the
+ * one QMF delay line the direction uses (160 bytes, padded to 192 by
+ * the alignment, i.e. three cache lines) */
+typedef struct
+{
+  G722_ADPCM_STATE
+  Word16          qmf_tx_delayx[24];
+} G722_CACHE_ALIGNED g722_enc_state;
+
+typedef struct
+{
+  G722_ADPCM_STATE
+  Word16          qmf_rx_delayx[24];
+} G722_CACHE_ALIGNED g722_dec_state;
+
 /* Include function prototypes for G722 functions */
 #include "funcg722.h"
 
@@ -70,5 +102,20 @@ void g722_reset_decoder ARGS((g722_state *decoder));
 short g722_decode ARGS((short *code, short *outcode, short mode, 
 		       short nsmp, g722_state *decoder));
 
+/* Same as above, with one G722 codeword per byte in the bitstream buffer */
+Word32 g722_encode_packed ARGS((short *incode, unsigned char *code, 
+		       Word32 nsmp, g722_state *encoder));
+Word32 g722_decode_packed ARGS((unsigned char *code, short *outcode, 
+		       short mode, Word32 nsmp, g722_state *decoder));
+
+/* Same as g722_reset_encoder()/g722_encode()/g722_reset_decoder()/
+ * g722_decode(), on the compact encoder-only and decoder-only states */
+void g722_enc_reset ARGS((g722_enc_state *encoder));
+Word32 g722_enc_encode ARGS((short *incode, short *code, Word32 nsmp, 
+		       g722_enc_state *encoder));
+void g722_dec_reset ARGS((g722_dec_state *decoder));
+Word32 g722_dec_decode ARGS((short *code, short *outcode, short mode, 
+		       Word32 nsmp, g722_dec_state *decoder));
+
 #endif /* G722_H */
 /* ................. End of file g722.h .................................. */
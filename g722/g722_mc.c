@@ -0,0 +1,372 @@
+/*                     v3.0 - 10/Jan/2007
+  ============================================================================
+
+                          U    U   GGG    SSSS  TTTTT
+                          U    U  G       S       T
+                          U    U  G  GG   SSSS    T
+                          U    U  G   G       S   T
+                           UUU     GG     SSS     T
+
+                   ========================================
+                    ITU-T - USER'S GROUP ON SOFTWARE TOOLS
+                   ========================================
+
+
+       =============================================================
+       COPYRIGHT NOTE: This source code, and all of its derivations,
+       is subject to the "ITU-T General Public License". Please have
+       it  read  in    the  distribution  disk,   or  in  the  ITU-T
+       Recommendation G.191 on "SOFTWARE TOOLS FOR SPEECH AND  AUDIO
+       CODING STANDARDS".
+       ** This code has  (C) Copyright by CNET Lannion A TSS/CMC **
+       =============================================================
+
+
+MODULE:         G722_MC.C MULTI-CHANNEL (BATCHED) G.722 ENCODER
+
+DESCRIPTION:
+   Encodes up to G722_MC_MAXCH independent channels in lockstep. Each
+   step of qmf_tx(), lsbcod() and hsbcod() is rewritten as a loop over
+   channels working on the structure-of-arrays state g722_mc_state, so
+   that the loops can be mapped by the compiler onto vector lanes.
+
+   The basic operators used by the scalar path are replaced by local
+   inline equivalents (mc_add(), mc_mult(), ...) with the same
+   saturation rules, so the produced codewords are bit-exact with
+   g722_encode(). The global Overflow flag is not updated and no WMOPS
+   are counted by this module.
+
+   History:
+   first version, derived from funcg722.c and g722.c
+  ============================================================================
+*/
+#include <string.h>
+
+#include "g722_mc.h"
+#include "g722_tab.h"
+
+
+/* ........... Local saturating operators (same rules as basop32.c) ........ */
+static __inline Word16 mc_sat (Word32 L_var1)
+{
+  if (L_var1 > 32767L)
+    L_var1 = 32767L;
+  if (L_var1 < -32768L)
+    L_var1 = -32768L;
+  return ((Word16) L_var1);
+}
+
+static __inline Word16 mc_add (Word16 var1, Word16 var2)
+{
+  return mc_sat ((Word32) var1 + (Word32) var2);
+}
+
+static __inline Word16 mc_sub (Word16 var1, Word16 var2)
+{
+  return mc_sat ((Word32) var1 - (Word32) var2);
+}
+
+static __inline Word16 mc_mult (Word16 var1, Word16 var2)
+{
+  return mc_sat (((Word32) var1 * (Word32) var2) >> 15);
+}
+
+static __inline Word16 mc_shl (Word16 var1, Word16 var2)
+{
+  return mc_sat ((Word32) var1 * (1L << var2));
+}
+
+static __inline Word16 mc_limit (Word16 var1)
+{
+  if (var1 > 16383)
+    var1 = 16383;
+  if (var1 < -16384)
+    var1 = -16384;
+  return (var1);
+}
+
+
+/* ............. Tables (folded versions of those in funcg722.c) ........... */
+
+/* 6 levels quantizer level of decision, pre-shifted by 3 (see quantl()) */
+static Word16   mc_q6[30] =
+  {
+    0 * 8, 35 * 8, 72 * 8, 110 * 8, 150 * 8, 190 * 8, 233 * 8, 276 * 8,
+    323 * 8, 370 * 8, 422 * 8, 473 * 8, 530 * 8, 587 * 8, 650 * 8, 714 * 8,
+    786 * 8, 858 * 8, 940 * 8, 1023 * 8, 1121 * 8, 1219 * 8, 1339 * 8,
+    1458 * 8, 1612 * 8, 1765 * 8, 1980 * 8, 2195 * 8, 2557 * 8, 2919 * 8
+  };
+
+/* table to read IL from SIL and MIL: misil(sil(0,1),mil(1,31)) */
+static Word16   mc_misil[2][32] =
+  {
+    {0x0000, 0x003F, 0x003E, 0x001F, 0x001E, 0x001D, 0x001C, 0x001B,
+     0x001A, 0x0019, 0x0018, 0x0017, 0x0016, 0x0015, 0x0014, 0x0013,
+     0x0012, 0x0011, 0x0010, 0x000F, 0x000E, 0x000D, 0x000C, 0x000B,
+     0x000A, 0x0009, 0x0008, 0x0007, 0x0006, 0x0005, 0x0004, 0x0000},
+    {0x0000, 0x003D, 0x003C, 0x003B, 0x003A, 0x0039, 0x0038, 0x0037,
+     0x0036, 0x0035, 0x0034, 0x0033, 0x0032, 0x0031, 0x0030, 0x002F,
+     0x002E, 0x002D, 0x002C, 0x002B, 0x002A, 0x0029, 0x0028, 0x0027,
+     0x0026, 0x0025, 0x0024, 0x0023, 0x0022, 0x0021, 0x0020, 0x0000}
+  };
+
+/* invqal(): oq4[ril4[ril]] << 3 with the sign of risil[ril] */
+static Word16   mc_oq4s[16] =
+  {
+    0, -20456, -12896, -8968, -6288, -4240, -2584, -1200,
+    20456, 12896, 8968, 6288, 4240, 2584, 1200, 0
+  };
+
+/* logscl(): wl[ril4[ril]] */
+static Word16   mc_wl4[16] =
+  {
+    -60, 3042, 1198, 538, 334, 172, 58, -30,
+    3042, 1198, 538, 334, 172, 58, -30, -60
+  };
+
+/* quanth(): misih(sih(0,1),mih(1,2)) */
+static Word16   mc_misih[2][3] =
+  {
+    {0, 1, 0},
+    {0, 3, 2}
+  };
+
+/* invqah(): oq2[ih2[ih]] << 3 with the sign of sih[ih] */
+static Word16   mc_oq2s[4] = {-7408, -1616, 7408, 1616};
+
+/* logsch(): wh[ih2[ih]] */
+static Word16   mc_wh2[4] = {798, -214, 798, -214};
+
+
+/*___________________________________________________________________________
+
+    Function Name : mc_adapt
+
+    Purpose :
+
+     Pole/zero predictor adaptation shared by both sub-bands. Runs the
+     sequence parrec/recons, upzero(), uppol2(), uppol1(), filtez(),
+     filtep() and predic of lsbcod()/hsbcod() on n channels at once.
+
+    Inputs :
+      d, b, a, p, r - difference, zero and pole coefficients, partially
+                      reconstructed and reconstructed signal lanes
+                      (read/write; d[0] holds the new quantized difference)
+      s, sz         - predictor output lanes (read/write)
+      n             - number of active lanes
+
+    Return Value :
+     None.
+ ___________________________________________________________________________
+*/
+static void
+mc_adapt (Word16 d[7][G722_MC_MAXCH], Word16 b[7][G722_MC_MAXCH],
+          Word16 a[3][G722_MC_MAXCH], Word16 p[3][G722_MC_MAXCH],
+          Word16 r[3][G722_MC_MAXCH], Word16 s[G722_MC_MAXCH],
+          Word16 sz[G722_MC_MAXCH], Word16 n)
+{
+  Word16          c, i;
+  Word16          sg0, sg1, sg2, sgi, wd1, wd2, wd3, apl1, apl2, szl;
+
+  for (c = 0; c < n; c++)
+  {
+    /* parrec, recons */
+    p[0][c] = mc_add (d[0][c], sz[c]);
+    r[0][c] = mc_add (s[c], d[0][c]);
+
+    /* upzero(): shift of the d line signal and update of b */
+    wd1 = (d[0][c] == 0) ? 0 : 128;
+    sg0 = d[0][c] >> 15;
+    for (i = 6; i > 0; i--)
+    {
+      sgi = d[i][c] >> 15;
+      wd2 = (sg0 == sgi) ? wd1 : -wd1;
+      b[i][c] = mc_add (wd2, mc_mult (b[i][c], 32640));
+      d[i][c] = d[i - 1][c];
+    }
+
+    /* uppol2() */
+    sg0 = p[0][c] >> 15;
+    sg1 = p[1][c] >> 15;
+    sg2 = p[2][c] >> 15;
+    wd1 = mc_shl (a[1][c], 2);
+    wd2 = (sg0 == sg1) ? mc_sub (0, wd1) : wd1;
+    wd2 = wd2 >> 7;
+    wd3 = (sg0 == sg2) ? 128 : -128;
+    apl2 = mc_add (mc_add (wd2, wd3), mc_mult (a[2][c], 32512));
+    if (apl2 > 12288)
+      apl2 = 12288;
+    if (apl2 < -12288)
+      apl2 = -12288;
+    a[2][c] = apl2;
+
+    /* uppol1(): wd3 is always positive, so the two-sided test of the
+     * scalar code is a plain clamp to [-wd3, wd3] */
+    wd1 = (sg0 == sg1) ? 192 : -192;
+    apl1 = mc_add (wd1, mc_mult (a[1][c], 32640));
+    wd3 = mc_sub (15360, apl2);
+    if (apl1 > wd3)
+      apl1 = wd3;
+    if (apl1 < -wd3)
+      apl1 = -wd3;
+    p[2][c] = p[1][c];
+    p[1][c] = p[0][c];
+    a[1][c] = apl1;
+
+    /* filtez() */
+    szl = 0;
+    for (i = 6; i > 0; i--)
+    {
+      wd1 = mc_add (d[i][c], d[i][c]);
+      szl = mc_add (szl, mc_mult (wd1, b[i][c]));
+    }
+    sz[c] = szl;
+
+    /* filtep() and predic */
+    r[2][c] = r[1][c];
+    r[1][c] = r[0][c];
+    wd1 = mc_mult (a[1][c], mc_add (r[1][c], r[1][c]));
+    wd2 = mc_mult (a[2][c], mc_add (r[2][c], r[2][c]));
+    s[c] = mc_add (mc_add (wd1, wd2), szl);
+  }
+}
+/* ..................... End of mc_adapt() ..................... */
+
+
+void g722_mc_reset_encoder(encoder, nch)
+g722_mc_state *encoder;
+Word16 nch;
+{
+  Word16          c;
+
+  /* The state arrays hold at most G722_MC_MAXCH channels */
+  if (nch < 0)
+    nch = 0;
+  if (nch > G722_MC_MAXCH)
+    nch = G722_MC_MAXCH;
+
+  memset (encoder, 0, sizeof (g722_mc_state));
+  encoder->nch = nch;
+  for (c = 0; c < G722_MC_MAXCH; c++)
+  {
+    encoder->detl[c] = 32;
+    encoder->deth[c] = 8;
+  }
+}
+/* .................... end of g722_mc_reset_encoder() .................... */
+
+
+Word32 g722_mc_encode(incode,code,read1,encoder)
+  short *incode[];
+  short *code[];
+  Word32 read1;
+  g722_mc_state  *encoder;
+{
+  Word16          (*delayx)[G722_MC_MAXCH] = encoder->qmf_tx_delayx;
+  Word16          xl[G722_MC_MAXCH], xh[G722_MC_MAXCH];
+  Word16          il[G722_MC_MAXCH], ih[G722_MC_MAXCH];
+  Word32          accuma[G722_MC_MAXCH], accumb[G722_MC_MAXCH];
+  Word16          nch = encoder->nch;
+  Word16          c, k, sg, wd, mil;
+  Word32          i, comp;
+
+  /* Reject a channel count the state arrays can't hold */
+  if (nch < 0 || nch > G722_MC_MAXCH)
+    return (0);
+
+  /* Divide sample counter by 2 to account for QMF operation */
+  read1 = read1 >> 1;
+
+  for (i = 0; i < read1; i++)
+  {
+    /* qmf_tx(): saving past samples in delay line */
+    for (c = 0; c < nch; c++)
+    {
+      delayx[1][c] = incode[c][2 * i];
+      delayx[0][c] = incode[c][2 * i + 1];
+      accuma[c] = 0;
+      accumb[c] = 0;
+    }
+
+    /* QMF filtering; |accuma|+|accumb| < 2^30, so the L_mac0() and L_add()
+     * chain of the scalar code can never saturate */
+    for (k = 0; k < 24; k += 2)
+      for (c = 0; c < nch; c++)
+      {
+        accuma[c] += (Word32) g722_coef_qmf[k] * delayx[k][c];
+        accumb[c] += (Word32) g722_coef_qmf[k + 1] * delayx[k + 1][c];
+      }
+
+    /* Shift of the delay line */
+    for (k = 23; k > 1; k--)
+      for (c = 0; c < nch; c++)
+        delayx[k][c] = delayx[k - 2][c];
+
+    for (c = 0; c < nch; c++)
+    {
+      comp = (accuma[c] + accumb[c]) * 2;
+      xl[c] = mc_limit ((Word16) (comp >> 16));
+      comp = (accuma[c] - accumb[c]) * 2;
+      xh[c] = mc_limit ((Word16) (comp >> 16));
+    }
+
+    /* lsbcod(): subtra, quantl(), invqal(), logscl(), scalel() */
+    for (c = 0; c < nch; c++)
+    {
+      wd = mc_sub (xl[c], encoder->sl[c]);
+      sg = wd >> 15;
+      if (sg != 0)
+        wd = 32767 - (wd & 32767);
+
+      /* The decision levels are monotonic, so the level index is the
+       * number of levels not above wd */
+      mil = 0;
+      for (k = 0; k < 30; k++)
+        mil += (mc_mult (mc_q6[k], encoder->detl[c]) <= wd);
+      il[c] = mc_misil[sg + 1][mil];
+
+      encoder->dlt[0][c] = mc_mult (encoder->detl[c], mc_oq4s[il[c] >> 2]);
+
+      wd = mc_add (mc_mult (encoder->nbl[c], 32512), mc_wl4[il[c] >> 2]);
+      if (wd < 0)
+        wd = 0;
+      if (wd > 18432)
+        wd = 18432;
+      encoder->nbl[c] = wd;
+      encoder->detl[c] = (g722_ila[((wd >> 6) & 511) + 64] + 1) << 2;
+    }
+    mc_adapt (encoder->dlt, encoder->bl, encoder->al, encoder->plt,
+              encoder->rlt, encoder->sl, encoder->szl, nch);
+
+    /* hsbcod(): subtra, quanth(), invqah(), logsch(), scaleh() */
+    for (c = 0; c < nch; c++)
+    {
+      wd = mc_sub (xh[c], encoder->sh[c]);
+      sg = wd >> 15;
+      if (sg != 0)
+        wd = 32767 - (wd & 32767);
+      mil = (wd >= mc_mult (564 * 8, encoder->deth[c])) ? 2 : 1;
+      ih[c] = mc_misih[sg + 1][mil];
+
+      encoder->dh[0][c] = mc_mult (mc_oq2s[ih[c]], encoder->deth[c]);
+
+      wd = mc_add (mc_mult (encoder->nbh[c], 32512), mc_wh2[ih[c]]);
+      if (wd < 0)
+        wd = 0;
+      if (wd > 22528)
+        wd = 22528;
+      encoder->nbh[c] = wd;
+      encoder->deth[c] = (g722_ila[(wd >> 6) & 511] + 1) << 2;
+    }
+    mc_adapt (encoder->dh, encoder->bh, encoder->ah, encoder->ph,
+              encoder->rh, encoder->sh, encoder->szh, nch);
+
+    /* Mount the output G722 codewords */
+    for (c = 0; c < nch; c++)
+      code[c][i] = ((ih[c] << 6) + il[c]) & 0xFF;
+  }
+
+  /* Return number of samples read */
+  return (read1);
+}
+/* .................... end of g722_mc_encode() ........................ */
@@ -0,0 +1,67 @@
+/*
+  ============================================================================
+   File: G722_MC.H                                           v3.0 - 10/Jan/2007
+  ============================================================================
+
+                            UGST/ITU-T G722 MODULE
+
+                 MULTI-CHANNEL (BATCHED) ENCODER PROTOTYPES
+
+   The batched encoder advances up to G722_MC_MAXCH independent G.722
+   channels in lockstep. Its state is kept as a structure of arrays, one
+   array per G.722 state variable indexed by channel, so that every step
+   of the ADPCM recursion becomes a loop over channels that the compiler
+   can map onto vector lanes. The output is bit-exact with g722_encode()
+   run separately on every channel.
+
+   History:
+   first version, multi-channel encoder in structure-of-arrays layout
+  ============================================================================
+*/
+#ifndef G722_MC_H
+#define G722_MC_H 200
+
+#include "g722.h"
+
+/* Maximum number of channels advanced by one batched state (lane count) */
+#ifndef G722_MC_MAXCH
+#define G722_MC_MAXCH 16
+#endif
+
+/* Define type for the batched G.722 encoder state: every field of
+ * g722_state (encoder side) is stored with the channel as the fastest
+ * varying index, i.e. al[k][ch] is al[k] of channel ch */
+typedef struct
+{
+  Word16          nch;
+  Word16          al[3][G722_MC_MAXCH];
+  Word16          bl[7][G722_MC_MAXCH];
+  Word16          detl[G722_MC_MAXCH];
+  Word16          dlt[7][G722_MC_MAXCH];
+  Word16          nbl[G722_MC_MAXCH];
+  Word16          plt[3][G722_MC_MAXCH];
+  Word16          rlt[3][G722_MC_MAXCH];
+  Word16          sl[G722_MC_MAXCH];
+  Word16          szl[G722_MC_MAXCH];
+  Word16          ah[3][G722_MC_MAXCH];
+  Word16          bh[7][G722_MC_MAXCH];
+  Word16          deth[G722_MC_MAXCH];
+  Word16          dh[7][G722_MC_MAXCH];
+  Word16          nbh[G722_MC_MAXCH];
+  Word16          ph[3][G722_MC_MAXCH];
+  Word16          rh[3][G722_MC_MAXCH];
+  Word16          sh[G722_MC_MAXCH];
+  Word16          szh[G722_MC_MAXCH];
+  Word16          qmf_tx_delayx[24][G722_MC_MAXCH];
+}          g722_mc_state;
+
+/* High-level function prototypes for the batched G722 encoder;
+ * g722_mc_reset_encoder() clamps nch to 0..G722_MC_MAXCH, and
+ * g722_mc_encode() encodes nothing (returns 0) if the nch of the state
+ * is outside that range */
+void g722_mc_reset_encoder ARGS((g722_mc_state *encoder, Word16 nch));
+Word32 g722_mc_encode ARGS((short *incode[], short *code[], Word32 nsmp,
+                            g722_mc_state *encoder));
+
+#endif /* G722_MC_H */
+/* ................. End of file g722_mc.h .................................. */
@@ -0,0 +1,167 @@
+/*                     v3.0 - 10/Jan/2007
+  ============================================================================
+
+                          U    U   GGG    SSSS  TTTTT
+                          U    U  G       S       T
+                          U    U  G  GG   SSSS    T
+                          U    U  G   G       S   T
+                           UUU     GG     SSS     T
+
+                   ========================================
+                    ITU-T - USER'S GROUP ON SOFTWARE TOOLS
+                   ========================================
+
+
+       =============================================================
+       COPYRIGHT NOTE: This source code, and all of its derivations,
+       is subject to the "ITU-T General Public License". Please have
+       it  read  in    the  distribution  disk,   or  in  the  ITU-T
+       Recommendation G.191 on "SOFTWARE TOOLS FOR SPEECH AND  AUDIO
+       CODING STANDARDS".
+       ** This code has  (C) Copyright by CNET Lannion A TSS/CMC **
+       =============================================================
+
+
+MODULE:         G722_POOL.C POOLED ALLOCATOR FOR G.722 CHANNEL STATES
+
+DESCRIPTION:
+   Hands out fixed-size slots from one contiguous slab. The slot size is
+   rounded up to G722_CACHE_LINE and the slab is aligned to it, so every
+   slot starts on a cache line of its own. Free slots are kept on a
+   stack of indices: the most recently released slot, which is the most
+   likely to still be cached, is reused first.
+
+   History:
+   first version
+  ============================================================================
+*/
+#include <stdlib.h>
+
+#include "g722_pool.h"
+
+
+g722_pool *g722_pool_create(size, nslot)
+  Word32 size;
+  Word32 nslot;
+{
+  g722_pool      *pool;
+  size_t          addr;
+  Word32          i;
+
+  if (size <= 0 || nslot <= 0)
+    return (NULL);
+
+  pool = (g722_pool *) malloc(sizeof(g722_pool));
+  if (pool == NULL)
+    return (NULL);
+
+  pool->stride = (size + G722_CACHE_LINE - 1) & ~(Word32) (G722_CACHE_LINE - 1);
+  pool->nslot = nslot;
+  pool->mem = malloc((size_t) pool->stride * (size_t) nslot + G722_CACHE_LINE);
+  pool->freelist = (Word32 *) malloc((size_t) nslot * sizeof(Word32));
+  pool->used = (char *) calloc((size_t) nslot, 1);
+  if (pool->mem == NULL || pool->freelist == NULL || pool->used == NULL)
+  {
+    free(pool->mem);
+    free(pool->freelist);
+    free(pool->used);
+    free(pool);
+    return (NULL);
+  }
+
+  /* Align the first slot to a cache line */
+  addr = (size_t) pool->mem;
+  addr = (addr + G722_CACHE_LINE - 1) & ~(size_t) (G722_CACHE_LINE - 1);
+  pool->base = (char *) addr;
+
+  /* Slot 0 is on top of the stack, so that a fresh pool is filled in
+   * address order */
+  for (i = 0; i < nslot; i++)
+    pool->freelist[i] = nslot - 1 - i;
+  pool->nfree = nslot;
+
+  return (pool);
+}
+/* .................... end of g722_pool_create() ....................... */
+
+
+void *g722_pool_alloc(pool)
+  g722_pool      *pool;
+{
+  Word32          i;
+
+  if (pool->nfree == 0)
+    return (NULL);
+  pool->nfree--;
+  i = pool->freelist[pool->nfree];
+  pool->used[i] = 1;
+  return ((void *) (pool->base + (size_t) i * pool->stride));
+}
+/* .................... end of g722_pool_alloc() ....................... */
+
+
+void g722_pool_free(pool, slot)
+  g722_pool      *pool;
+  void           *slot;
+{
+  size_t          off;
+  Word32          i;
+
+  if (slot == NULL)
+    return;
+
+  /* Only a slot start of this pool that is currently allocated goes back
+   * on the free list; the offset is unsigned, so that a pointer below the
+   * slab is out of range as well */
+  off = (size_t) slot - (size_t) pool->base;
+  if (off >= (size_t) pool->stride * (size_t) pool->nslot
+      || off % (size_t) pool->stride != 0)
+    return;
+  i = (Word32) (off / (size_t) pool->stride);
+  if (!pool->used[i])
+    return;
+
+  pool->used[i] = 0;
+  pool->freelist[pool->nfree] = i;
+  pool->nfree++;
+}
+/* .................... end of g722_pool_free() ....................... */
+
+
+void g722_pool_destroy(pool)
+  g722_pool      *pool;
+{
+  if (pool == NULL)
+    return;
+  free(pool->mem);
+  free(pool->freelist);
+  free(pool->used);
+  free(pool);
+}
+/* .................... end of g722_pool_destroy() ....................... */
+
+
+g722_enc_state *g722_pool_new_encoder(pool)
+  g722_pool      *pool;
+{
+  g722_enc_state *encoder;
+
+  encoder = (g722_enc_state *) g722_pool_alloc(pool);
+  if (encoder != NULL)
+    g722_enc_reset(encoder);
+  return (encoder);
+}
+/* .................... end of g722_pool_new_encoder() ....................... */
+
+
+g722_dec_state *g722_pool_new_decoder(pool)
+  g722_pool      *pool;
+{
+  g722_dec_state *decoder;
+
+  decoder = (g722_dec_state *) g722_pool_alloc(pool);
+  if (decoder != NULL)
+    g722_dec_reset(decoder);
+  return (decoder);
+}
+/* .................... end of g722_pool_new_decoder() ....................... */
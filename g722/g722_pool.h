@@ -0,0 +1,54 @@
+/*
+  ============================================================================
+   File: G722_POOL.H                                         v3.0 - 10/Jan/2007
+  ============================================================================
+
+                            UGST/ITU-T G722 MODULE
+
+                     POOLED STATE ALLOCATOR PROTOTYPES
+
+   A pool is one contiguous, cache-line-aligned slab of equally sized
+   slots, with a free list of slot indices. It is meant for servers that
+   keep many thousands of G.722 channels: a g722_enc_state or
+   g722_dec_state taken from a pool occupies exactly three cache lines
+   and never shares a line with another channel. Allocation and release
+   are O(1) and never call malloc() once the pool exists.
+
+   History:
+   first version, slab allocator for the compact G.722 states
+  ============================================================================
+*/
+#ifndef G722_POOL_H
+#define G722_POOL_H 200
+
+#include "g722.h"
+
+/* Define type for a pool of fixed-size slots */
+typedef struct
+{
+  void           *mem;          /* block returned by malloc() */
+  char           *base;         /* first slot, G722_CACHE_LINE aligned */
+  Word32          stride;       /* slot size rounded to G722_CACHE_LINE */
+  Word32          nslot;        /* number of slots */
+  Word32          nfree;        /* number of free slots */
+  Word32         *freelist;     /* indices of the free slots (a stack) */
+  char           *used;         /* 1 for each slot currently allocated */
+}          g722_pool;
+
+/* Generic slot allocator. g722_pool_free() ignores a slot that is not
+ * an allocated slot of this pool (double free, foreign pointer) */
+g722_pool *g722_pool_create ARGS((Word32 size, Word32 nslot));
+void *g722_pool_alloc ARGS((g722_pool *pool));
+void g722_pool_free ARGS((g722_pool *pool, void *slot));
+void g722_pool_destroy ARGS((g722_pool *pool));
+
+/* Pools of compact states; the states handed out are already reset */
+#define g722_pool_create_encoders(n) \
+  g722_pool_create ((Word32) sizeof (g722_enc_state), (n))
+#define g722_pool_create_decoders(n) \
+  g722_pool_create ((Word32) sizeof (g722_dec_state), (n))
+g722_enc_state *g722_pool_new_encoder ARGS((g722_pool *pool));
+g722_dec_state *g722_pool_new_decoder ARGS((g722_pool *pool));
+
+#endif /* G722_POOL_H */
+/* ................. End of file g722_pool.h .................................. */
@@ -0,0 +1,152 @@
+/*                     v3.0 - 10/Jan/2007
+  ============================================================================
+
+                          U    U   GGG    SSSS  TTTTT
+                          U    U  G       S       T
+                          U    U  G  GG   SSSS    T
+                          U    U  G   G       S   T
+                           UUU     GG     SSS     T
+
+                   ========================================
+                    ITU-T - USER'S GROUP ON SOFTWARE TOOLS
+                   ========================================
+
+
+       =============================================================
+       COPYRIGHT NOTE: This source code, and all of its derivations,
+       is subject to the "ITU-T General Public License". Please have
+       it  read  in    the  distribution  disk,   or  in  the  ITU-T
+       Recommendation G.191 on "SOFTWARE TOOLS FOR SPEECH AND  AUDIO
+       CODING STANDARDS".
+       ** This code has  (C) Copyright by CNET Lannion A TSS/CMC **
+       =============================================================
+
+
+MODULE:         G722_STREAM.C STREAMING G.722 ENCODER AND DECODER
+
+DESCRIPTION:
+   Wraps g722_enc_encode() and g722_dec_decode() for arbitrary chunk
+   sizes. An odd trailing input sample is kept in the encoder context
+   and paired with the first sample of the next chunk. Lengths are
+   size_t. Long chunks are cut into calls of at most G722_STREAM_MAXCALL
+   samples, which keeps every count inside the Word32 range of the
+   underlying functions. Output is bit-exact with one g722_encode() or
+   g722_decode() call on the concatenated input.
+
+   History:
+   first version
+  ============================================================================
+*/
+#include "g722_stream.h"
+
+/* Largest (even) number of samples passed to one g722_enc_encode() */
+#define G722_STREAM_MAXCALL ((size_t) 0x40000000L)
+
+
+void g722_stream_reset_encoder(st)
+  g722_enc_stream *st;
+{
+  g722_enc_reset(&st->state);
+  st->pending = 0;
+  st->npending = 0;
+}
+/* .................... end of g722_stream_reset_encoder() ....................... */
+
+
+size_t g722_stream_encode(st, incode, nsmp, code)
+  g722_enc_stream *st;
+  short          *incode;
+  size_t          nsmp;
+  short          *code;
+{
+  short           pair[2];
+  size_t          ncode = 0;
+  size_t          n;
+
+  if (nsmp == 0)
+    return (0);
+
+  /* Complete the pair left over from the previous call */
+  if (st->npending)
+  {
+    pair[0] = st->pending;
+    pair[1] = *incode++;
+    nsmp--;
+    g722_enc_encode(pair, code, 2L, &st->state);
+    code++;
+    ncode++;
+    st->npending = 0;
+  }
+
+  /* Whole pairs, straight from the caller's buffers */
+  while (nsmp >= 2)
+  {
+    n = nsmp < G722_STREAM_MAXCALL ? nsmp & ~(size_t) 1 : G722_STREAM_MAXCALL;
+    g722_enc_encode(incode, code, (Word32) n, &st->state);
+    incode += n;
+    code += n / 2;
+    ncode += n / 2;
+    nsmp -= n;
+  }
+
+  /* Keep an odd trailing sample for the next call */
+  if (nsmp)
+  {
+    st->pending = *incode;
+    st->npending = 1;
+  }
+
+  return (ncode);
+}
+/* .................... end of g722_stream_encode() ....................... */
+
+
+size_t g722_stream_flush(st, code)
+  g722_enc_stream *st;
+  short          *code;
+{
+  short           pair[2];
+
+  if (!st->npending)
+    return (0);
+  pair[0] = st->pending;
+  pair[1] = 0;
+  g722_enc_encode(pair, code, 2L, &st->state);
+  st->npending = 0;
+  return (1);
+}
+/* .................... end of g722_stream_flush() ....................... */
+
+
+void g722_stream_reset_decoder(st, mode)
+  g722_dec_stream *st;
+  short           mode;
+{
+  g722_dec_reset(&st->state);
+  st->mode = mode;
+}
+/* .................... end of g722_stream_reset_decoder() ....................... */
+
+
+size_t g722_stream_decode(st, code, ncode, outcode)
+  g722_dec_stream *st;
+  short          *code;
+  size_t          ncode;
+  short          *outcode;
+{
+  size_t          nout = 0;
+  size_t          n;
+
+  while (ncode > 0)
+  {
+    n = ncode < G722_STREAM_MAXCALL ? ncode : G722_STREAM_MAXCALL;
+    g722_dec_decode(code, outcode, st->mode, (Word32) n, &st->state);
+    code += n;
+    outcode += 2 * n;
+    nout += 2 * n;
+    ncode -= n;
+  }
+
+  return (nout);
+}
+/* .................... end of g722_stream_decode() ....................... */
@@ -0,0 +1,56 @@
+/*
+  ============================================================================
+   File: G722_STREAM.H                                       v3.0 - 10/Jan/2007
+  ============================================================================
+
+                            UGST/ITU-T G722 MODULE
+
+                        STREAMING INTERFACE PROTOTYPES
+
+   The streaming contexts accept input chunks of any length, counted as
+   size_t. The encoder keeps an odd trailing sample until the next call
+   completes the pair; g722_encode() would drop it. Output goes straight
+   into the caller's buffer, and only a carried-over sample is copied.
+
+   History:
+   first version, streaming encoder/decoder contexts
+  ============================================================================
+*/
+#ifndef G722_STREAM_H
+#define G722_STREAM_H 200
+
+#include <stddef.h>
+
+#include "g722.h"
+
+/* Define type for the streaming encoder context */
+typedef struct
+{
+  g722_enc_state  state;
+  Word16          pending;      /* first sample of an incomplete pair */
+  Word16          npending;     /* 1 if pending holds a sample, else 0 */
+}          g722_enc_stream;
+
+/* Define type for the streaming decoder context */
+typedef struct
+{
+  g722_dec_state  state;
+  Word16          mode;         /* G.722 operation mode (1, 2 or 3) */
+}          g722_dec_stream;
+
+/* Streaming encoder: g722_stream_encode() writes (npending+nsmp)/2
+ * codewords to code and returns that count; g722_stream_flush() encodes
+ * a pending sample paired with a zero and returns 0 or 1 */
+void g722_stream_reset_encoder ARGS((g722_enc_stream *st));
+size_t g722_stream_encode ARGS((g722_enc_stream *st, short *incode,
+                                size_t nsmp, short *code));
+size_t g722_stream_flush ARGS((g722_enc_stream *st, short *code));
+
+/* Streaming decoder: g722_stream_decode() writes 2*ncode samples to
+ * outcode and returns that count */
+void g722_stream_reset_decoder ARGS((g722_dec_stream *st, short mode));
+size_t g722_stream_decode ARGS((g722_dec_stream *st, short *code,
+                                size_t ncode, short *outcode));
+
+#endif /* G722_STREAM_H */
+/* ................. End of file g722_stream.h .................................. */
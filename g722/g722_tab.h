@@ -0,0 +1,30 @@
+/*
+  ============================================================================
+   File: G722_TAB.H                                          v3.0 - 10/Jan/2007
+  ============================================================================
+
+                            UGST/ITU-T G722 MODULE
+
+                     TABLES SHARED INSIDE THE MODULE
+
+   Tables defined in funcg722.c that are also used by the batched encoder
+   (g722_mc.c). This header is internal to the G.722 module: it is not
+   included by g722.h, and the tables are not part of the user interface.
+
+   History:
+   first version, for the batched encoder
+  ============================================================================
+*/
+#ifndef G722_TAB_H
+#define G722_TAB_H 200
+
+#include "stl.h"
+
+/* Table ILA used by scalel and scaleh */
+extern Word16 g722_ila[353];
+
+/* Coefficients for both transmission and reception QMF */
+extern Word16 g722_coef_qmf[24];
+
+#endif /* G722_TAB_H */
+/* ................. End of file g722_tab.h .................................. */
@@ -17,6 +17,8 @@
   and the 7kHz ADPCM bitstream is left-adjusted, i.e., the codewords are 
   located in the lower 8-bits of the encoded bitstream file. The MSB is
   always 0 for the bitstream file.
+  With option -packed, the bitstream file instead holds one codeword
+  per byte, with no padding.
   
   Usage:
   ~~~~~~
@@ -40,6 +42,8 @@
   -enc        run only the encoder [default: encoder and decoder]
   -dec        run only the decoder [default: encoder and decoder]
   -noreset    don't apply reset to the encoder/decoder
+  -packed     bitstream file holds one codeword per byte instead of one 
+              per 16-bit word
   -q          quiet operation (don't print progress flag)
   -?/-help    print help message
 
@@ -63,6 +67,7 @@
                        size was not a multiple of the block size
                        N. <simao>
   10.Jan.07    v3.0    Added some castings to avoid warnings
+               v3.1    Added option -packed for byte-oriented bitstreams
   ============================================================================
 */
 
@@ -95,6 +100,10 @@ void display_usage ARGS((void));
 #include "arc_profile.h"
 #include "helper_lib.h"
 #include "rt_checks.h"
+#elif defined(NATIVE_CYCLE_PROFILING)
+#include <stdint.h>
+#include "arc_profile.h"
+#include "helper_lib.h"
 #endif
 
 
@@ -138,6 +147,7 @@ void display_usage()
   P(("  -enc        run only the encoder [default: encoder and decoder]\n"));
   P(("  -dec        run only the decoder [default: encoder and decoder]\n"));
   P(("  -noreset    don't apply reset to the encoder/decoder\n"));
+  P(("  -packed     bitstream file with one codeword per byte\n"));
   P(("  -?/-help    print help message\n"));
   P(("  -q          quiet operation (don't print progress flag)\n"));
 
@@ -173,13 +183,18 @@ char *argv[];
   /* Encode and decode operation specification: both as default */
   char encode=1, decode=1;
 
+  /* Bitstream with one codeword per byte instead of per 16-bit word */
+  char packed=0;
+
   /* Sample buffers */
 #ifdef STATIC_ALLOCATION
   Word16   code[DFT_BLK];
   Word16   incode[DFT_BLK], outcode[DFT_BLK];
+  unsigned char pcode[DFT_BLK];
 #else
   Word16   *code=NULL; /* Bitstream buffer */
   Word16   *incode=NULL, *outcode=NULL; /*Input and output buffers */
+  unsigned char *pcode=NULL; /* Packed bitstream buffer */
 #endif
   Word16   *inp_buf, *cod_buf, *out_buf;
 
@@ -253,6 +268,15 @@ char *argv[];
 	argv++;
 	argc--;
       }
+      else if (strcmp(argv[1], "-packed") == 0)
+      {
+	/* Byte-oriented bitstream */
+	packed = 1;
+
+	/* Move argv over the option to the next argument */
+	argv++;
+	argc--;
+      }
       else if (strcmp(argv[1], "-frame") == 0)
       {
 	/* Define Frame size for rate change during operation */
@@ -344,6 +368,11 @@ char *argv[];
     if (cod_buf==NULL) HARAKIRI("Error alocating bitstream buffer\n",3);
     if (out_buf==NULL) HARAKIRI("Error alocating output buffer\n",3);
   }
+  if (packed)
+  {
+    pcode = (unsigned char *) calloc(N, sizeof(unsigned char));
+    if (pcode==NULL) HARAKIRI("Error alocating bitstream buffer\n",3);
+  }
 #endif
 
   /* Reset lower and upper band encoders and define input/output buffers */
@@ -396,7 +425,9 @@ char *argv[];
   
 
 #endif
-  while ((read1 = fread(incode, sizeof (short), N, inp)) != 0)
+  while ((read1 = (packed && !encode)
+                  ? fread(pcode, sizeof (unsigned char), N, inp)
+                  : fread(incode, sizeof (short), N, inp)) != 0)
   {
     /* print progress flag */
     if (!quiet)
@@ -439,7 +470,10 @@ char *argv[];
 #endif
 
       /* Encode */
-      smpno = g722_encode(inp_buf, code, read1, &encoder);
+      if (packed)
+        smpno = g722_encode_packed(inp_buf, pcode, read1, &encoder);
+      else
+        smpno = g722_encode(inp_buf, code, read1, &encoder);
       
 #ifdef NATIVE_CYCLE_PROFILING
         profile_frame_postprocess(&app_settings);
@@ -478,7 +512,10 @@ char *argv[];
         profile_frame_preprocess(&app_settings);
 #endif
       /* Decode */
-      smpno = g722_decode(cod_buf, outcode, mode, (short)read1, &decoder);
+      if (packed)
+        smpno = g722_decode_packed(pcode, outcode, mode, read1, &decoder);
+      else
+        smpno = g722_decode(cod_buf, outcode, mode, (short)read1, &decoder);
 
  
       /* Modify read1 to the expected no.of decoded reconstructed samples */
@@ -534,7 +571,12 @@ char *argv[];
     iter += smpno;
 
     /* Save bitstream or decoded samples */
-    if (fwrite(out_buf, sizeof (Word16), read1, out) != (size_t)read1)
+    if (packed && !decode)
+    {
+      if (fwrite(pcode, sizeof (unsigned char), read1, out) != (size_t)read1)
+        KILL(FileOut,-4);
+    }
+    else if (fwrite(out_buf, sizeof (Word16), read1, out) != (size_t)read1)
       KILL(FileOut,-4);
   }
 
@@ -558,6 +600,8 @@ char *argv[];
     free(out_buf);
     free(cod_buf);
   }
+  if (packed)
+    free(pcode);
 #endif
 
   /* Close input and output files */
@@ -28,11 +28,11 @@ CFLAGS = -I../basop -I../utl -I../eid
 
 SB_LOC = ../eid
 
-G722ENC_OBJ = funcg722.obj g722.obj ../basop/basop32.obj ../basop/control.obj ../basop/count.obj ../basop/enh1632.obj encg722.obj
+G722ENC_OBJ = funcg722.obj g722.obj g722_mc.obj g722_pool.obj g722_stream.obj ../basop/basop32.obj ../basop/control.obj ../basop/count.obj ../basop/enh1632.obj encg722.obj
 
-G722DEC_OBJ = funcg722.obj g722.obj $(SB_LOC)/softbit.obj ../basop/basop32.obj ../basop/control.obj ../basop/count.obj ../basop/enh1632.obj decg722.obj
+G722DEC_OBJ = funcg722.obj g722.obj g722_mc.obj g722_pool.obj g722_stream.obj $(SB_LOC)/softbit.obj ../basop/basop32.obj ../basop/control.obj ../basop/count.obj ../basop/enh1632.obj decg722.obj
 
-G722DEMO_OBJ = funcg722.obj g722.obj $(SB_LOC)/softbit.obj ../basop/basop32.obj ../basop/control.obj ../basop/count.obj ../basop/enh1632.obj g722demo.obj
+G722DEMO_OBJ = funcg722.obj g722.obj g722_mc.obj g722_pool.obj g722_stream.obj $(SB_LOC)/softbit.obj ../basop/basop32.obj ../basop/control.obj ../basop/count.obj ../basop/enh1632.obj g722demo.obj
 
 
 # ------------------------------------
@@ -89,13 +89,13 @@ veryclean: clean cleantest
 # ------------------------------------
 encg722: encg722.exe
 encg722.exe: $(G722ENC_OBJ)
-	$(CC) $(CFLAGS) -o encg722 funcg722.obj g722.obj basop32.obj control.obj count.obj enh1632.obj encg722.obj  
+	$(CC) $(CFLAGS) -o encg722 funcg722.obj g722.obj g722_mc.obj g722_pool.obj g722_stream.obj basop32.obj control.obj count.obj enh1632.obj encg722.obj  
 
 decg722: decg722.exe
 decg722.exe: $(G722DEC_OBJ) 
-	$(CC) $(CFLAGS) -o decg722 funcg722.obj g722.obj softbit.obj basop32.obj control.obj count.obj enh1632.obj decg722.obj 
+	$(CC) $(CFLAGS) -o decg722 funcg722.obj g722.obj g722_mc.obj g722_pool.obj g722_stream.obj softbit.obj basop32.obj control.obj count.obj enh1632.obj decg722.obj 
 
 g722demo: g722demo.exe
 g722demo.exe: $(G722DEMO_OBJ)
-	$(CC) $(CFLAGS) -o g722demo funcg722.obj g722.obj softbit.obj basop32.obj control.obj count.obj enh1632.obj g722demo.obj 
+	$(CC) $(CFLAGS) -o g722demo funcg722.obj g722.obj g722_mc.obj g722_pool.obj g722_stream.obj softbit.obj basop32.obj control.obj count.obj enh1632.obj g722demo.obj 
  
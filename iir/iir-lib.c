@@ -1,4 +1,4 @@
-/*                                                           v3.1 - 22/Feb/1996
+/*                                                           v3.4 - 17/Oct/2026
   =============================================================================
 
                           U    U   GGG    SSSS  TTTTT
@@ -51,6 +51,16 @@ FUNCTIONS    : - stdpcm_kernel(...)   =  parallel-form IIR filter (kernel)
 	       - direct_iir_kernel(...) = direct-form IIR filter (kernel)
 	       - direct_iir_free(...) = deallocate direct filter memory
 	       - direct_iir_reset(...) = clear direct state variables
+	       - cascade_iir_mc_init(...), cascade_iir_mc_kernel(...),
+	         cascade_iir_mc_reset(...), cascade_iir_mc_free(...),
+	         stdpcm_mc_init(...), stdpcm_mc_kernel(...),
+	         stdpcm_mc_reset(...), stdpcm_mc_free(...) = the same
+	         cascade- and parallel-form filters for many channels
+	         at once (interleaved samples)
+	       - cascade_iir_block_kernel(...),
+	         direct_iir_block_kernel(...) = the cascade- and direct-
+	         form filters for a long signal, in blocks filtered in
+	         parallel
 HISTORY:
 
     16.Dec.91 v0.1 First beta-version <hf@pkinbg.uucp>
@@ -61,6 +71,13 @@ HISTORY:
     22.Feb.96 v3.1 Changed inclusion of stdlib.h to inconditional, as
                    suggested by Kirchherr (FI/DBP Telekom) to run under
 		   OpenVMS/AXP <simao@ctd.comsat.com>
+    17.Oct.26 v3.2 Added multi-channel cascade- and parallel-form
+                   filtering, with SSE2/AVX2 kernels that filter one
+                   channel in each vector lane.
+    17.Oct.26 v3.3 State variables below IIR_FLOOR are flushed to zero
+                   when compiled with FLUSH_DENORMALS.
+    17.Oct.26 v3.4 Added block-parallel filtering of long signals by
+                   cascade- and direct-form filters.
 
   =============================================================================
 */
@@ -72,10 +89,119 @@ HISTORY:
 
 #include <stdlib.h>		  /* General utility definitions */
 #include <math.h>		  /* RTL Math Function Declarations */
+#include <string.h>		  /* memcpy() */
 
 /* Definitions for IIR filters */
 #include "iirflt.h"		  
 
+/* SIMD kernels for the multi-channel filters on x86-64, where the scalar
+ * code also uses SSE arithmetic; define IIR_NO_SIMD to compile the
+ * portable C code only. The AVX2 kernels are compiled in any case and
+ * used if the CPU supports them. */
+#if !defined(IIR_NO_SIMD) && (defined(__x86_64__) || defined(_M_X64))
+#include <emmintrin.h>
+#define IIR_SIMD_SSE2
+#if defined(__GNUC__) || defined(_MSC_VER)
+#include <immintrin.h>
+#define IIR_SIMD_AVX2
+#if defined(__GNUC__)
+#define IIR_AVX2_TARGET __attribute__((target("avx2")))
+#else
+#include <intrin.h>
+#define IIR_AVX2_TARGET
+#endif
+#endif
+#endif
+
+/* With FLUSH_DENORMALS defined, state variables smaller in magnitude
+ * than IIR_FLOOR are set to zero when they are stored. No subnormal
+ * number (slow on most CPUs) is then left in the filter memories, and
+ * a filter fed with zeros reaches an all-zero state instead of decaying
+ * through subnormals. IIR_FLOOR is a float, so that the SIMD kernels
+ * compare the same values as the scalar code. */
+#ifdef FLUSH_DENORMALS
+#define IIR_FLOOR       1e-20F
+#define IIR_FLUSH(t)    (t) = fabs(t) < IIR_FLOOR ? 0.0F : (t)
+#else
+#define IIR_FLUSH(t)
+#endif
+
+/* Conversions float <-> double of the lower and upper halves of a vector */
+#ifdef IIR_SIMD_SSE2
+#define IIR_LO128(v)    _mm_cvtps_pd(v)
+#define IIR_HI128(v)    _mm_cvtps_pd(_mm_movehl_ps(v, v))
+#define IIR_PS128(l, h) _mm_movelh_ps(_mm_cvtpd_ps(l), _mm_cvtpd_ps(h))
+#ifdef FLUSH_DENORMALS
+#define IIR_FLUSH128(v) _mm_andnot_ps(_mm_cmplt_ps(_mm_andnot_ps( \
+                          _mm_set1_ps(-0.0F), v), _mm_set1_ps(IIR_FLOOR)), v)
+#else
+#define IIR_FLUSH128(v) (v)
+#endif
+#endif
+#ifdef IIR_SIMD_AVX2
+#define IIR_LO256(v)    _mm256_cvtps_pd(_mm256_castps256_ps128(v))
+#define IIR_HI256(v)    _mm256_cvtps_pd(_mm256_extractf128_ps(v, 1))
+#define IIR_PS256(l, h) _mm256_insertf128_ps(_mm256_castps128_ps256( \
+                          _mm256_cvtpd_ps(l)), _mm256_cvtpd_ps(h), 1)
+#ifdef FLUSH_DENORMALS
+#define IIR_FLUSH256(v) _mm256_andnot_ps(_mm256_cmp_ps(_mm256_andnot_ps( \
+                          _mm256_set1_ps(-0.0F), v), \
+                          _mm256_set1_ps(IIR_FLOOR), _CMP_LT_OQ), v)
+#else
+#define IIR_FLUSH256(v) (v)
+#endif
+#endif
+
+/* Threads for the block mode (cascade_iir_block_kernel() and
+ * direct_iir_block_kernel()); without IIR_THREADS, the blocks are
+ * filtered one after the other, with the same results. */
+#ifdef IIR_THREADS
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+#endif
+
+/* Zero-input responses shorter than the block are truncated when the
+ * state has decayed below IIR_BLOCK_TOL (relative to a unit state) */
+#define IIR_BLOCK_TOL   1e-12
+
+/* A filter in the block mode: the filter struct, the size of its state
+ * (a float array), and adapters for the kernel, a copy with cleared
+ * state, the address of the state and the deallocation of a copy */
+typedef struct
+{
+  void           *iir;		/* filter struct                      */
+  long            nstate;	/* number of state variables          */
+  long            factor;	/* up- or down-sampling factor        */
+  long           *k0;		/* modulo counter for down-sampling   */
+  int             up;		/* 1 if up-sampling                   */
+  long            (*kernel) ARGS((long lseg, float *x, void *iir, float *y));
+  void           *(*clone) ARGS((void *iir));
+  float          *(*state) ARGS((void *iir));
+  void            (*release) ARGS((void *iir));
+}               IIR_BLOCK_FILTER;
+
+/* Work of the block mode, shared by (or copied to) the threads */
+typedef struct
+{
+  IIR_BLOCK_FILTER *flt;	/* filter                             */
+  float          *x, *y;	/* input and output signals           */
+  long            lseg;		/* number of input samples            */
+  long            lblk;		/* input samples per block            */
+  long            nyblk;	/* output samples per block           */
+  long            nblk;		/* number of blocks                   */
+  long            k0;		/* modulo counter at the start        */
+  void          **blk;		/* filter of each block               */
+  double         *s;		/* start state of each block          */
+  double         *g;		/* zero-input responses, ng per state */
+  long            lg;		/* input samples of the responses     */
+  long            ng;		/* output samples of the responses    */
+  int             step;		/* 1: filter blocks; 3: add responses */
+  long            first, stride;	/* blocks first, first+stride, ...    */
+}               IIR_BLOCK_JOB;
+
 
 
 /*
@@ -127,6 +253,59 @@ DIRECT_IIR *direct_iir_init ARGS((long zno, long pno, float *a, float *b,
                          double gain, long idown, int hswitch));
 
 
+/* Multi-channel filtering basic function prototypes */
+static long cascade_mc_chan ARGS((long lenx, float *x, float *y, long ch,
+                         CASCADE_IIR_MC *iir_ptr));
+static long stdpcm_mc_chan ARGS((long lenx, float *x, float *y, long ch,
+                         SCD_IIR_MC *iir_ptr));
+#ifdef IIR_SIMD_SSE2
+static long cascade_mc_sse2 ARGS((long lenx, float *x, float *y, long ch,
+                         CASCADE_IIR_MC *iir_ptr));
+static long stdpcm_mc_sse2 ARGS((long lenx, float *x, float *y, long ch,
+                         SCD_IIR_MC *iir_ptr));
+#endif
+#ifdef IIR_SIMD_AVX2
+static int  iir_cpu_avx2 ARGS((void));
+static long cascade_mc_avx2 ARGS((long lenx, float *x, float *y, long ch,
+                         CASCADE_IIR_MC *iir_ptr));
+static long stdpcm_mc_avx2 ARGS((long lenx, float *x, float *y, long ch,
+                         SCD_IIR_MC *iir_ptr));
+
+static int  iir_avx2 = -1;	  /* AVX2 kernels usable, -1 if unknown */
+#endif
+
+
+/* Block-mode function prototypes */
+static long iir_block_filter ARGS((long lseg, float *x, float *y, long lblk,
+                         int nthreads, IIR_BLOCK_FILTER *flt));
+static void iir_block_run ARGS((IIR_BLOCK_JOB *job, int step, int nthreads));
+static void iir_block_work ARGS((IIR_BLOCK_JOB *job));
+static void iir_block_free ARGS((IIR_BLOCK_JOB *job, double *phi1, 
+                         float *zero));
+static long iir_blk_nout ARGS((long len, long k0, IIR_BLOCK_FILTER *flt));
+static void iir_mat_mul ARGS((long n, double *a, double *b, double *c));
+static void iir_mat_pow ARGS((long n, double *a, long p, double *c, 
+                         double *tmp));
+static double iir_mat_max ARGS((long n, double *a));
+static long iir_blk_cascade_kernel ARGS((long lseg, float *x, void *iir, 
+                         float *y));
+static void *iir_blk_cascade_clone ARGS((void *iir));
+static float *iir_blk_cascade_state ARGS((void *iir));
+static void iir_blk_cascade_release ARGS((void *iir));
+static long iir_blk_direct_kernel ARGS((long lseg, float *x, void *iir, 
+                         float *y));
+static void *iir_blk_direct_clone ARGS((void *iir));
+static float *iir_blk_direct_state ARGS((void *iir));
+static void iir_blk_direct_release ARGS((void *iir));
+#ifdef IIR_THREADS
+#if defined(_WIN32)
+static DWORD WINAPI iir_block_thread(LPVOID arg);
+#else
+static void *iir_block_thread(void *arg);
+#endif
+#endif
+
+
 /*
  * ...................... BEGIN OF FUNCTIONS .........................
  */
@@ -483,6 +662,7 @@ static long     scd_parallel_form_iir_down_kernel(lenx, x, y, k0, idown,
 	y[ky] += b[n][2] * Ttmp + b[n][1] * T[n][1] + b[n][0] * T[n][0];
 	T[n][0] = T[n][1];
 	T[n][1] = Ttmp;
+	IIR_FLUSH(T[n][1]);
       }
       y[ky] *= gain;
       ky++;
@@ -494,6 +674,7 @@ static long     scd_parallel_form_iir_down_kernel(lenx, x, y, k0, idown,
 	Ttmp = 2. * (x[kx] - c[n][0] * T[n][0] - c[n][1] * T[n][1]);
 	T[n][0] = T[n][1];
 	T[n][1] = Ttmp;
+	IIR_FLUSH(T[n][1]);
       }
     }
     (*k0)++;
@@ -571,6 +752,7 @@ static long     scd_parallel_form_iir_up_kernel(lenx, x, y, iup, nblocks,
 	y[ky] += b[n][2] * Ttmp + b[n][1] * T[n][1] + b[n][0] * T[n][0];
 	T[n][0] = T[n][1];
 	T[n][1] = Ttmp;
+	IIR_FLUSH(T[n][1]);
       }
       y[ky] *= gain;
       kx++;
@@ -585,6 +767,7 @@ static long     scd_parallel_form_iir_up_kernel(lenx, x, y, iup, nblocks,
 	y[ky] += b[n][2] * Ttmp + b[n][1] * T[n][1] + b[n][0] * T[n][0];
 	T[n][0] = T[n][1];
 	T[n][1] = Ttmp;
+	IIR_FLUSH(T[n][1]);
       }
       y[ky] *= gain;
     }
@@ -787,6 +970,8 @@ static long     cascade_form_iir_down_kernel(lenx, x, y, k0, idown,
       T[n][0] = xj;
       T[n][3] = T[n][2];
       T[n][2] = yj;
+      IIR_FLUSH(T[n][0]);
+      IIR_FLUSH(T[n][2]);
 
       /* The yj of this stage is the xj of the next */
       xj = yj;
@@ -880,6 +1065,8 @@ static long     cascade_form_iir_up_kernel(lenx, x, y, iup, nblocks,
       T[n][0] = xj;
       T[n][3] = T[n][2];
       T[n][2] = yj;
+      IIR_FLUSH(T[n][0]);
+      IIR_FLUSH(T[n][2]);
 
       /* The yj of this stage is the xj of the next */
       xj = yj;
@@ -1217,6 +1404,7 @@ static long     direct_form_iir_down_kernel(lenx, x, y, k0, idown,
   {
     /* Save xk in memory */
     T[0][0] = x[kx]; 
+    IIR_FLUSH(T[0][0]);
 
     /* Filter samples through numerator (zero) part */
     for (yj=0, n = 0; n < zerono; n++)    
@@ -1232,6 +1420,7 @@ static long     direct_form_iir_down_kernel(lenx, x, y, k0, idown,
     for (n = poleno-1; n >0; n--)    
       T[n][1] = T[n-1][1];
     T[0][1] = yj;
+    IIR_FLUSH(T[0][1]);
 
     /* Save to output only every "idown" samples */
     if (*k0 % idown == 0)
@@ -1312,6 +1501,7 @@ static long     direct_form_iir_up_kernel(lenx, x, y, iup, zerono, poleno,
      * samples by taking one input sample direct path OR by using a 
      * zero-valued sample; already save on memory array */
     T[0][0] = (ky % iup == 0) ? x[kx] : 0;
+    IIR_FLUSH(T[0][0]);
 
     /* Filter samples through numerator (zero) part */
     for (yj=0, n = 0; n < zerono; n++)    
@@ -1327,6 +1517,7 @@ static long     direct_form_iir_up_kernel(lenx, x, y, iup, zerono, poleno,
     for (n = poleno-1; n >0; n--)    
       T[n][1] = T[n-1][1];
     T[0][1] = yj;
+    IIR_FLUSH(T[0][1]);
 
     /* Apply the gain and update x counter if needed */
     y[ky] = yj * gain;
@@ -1476,4 +1667,1701 @@ void            direct_iir_free(iir_ptr)
 /* ....................... End of direct_iir_free() ....................... */
 
 
+/* *************************************************************************
+   ******** MULTI-CHANNEL FILTERING: MANY SIGNALS, ONE FILTER DESIGN ********
+ * ************************************************************************* */
+
+/*
+  ============================================================================
+
+        CASCADE_IIR_MC *cascade_iir_mc_init (CASCADE_IIR *iir_ptr,
+        ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~  long nchan);
+
+        Description:
+        ~~~~~~~~~~~~
+
+        Allocate & initialize a struct for filtering nchan channels
+        with the cascade-form filter iir_ptr, e.g. as returned by
+        iir_G712_8khz_init(). The coefficients, gain and up/down-
+        sampling factor are taken from iir_ptr, whose coefficient
+        tables are static; iir_ptr itself may be freed afterwards. The
+        state variables of all channels are cleared.
+
+        Parameters:
+        ~~~~~~~~~~~
+        iir_ptr: ... pointer to a cascade-form filter struct
+        nchan: ..... number of channels
+
+        Return value:
+        ~~~~~~~~~~~~~
+        Returns a pointer to struct CASCADE_IIR_MC, or NULL if nchan is
+        not positive or memory can't be allocated.
+
+        History:
+        ~~~~~~~~
+        17.Oct.26 v1.0 Release of 1st version
+
+ ============================================================================
+*/
+CASCADE_IIR_MC *cascade_iir_mc_init(iir_ptr, nchan)
+  CASCADE_IIR    *iir_ptr;
+  long            nchan;
+{
+  CASCADE_IIR_MC *ptrIIR;	  /* pointer to the new struct */
+
+
+  if (iir_ptr == (CASCADE_IIR *) 0 || nchan < 1)
+    return 0;
+
+  /* Allocate memory for a new struct and the state variables */
+  ptrIIR = (CASCADE_IIR_MC *) malloc(sizeof(CASCADE_IIR_MC));
+  if (ptrIIR == (CASCADE_IIR_MC *) 0)
+    return 0;
+  ptrIIR->T = (float *) malloc(iir_ptr->nblocks * 4 * nchan * sizeof(float));
+  if (ptrIIR->T == (float *) 0)
+  {
+    free(ptrIIR);
+    return 0;
+  }
+
+  /* Share the filter design */
+  ptrIIR->nchan = nchan;
+  ptrIIR->nblocks = iir_ptr->nblocks;
+  ptrIIR->a = iir_ptr->a;
+  ptrIIR->b = iir_ptr->b;
+  ptrIIR->idown = iir_ptr->idown;
+  ptrIIR->gain = iir_ptr->gain;
+  ptrIIR->hswitch = iir_ptr->hswitch;
+
+  /* Clear state variables */
+  cascade_iir_mc_reset(ptrIIR);
+
+#ifdef IIR_SIMD_AVX2
+  if (iir_avx2 < 0)
+    iir_avx2 = iir_cpu_avx2();
+#endif
+
+  return (ptrIIR);
+}
+/* ..................... End of cascade_iir_mc_init() ..................... */
+
+
+/*
+  ============================================================================
+
+        void cascade_iir_mc_reset (CASCADE_IIR_MC *iir_ptr);
+        ~~~~~~~~~~~~~~~~~~~~~~~~~
+
+        Description:
+        ~~~~~~~~~~~~
+
+        Clear the state variables of all channels of a multi-channel
+        cascade-form filter.
+
+        Parameters:
+        ~~~~~~~~~~~
+        iir_ptr: ... pointer to struct CASCADE_IIR_MC
+
+        Return value:
+        ~~~~~~~~~~~~~
+        Nothing.
+
+        History:
+        ~~~~~~~~
+        17.Oct.26 v1.0 Release of 1st version
+
+ ============================================================================
+*/
+void            cascade_iir_mc_reset(iir_ptr)
+  CASCADE_IIR_MC *iir_ptr;
+{
+  long            k;
+
+  for (k = 0; k < iir_ptr->nblocks * 4 * iir_ptr->nchan; k++)
+    iir_ptr->T[k] = 0.0;
+
+  iir_ptr->k0 = iir_ptr->idown;	  /* modulo counter for down-sampling */
+}
+/* .................... End of cascade_iir_mc_reset() ..................... */
+
+
+/*
+  ============================================================================
+
+        void cascade_iir_mc_free (CASCADE_IIR_MC *iir_ptr);
+        ~~~~~~~~~~~~~~~~~~~~~~~~
+
+        Description:
+        ~~~~~~~~~~~~
+
+        Deallocate a multi-channel cascade-form filter. The coefficient
+        tables are not freed.
+
+        Parameters:
+        ~~~~~~~~~~~
+        iir_ptr: ... pointer to struct CASCADE_IIR_MC
+
+        Return value:
+        ~~~~~~~~~~~~~
+        Nothing.
+
+        History:
+        ~~~~~~~~
+        17.Oct.26 v1.0 Release of 1st version
+
+ ============================================================================
+*/
+void            cascade_iir_mc_free(iir_ptr)
+  CASCADE_IIR_MC *iir_ptr;
+{
+  free(iir_ptr->T);		  /* free state variables */
+  free(iir_ptr);		  /* free allocated struct */
+}
+/* ..................... End of cascade_iir_mc_free() ..................... */
+
+
+/*
+  ============================================================================
+
+        long cascade_iir_mc_kernel (long lseg, float *x_ptr,
+        ~~~~~~~~~~~~~~~~~~~~~~~~~~  CASCADE_IIR_MC *iir_ptr,
+                                    float *y_ptr);
+
+        Description:
+        ~~~~~~~~~~~~
+
+        Cascade-form IIR filtering of nchan channels, for both up- and
+        down-sampling. Samples are interleaved: sample k of channel ch
+        is x_ptr[k*nchan+ch], and likewise for y_ptr. Each channel gets
+        exactly the output of cascade_iir_kernel() on that channel
+        alone.
+
+        Channels are filtered in groups of 8 (AVX2, if the CPU supports
+        it) and 4 (SSE2) in vector lanes, and the rest one by one. Each
+        lane does the same float and double operations as the scalar
+        code, in the same order, and the state variables of a group are
+        contiguous, since they are stored interleaved:
+        T[(4*n+j)*nchan+ch] for T[n][j] of channel ch.
+
+        Parameters:
+        ~~~~~~~~~~~
+        lseg: ...... number of input samples per channel
+        x_ptr: ..... array with lseg*nchan input samples
+        iir_ptr: ... pointer to struct CASCADE_IIR_MC
+        y_ptr: ..... output samples
+
+        Return value:
+        ~~~~~~~~~~~~~
+        Returns the number of output samples per channel.
+
+        History:
+        ~~~~~~~~
+        17.Oct.26 v1.0 Release of 1st version
+
+ ============================================================================
+*/
+long            cascade_iir_mc_kernel(lseg, x_ptr, iir_ptr, y_ptr)
+  long            lseg;
+  float          *x_ptr;
+  CASCADE_IIR_MC *iir_ptr;
+  float          *y_ptr;
+{
+  long            ch, ky;
+
+  ky = 0;
+  ch = 0;
+#ifdef IIR_SIMD_AVX2
+  if (iir_avx2 > 0)
+    for (; ch + 8 <= iir_ptr->nchan; ch += 8)
+      ky = cascade_mc_avx2(lseg, x_ptr, y_ptr, ch, iir_ptr);
+#endif
+#ifdef IIR_SIMD_SSE2
+  for (; ch + 4 <= iir_ptr->nchan; ch += 4)
+    ky = cascade_mc_sse2(lseg, x_ptr, y_ptr, ch, iir_ptr);
+#endif
+  for (; ch < iir_ptr->nchan; ch++)
+    ky = cascade_mc_chan(lseg, x_ptr, y_ptr, ch, iir_ptr);
+
+  /* The modulo counter is the same for all channels */
+  if (iir_ptr->hswitch != 'U')
+    iir_ptr->k0 = (iir_ptr->k0 + lseg) % iir_ptr->idown;
+
+  return ky;
+}
+/* .................... End of cascade_iir_mc_kernel() .................... */
+
+
+/*
+  ============================================================================
+
+        long cascade_mc_chan (long lenx, float *x, float *y, long ch,
+        ~~~~~~~~~~~~~~~~~~~~  CASCADE_IIR_MC *iir_ptr);
+
+        Description:
+        ~~~~~~~~~~~~
+
+        Filters channel ch of a multi-channel cascade-form filter; the
+        same as cascade_form_iir_down_kernel() and
+        cascade_form_iir_up_kernel(), with interleaved samples and state
+        variables. The modulo counter iir_ptr->k0 is not updated.
+
+        Parameters:
+        ~~~~~~~~~~~
+        lenx: ...... (In) number of input samples per channel
+        x: ......... (In) array with interleaved input samples
+        y: ......... (Out) array with interleaved output samples
+        ch: ........ (In) channel
+        iir_ptr: ... (In/Out) pointer to struct CASCADE_IIR_MC
+
+        Return value:
+        ~~~~~~~~~~~~~
+        Returns the number of output samples.
+
+        History:
+        ~~~~~~~~
+        17.Oct.26 v1.0 Release of 1st version
+
+ ============================================================================
+*/
+static long     cascade_mc_chan(lenx, x, y, ch, iir_ptr)
+  long            lenx;
+  float          *x, *y;
+  long            ch;
+  CASCADE_IIR_MC *iir_ptr;
+{
+  long            nchan, idown, nk, k0, k, ky, n;
+  int             up;
+  float           (*a)[2], (*b)[2], *Tn;
+  double          xj, yj;
+
+  nchan = iir_ptr->nchan;
+  idown = iir_ptr->idown;
+  up = iir_ptr->hswitch == 'U';
+  nk = up ? idown * lenx : lenx;
+  a = iir_ptr->a;
+  b = iir_ptr->b;
+
+  k0 = iir_ptr->k0;
+  ky = 0;
+  yj = 0.;
+  for (k = 0; k < nk; k++)
+  {
+    if (!up)
+      xj = x[k * nchan + ch];
+    else if (k % idown == 0)
+      xj = x[k / idown * nchan + ch];
+    else
+      xj = 0.;
+
+    /* Filter samples through all cascade stages */
+    for (Tn = &iir_ptr->T[ch], n = 0; n < iir_ptr->nblocks;
+         Tn += 4 * nchan, n++)
+    {
+      yj = xj + a[n][0] * Tn[0] + a[n][1] * Tn[nchan];
+      yj -= (b[n][0] * Tn[2 * nchan] + b[n][1] * Tn[3 * nchan]);
+
+      /* Save samples in memory */
+      Tn[nchan] = Tn[0];
+      Tn[0] = xj;
+      Tn[3 * nchan] = Tn[2 * nchan];
+      Tn[2 * nchan] = yj;
+      IIR_FLUSH(Tn[0]);
+      IIR_FLUSH(Tn[2 * nchan]);
+
+      /* The yj of this stage is the xj of the next */
+      xj = yj;
+    }
+
+    if (up || k0 % idown == 0)
+      y[ky++ * nchan + ch] = yj * iir_ptr->gain;
+    k0++;
+  }
+  return ky;
+}
+/* ...................... End of cascade_mc_chan() ....................... */
+
+
+#ifdef IIR_SIMD_SSE2
+/*
+  ============================================================================
+
+        long cascade_mc_sse2 (long lenx, float *x, float *y, long ch,
+        ~~~~~~~~~~~~~~~~~~~~  CASCADE_IIR_MC *iir_ptr);
+
+        long cascade_mc_avx2 (long lenx, float *x, float *y, long ch,
+        ~~~~~~~~~~~~~~~~~~~~  CASCADE_IIR_MC *iir_ptr);
+
+        Description:
+        ~~~~~~~~~~~~
+
+        Same as cascade_mc_chan() for the 4 (SSE2) or 8 (AVX2) channels
+        from ch on, one in each vector lane. The products of the
+        coefficients and the state variables are computed in float, and
+        the sums with the input of the stage in double, as in the scalar
+        code.
+
+        Parameters:
+        ~~~~~~~~~~~
+        See cascade_mc_chan().
+
+        Return value:
+        ~~~~~~~~~~~~~
+        Returns the number of output samples.
+
+        History:
+        ~~~~~~~~
+        17.Oct.26 v1.0 Release of 1st version
+
+ ============================================================================
+*/
+static long     cascade_mc_sse2(lenx, x, y, ch, iir_ptr)
+  long            lenx;
+  float          *x, *y;
+  long            ch;
+  CASCADE_IIR_MC *iir_ptr;
+{
+  long            nchan, idown, nk, k0, k, ky, n;
+  int             up;
+  float           (*a)[2], (*b)[2], *Tn;
+  __m128          xs, t0, t1, t2, t3, p0, p1, q;
+  __m128d         xl, xh, yl, yh, g;
+
+  nchan = iir_ptr->nchan;
+  idown = iir_ptr->idown;
+  up = iir_ptr->hswitch == 'U';
+  nk = up ? idown * lenx : lenx;
+  a = iir_ptr->a;
+  b = iir_ptr->b;
+  g = _mm_set1_pd(iir_ptr->gain);
+
+  k0 = iir_ptr->k0;
+  ky = 0;
+  yl = yh = _mm_setzero_pd();
+  for (k = 0; k < nk; k++)
+  {
+    if (!up)
+      xs = _mm_loadu_ps(&x[k * nchan + ch]);
+    else if (k % idown == 0)
+      xs = _mm_loadu_ps(&x[k / idown * nchan + ch]);
+    else
+      xs = _mm_setzero_ps();
+    xl = IIR_LO128(xs);
+    xh = IIR_HI128(xs);
+
+    for (Tn = &iir_ptr->T[ch], n = 0; n < iir_ptr->nblocks;
+         Tn += 4 * nchan, n++)
+    {
+      t0 = _mm_loadu_ps(Tn);
+      t1 = _mm_loadu_ps(Tn + nchan);
+      t2 = _mm_loadu_ps(Tn + 2 * nchan);
+      t3 = _mm_loadu_ps(Tn + 3 * nchan);
+      p0 = _mm_mul_ps(_mm_set1_ps(a[n][0]), t0);
+      p1 = _mm_mul_ps(_mm_set1_ps(a[n][1]), t1);
+      q = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(b[n][0]), t2),
+                     _mm_mul_ps(_mm_set1_ps(b[n][1]), t3));
+      yl = _mm_sub_pd(_mm_add_pd(_mm_add_pd(xl, IIR_LO128(p0)),
+                                 IIR_LO128(p1)), IIR_LO128(q));
+      yh = _mm_sub_pd(_mm_add_pd(_mm_add_pd(xh, IIR_HI128(p0)),
+                                 IIR_HI128(p1)), IIR_HI128(q));
+
+      _mm_storeu_ps(Tn + nchan, t0);
+      _mm_storeu_ps(Tn, IIR_FLUSH128(IIR_PS128(xl, xh)));
+      _mm_storeu_ps(Tn + 3 * nchan, t2);
+      _mm_storeu_ps(Tn + 2 * nchan, IIR_FLUSH128(IIR_PS128(yl, yh)));
+
+      xl = yl;
+      xh = yh;
+    }
+
+    if (up || k0 % idown == 0)
+      _mm_storeu_ps(&y[ky++ * nchan + ch],
+                    IIR_PS128(_mm_mul_pd(yl, g), _mm_mul_pd(yh, g)));
+    k0++;
+  }
+  return ky;
+}
+/* ...................... End of cascade_mc_sse2() ....................... */
+#endif
+
+
+#ifdef IIR_SIMD_AVX2
+IIR_AVX2_TARGET
+static long     cascade_mc_avx2(long lenx, float *x, float *y, long ch,
+                                CASCADE_IIR_MC *iir_ptr)
+{
+  long            nchan, idown, nk, k0, k, ky, n;
+  int             up;
+  float           (*a)[2], (*b)[2], *Tn;
+  __m256          xs, t0, t1, t2, t3, p0, p1, q;
+  __m256d         xl, xh, yl, yh, g;
+
+  nchan = iir_ptr->nchan;
+  idown = iir_ptr->idown;
+  up = iir_ptr->hswitch == 'U';
+  nk = up ? idown * lenx : lenx;
+  a = iir_ptr->a;
+  b = iir_ptr->b;
+  g = _mm256_set1_pd(iir_ptr->gain);
+
+  k0 = iir_ptr->k0;
+  ky = 0;
+  yl = yh = _mm256_setzero_pd();
+  for (k = 0; k < nk; k++)
+  {
+    if (!up)
+      xs = _mm256_loadu_ps(&x[k * nchan + ch]);
+    else if (k % idown == 0)
+      xs = _mm256_loadu_ps(&x[k / idown * nchan + ch]);
+    else
+      xs = _mm256_setzero_ps();
+    xl = IIR_LO256(xs);
+    xh = IIR_HI256(xs);
+
+    for (Tn = &iir_ptr->T[ch], n = 0; n < iir_ptr->nblocks;
+         Tn += 4 * nchan, n++)
+    {
+      t0 = _mm256_loadu_ps(Tn);
+      t1 = _mm256_loadu_ps(Tn + nchan);
+      t2 = _mm256_loadu_ps(Tn + 2 * nchan);
+      t3 = _mm256_loadu_ps(Tn + 3 * nchan);
+      p0 = _mm256_mul_ps(_mm256_set1_ps(a[n][0]), t0);
+      p1 = _mm256_mul_ps(_mm256_set1_ps(a[n][1]), t1);
+      q = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(b[n][0]), t2),
+                        _mm256_mul_ps(_mm256_set1_ps(b[n][1]), t3));
+      yl = _mm256_sub_pd(_mm256_add_pd(_mm256_add_pd(xl, IIR_LO256(p0)),
+                                       IIR_LO256(p1)), IIR_LO256(q));
+      yh = _mm256_sub_pd(_mm256_add_pd(_mm256_add_pd(xh, IIR_HI256(p0)),
+                                       IIR_HI256(p1)), IIR_HI256(q));
+
+      _mm256_storeu_ps(Tn + nchan, t0);
+      _mm256_storeu_ps(Tn, IIR_FLUSH256(IIR_PS256(xl, xh)));
+      _mm256_storeu_ps(Tn + 3 * nchan, t2);
+      _mm256_storeu_ps(Tn + 2 * nchan, IIR_FLUSH256(IIR_PS256(yl, yh)));
+
+      xl = yl;
+      xh = yh;
+    }
+
+    if (up || k0 % idown == 0)
+      _mm256_storeu_ps(&y[ky++ * nchan + ch],
+                       IIR_PS256(_mm256_mul_pd(yl, g), _mm256_mul_pd(yh, g)));
+    k0++;
+  }
+  return ky;
+}
+/* ...................... End of cascade_mc_avx2() ....................... */
+#endif
+
+
+/* *********************************************************************** */
+
+/*
+  ============================================================================
+
+        SCD_IIR_MC *stdpcm_mc_init (SCD_IIR *iir_ptr, long nchan);
+        ~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+        Description:
+        ~~~~~~~~~~~~
+
+        Allocate & initialize a struct for filtering nchan channels
+        with the parallel-form filter iir_ptr, e.g. as returned by
+        stdpcm_16khz_init(). The coefficients, gains and up/down-
+        sampling factor are taken from iir_ptr, whose coefficient
+        tables are static; iir_ptr itself may be freed afterwards. The
+        state variables of all channels are cleared.
+
+        Parameters:
+        ~~~~~~~~~~~
+        iir_ptr: ... pointer to a parallel-form filter struct
+        nchan: ..... number of channels
+
+        Return value:
+        ~~~~~~~~~~~~~
+        Returns a pointer to struct SCD_IIR_MC, or NULL if nchan is not
+        positive or memory can't be allocated.
+
+        History:
+        ~~~~~~~~
+        17.Oct.26 v1.0 Release of 1st version
+
+ ============================================================================
+*/
+SCD_IIR_MC     *stdpcm_mc_init(iir_ptr, nchan)
+  SCD_IIR        *iir_ptr;
+  long            nchan;
+{
+  SCD_IIR_MC     *ptrIIR;	  /* pointer to the new struct */
+
+
+  if (iir_ptr == (SCD_IIR *) 0 || nchan < 1)
+    return 0;
+
+  /* Allocate memory for a new struct and the state variables */
+  ptrIIR = (SCD_IIR_MC *) malloc(sizeof(SCD_IIR_MC));
+  if (ptrIIR == (SCD_IIR_MC *) 0)
+    return 0;
+  ptrIIR->T = (float *) malloc(iir_ptr->nblocks * 2 * nchan * sizeof(float));
+  if (ptrIIR->T == (float *) 0)
+  {
+    free(ptrIIR);
+    return 0;
+  }
+
+  /* Share the filter design */
+  ptrIIR->nchan = nchan;
+  ptrIIR->nblocks = iir_ptr->nblocks;
+  ptrIIR->b = iir_ptr->b;
+  ptrIIR->c = iir_ptr->c;
+  ptrIIR->idown = iir_ptr->idown;
+  ptrIIR->gain = iir_ptr->gain;
+  ptrIIR->direct_cof = iir_ptr->direct_cof;
+  ptrIIR->hswitch = iir_ptr->hswitch;
+
+  /* Clear state variables */
+  stdpcm_mc_reset(ptrIIR);
+
+#ifdef IIR_SIMD_AVX2
+  if (iir_avx2 < 0)
+    iir_avx2 = iir_cpu_avx2();
+#endif
+
+  return (ptrIIR);
+}
+/* ....................... End of stdpcm_mc_init() ....................... */
+
+
+/*
+  ============================================================================
+
+        void stdpcm_mc_reset (SCD_IIR_MC *iir_ptr);
+        ~~~~~~~~~~~~~~~~~~~~
+
+        Description:
+        ~~~~~~~~~~~~
+
+        Clear the state variables of all channels of a multi-channel
+        parallel-form filter.
+
+        Parameters:
+        ~~~~~~~~~~~
+        iir_ptr: ... pointer to struct SCD_IIR_MC
+
+        Return value:
+        ~~~~~~~~~~~~~
+        Nothing.
+
+        History:
+        ~~~~~~~~
+        17.Oct.26 v1.0 Release of 1st version
+
+ ============================================================================
+*/
+void            stdpcm_mc_reset(iir_ptr)
+  SCD_IIR_MC     *iir_ptr;
+{
+  long            k;
+
+  for (k = 0; k < iir_ptr->nblocks * 2 * iir_ptr->nchan; k++)
+    iir_ptr->T[k] = 0.0;
+
+  iir_ptr->k0 = iir_ptr->idown;	  /* modulo counter for down-sampling */
+}
+/* ....................... End of stdpcm_mc_reset() ...................... */
+
+
+/*
+  ============================================================================
+
+        void stdpcm_mc_free (SCD_IIR_MC *iir_ptr);
+        ~~~~~~~~~~~~~~~~~~~
+
+        Description:
+        ~~~~~~~~~~~~
+
+        Deallocate a multi-channel parallel-form filter. The coefficient
+        tables are not freed.
+
+        Parameters:
+        ~~~~~~~~~~~
+        iir_ptr: ... pointer to struct SCD_IIR_MC
+
+        Return value:
+        ~~~~~~~~~~~~~
+        Nothing.
+
+        History:
+        ~~~~~~~~
+        17.Oct.26 v1.0 Release of 1st version
+
+ ============================================================================
+*/
+void            stdpcm_mc_free(iir_ptr)
+  SCD_IIR_MC     *iir_ptr;
+{
+  free(iir_ptr->T);		  /* free state variables */
+  free(iir_ptr);		  /* free allocated struct */
+}
+/* ....................... End of stdpcm_mc_free() ....................... */
+
+
+/*
+  ============================================================================
+
+        long stdpcm_mc_kernel (long lseg, float *x_ptr,
+        ~~~~~~~~~~~~~~~~~~~~~  SCD_IIR_MC *iir_ptr, float *y_ptr);
+
+        Description:
+        ~~~~~~~~~~~~
+
+        Parallel-form IIR filtering of nchan channels, for both up- and
+        down-sampling. Samples are interleaved: sample k of channel ch
+        is x_ptr[k*nchan+ch], and likewise for y_ptr. Each channel gets
+        exactly the output of stdpcm_kernel() on that channel alone.
+
+        Channels are filtered in groups of 8 (AVX2, if the CPU supports
+        it) and 4 (SSE2) in vector lanes, and the rest one by one, as in
+        cascade_iir_mc_kernel(). The state variables are stored
+        interleaved: T[(2*n+j)*nchan+ch] for T[n][j] of channel ch.
+
+        Parameters:
+        ~~~~~~~~~~~
+        lseg: ...... number of input samples per channel
+        x_ptr: ..... array with lseg*nchan input samples
+        iir_ptr: ... pointer to struct SCD_IIR_MC
+        y_ptr: ..... output samples
+
+        Return value:
+        ~~~~~~~~~~~~~
+        Returns the number of output samples per channel.
+
+        History:
+        ~~~~~~~~
+        17.Oct.26 v1.0 Release of 1st version
+
+ ============================================================================
+*/
+long            stdpcm_mc_kernel(lseg, x_ptr, iir_ptr, y_ptr)
+  long            lseg;
+  float          *x_ptr;
+  SCD_IIR_MC     *iir_ptr;
+  float          *y_ptr;
+{
+  long            ch, ky;
+
+  ky = 0;
+  ch = 0;
+#ifdef IIR_SIMD_AVX2
+  if (iir_avx2 > 0)
+    for (; ch + 8 <= iir_ptr->nchan; ch += 8)
+      ky = stdpcm_mc_avx2(lseg, x_ptr, y_ptr, ch, iir_ptr);
+#endif
+#ifdef IIR_SIMD_SSE2
+  for (; ch + 4 <= iir_ptr->nchan; ch += 4)
+    ky = stdpcm_mc_sse2(lseg, x_ptr, y_ptr, ch, iir_ptr);
+#endif
+  for (; ch < iir_ptr->nchan; ch++)
+    ky = stdpcm_mc_chan(lseg, x_ptr, y_ptr, ch, iir_ptr);
+
+  /* The modulo counter is the same for all channels */
+  if (iir_ptr->hswitch != 'U')
+    iir_ptr->k0 = (iir_ptr->k0 + lseg) % iir_ptr->idown;
+
+  return ky;
+}
+/* ...................... End of stdpcm_mc_kernel() ...................... */
+
+
+/*
+  ============================================================================
+
+        long stdpcm_mc_chan (long lenx, float *x, float *y, long ch,
+        ~~~~~~~~~~~~~~~~~~~  SCD_IIR_MC *iir_ptr);
+
+        Description:
+        ~~~~~~~~~~~~
+
+        Filters channel ch of a multi-channel parallel-form filter; the
+        same as scd_parallel_form_iir_down_kernel() and
+        scd_parallel_form_iir_up_kernel(), with interleaved samples and
+        state variables. The modulo counter iir_ptr->k0 is not updated.
+
+        Parameters:
+        ~~~~~~~~~~~
+        lenx: ...... (In) number of input samples per channel
+        x: ......... (In) array with interleaved input samples
+        y: ......... (Out) array with interleaved output samples
+        ch: ........ (In) channel
+        iir_ptr: ... (In/Out) pointer to struct SCD_IIR_MC
+
+        Return value:
+        ~~~~~~~~~~~~~
+        Returns the number of output samples.
+
+        History:
+        ~~~~~~~~
+        17.Oct.26 v1.0 Release of 1st version
+
+ ============================================================================
+*/
+static long     stdpcm_mc_chan(lenx, x, y, ch, iir_ptr)
+  long            lenx;
+  float          *x, *y;
+  long            ch;
+  SCD_IIR_MC     *iir_ptr;
+{
+  long            nchan, idown, nk, k0, k, ky, n;
+  int             up, in;
+  float           (*b)[3], (*c)[2], *Tn;
+  float           xk, yk, Ttmp;
+
+  nchan = iir_ptr->nchan;
+  idown = iir_ptr->idown;
+  up = iir_ptr->hswitch == 'U';
+  nk = up ? idown * lenx : lenx;
+  b = iir_ptr->b;
+  c = iir_ptr->c;
+
+  k0 = iir_ptr->k0;
+  ky = 0;
+  for (k = 0; k < nk; k++)
+  {
+    in = !up || k % idown == 0;	  /* input sample, or zero */
+    xk = in ? x[(up ? k / idown : k) * nchan + ch] : 0;
+
+    if (up || k0 % idown == 0)	  /* output sample */
+    {
+      yk = in ? iir_ptr->direct_cof * xk : 0.0;
+      for (Tn = &iir_ptr->T[ch], n = 0; n < iir_ptr->nblocks;
+           Tn += 2 * nchan, n++)
+      {
+        if (in)
+          Ttmp = 2. * (xk - c[n][0] * Tn[0] - c[n][1] * Tn[nchan]);
+        else
+          Ttmp = 2. * (0.0 - c[n][0] * Tn[0] - c[n][1] * Tn[nchan]);
+        yk += b[n][2] * Ttmp + b[n][1] * Tn[nchan] + b[n][0] * Tn[0];
+        Tn[0] = Tn[nchan];
+        Tn[nchan] = Ttmp;
+        IIR_FLUSH(Tn[nchan]);
+      }
+      y[ky++ * nchan + ch] = yk * iir_ptr->gain;
+    }
+    else
+    {
+      for (Tn = &iir_ptr->T[ch], n = 0; n < iir_ptr->nblocks;
+           Tn += 2 * nchan, n++)
+      {
+        Ttmp = 2. * (xk - c[n][0] * Tn[0] - c[n][1] * Tn[nchan]);
+        Tn[0] = Tn[nchan];
+        Tn[nchan] = Ttmp;
+        IIR_FLUSH(Tn[nchan]);
+      }
+    }
+    k0++;
+  }
+  return ky;
+}
+/* ....................... End of stdpcm_mc_chan() ....................... */
+
+
+#ifdef IIR_SIMD_SSE2
+/*
+  ============================================================================
+
+        long stdpcm_mc_sse2 (long lenx, float *x, float *y, long ch,
+        ~~~~~~~~~~~~~~~~~~~  SCD_IIR_MC *iir_ptr);
+
+        long stdpcm_mc_avx2 (long lenx, float *x, float *y, long ch,
+        ~~~~~~~~~~~~~~~~~~~  SCD_IIR_MC *iir_ptr);
+
+        Description:
+        ~~~~~~~~~~~~
+
+        Same as stdpcm_mc_chan() for the 4 (SSE2) or 8 (AVX2) channels
+        from ch on, one in each vector lane. The blocks run in float,
+        except for the direct path and the gain, and for the zero-valued
+        input samples of up-sampling, which are computed in double as
+        in the scalar code.
+
+        Parameters:
+        ~~~~~~~~~~~
+        See stdpcm_mc_chan().
+
+        Return value:
+        ~~~~~~~~~~~~~
+        Returns the number of output samples.
+
+        History:
+        ~~~~~~~~
+        17.Oct.26 v1.0 Release of 1st version
+
+ ============================================================================
+*/
+static long     stdpcm_mc_sse2(lenx, x, y, ch, iir_ptr)
+  long            lenx;
+  float          *x, *y;
+  long            ch;
+  SCD_IIR_MC     *iir_ptr;
+{
+  long            nchan, idown, nk, k0, k, ky, n;
+  int             up;
+  float           (*b)[3], (*c)[2], *Tn;
+  __m128          xs, ys, t0, t1, tt, p0, p1;
+  __m128d         dl, dh, g, dc, zero;
+
+  nchan = iir_ptr->nchan;
+  idown = iir_ptr->idown;
+  up = iir_ptr->hswitch == 'U';
+  nk = up ? idown * lenx : lenx;
+  b = iir_ptr->b;
+  c = iir_ptr->c;
+  g = _mm_set1_pd(iir_ptr->gain);
+  dc = _mm_set1_pd(iir_ptr->direct_cof);
+  zero = _mm_setzero_pd();
+
+  k0 = iir_ptr->k0;
+  ky = 0;
+  for (k = 0; k < nk; k++)
+  {
+    if (up && k % idown != 0)
+    {
+      /* Zero-valued input sample of up-sampling */
+      ys = _mm_setzero_ps();
+      for (Tn = &iir_ptr->T[ch], n = 0; n < iir_ptr->nblocks;
+           Tn += 2 * nchan, n++)
+      {
+        t0 = _mm_loadu_ps(Tn);
+        t1 = _mm_loadu_ps(Tn + nchan);
+        p0 = _mm_mul_ps(_mm_set1_ps(c[n][0]), t0);
+        p1 = _mm_mul_ps(_mm_set1_ps(c[n][1]), t1);
+        dl = _mm_sub_pd(_mm_sub_pd(zero, IIR_LO128(p0)), IIR_LO128(p1));
+        dh = _mm_sub_pd(_mm_sub_pd(zero, IIR_HI128(p0)), IIR_HI128(p1));
+        tt = IIR_PS128(_mm_add_pd(dl, dl), _mm_add_pd(dh, dh));
+        ys = _mm_add_ps(ys, _mm_add_ps(_mm_add_ps(
+                  _mm_mul_ps(_mm_set1_ps(b[n][2]), tt),
+                  _mm_mul_ps(_mm_set1_ps(b[n][1]), t1)),
+                  _mm_mul_ps(_mm_set1_ps(b[n][0]), t0)));
+        _mm_storeu_ps(Tn, t1);
+        _mm_storeu_ps(Tn + nchan, IIR_FLUSH128(tt));
+      }
+      _mm_storeu_ps(&y[ky++ * nchan + ch], IIR_PS128(
+                  _mm_mul_pd(IIR_LO128(ys), g), _mm_mul_pd(IIR_HI128(ys), g)));
+      continue;
+    }
+
+    xs = _mm_loadu_ps(&x[(up ? k / idown : k) * nchan + ch]);
+    if (up || k0 % idown == 0)
+    {
+      /* Input and output sample */
+      ys = IIR_PS128(_mm_mul_pd(IIR_LO128(xs), dc),
+                     _mm_mul_pd(IIR_HI128(xs), dc));
+      for (Tn = &iir_ptr->T[ch], n = 0; n < iir_ptr->nblocks;
+           Tn += 2 * nchan, n++)
+      {
+        t0 = _mm_loadu_ps(Tn);
+        t1 = _mm_loadu_ps(Tn + nchan);
+        tt = _mm_sub_ps(_mm_sub_ps(xs,
+                  _mm_mul_ps(_mm_set1_ps(c[n][0]), t0)),
+                  _mm_mul_ps(_mm_set1_ps(c[n][1]), t1));
+        tt = _mm_add_ps(tt, tt);
+        ys = _mm_add_ps(ys, _mm_add_ps(_mm_add_ps(
+                  _mm_mul_ps(_mm_set1_ps(b[n][2]), tt),
+                  _mm_mul_ps(_mm_set1_ps(b[n][1]), t1)),
+                  _mm_mul_ps(_mm_set1_ps(b[n][0]), t0)));
+        _mm_storeu_ps(Tn, t1);
+        _mm_storeu_ps(Tn + nchan, IIR_FLUSH128(tt));
+      }
+      _mm_storeu_ps(&y[ky++ * nchan + ch], IIR_PS128(
+                  _mm_mul_pd(IIR_LO128(ys), g), _mm_mul_pd(IIR_HI128(ys), g)));
+    }
+    else
+    {
+      /* Input sample only: update the state variables */
+      for (Tn = &iir_ptr->T[ch], n = 0; n < iir_ptr->nblocks;
+           Tn += 2 * nchan, n++)
+      {
+        t0 = _mm_loadu_ps(Tn);
+        t1 = _mm_loadu_ps(Tn + nchan);
+        tt = _mm_sub_ps(_mm_sub_ps(xs,
+                  _mm_mul_ps(_mm_set1_ps(c[n][0]), t0)),
+                  _mm_mul_ps(_mm_set1_ps(c[n][1]), t1));
+        _mm_storeu_ps(Tn, t1);
+        _mm_storeu_ps(Tn + nchan, IIR_FLUSH128(_mm_add_ps(tt, tt)));
+      }
+    }
+    k0++;
+  }
+  return ky;
+}
+/* ....................... End of stdpcm_mc_sse2() ....................... */
+#endif
+
+
+#ifdef IIR_SIMD_AVX2
+IIR_AVX2_TARGET
+static long     stdpcm_mc_avx2(long lenx, float *x, float *y, long ch,
+                               SCD_IIR_MC *iir_ptr)
+{
+  long            nchan, idown, nk, k0, k, ky, n;
+  int             up;
+  float           (*b)[3], (*c)[2], *Tn;
+  __m256          xs, ys, t0, t1, tt, p0, p1;
+  __m256d         dl, dh, g, dc, zero;
+
+  nchan = iir_ptr->nchan;
+  idown = iir_ptr->idown;
+  up = iir_ptr->hswitch == 'U';
+  nk = up ? idown * lenx : lenx;
+  b = iir_ptr->b;
+  c = iir_ptr->c;
+  g = _mm256_set1_pd(iir_ptr->gain);
+  dc = _mm256_set1_pd(iir_ptr->direct_cof);
+  zero = _mm256_setzero_pd();
+
+  k0 = iir_ptr->k0;
+  ky = 0;
+  for (k = 0; k < nk; k++)
+  {
+    if (up && k % idown != 0)
+    {
+      /* Zero-valued input sample of up-sampling */
+      ys = _mm256_setzero_ps();
+      for (Tn = &iir_ptr->T[ch], n = 0; n < iir_ptr->nblocks;
+           Tn += 2 * nchan, n++)
+      {
+        t0 = _mm256_loadu_ps(Tn);
+        t1 = _mm256_loadu_ps(Tn + nchan);
+        p0 = _mm256_mul_ps(_mm256_set1_ps(c[n][0]), t0);
+        p1 = _mm256_mul_ps(_mm256_set1_ps(c[n][1]), t1);
+        dl = _mm256_sub_pd(_mm256_sub_pd(zero, IIR_LO256(p0)), IIR_LO256(p1));
+        dh = _mm256_sub_pd(_mm256_sub_pd(zero, IIR_HI256(p0)), IIR_HI256(p1));
+        tt = IIR_PS256(_mm256_add_pd(dl, dl), _mm256_add_pd(dh, dh));
+        ys = _mm256_add_ps(ys, _mm256_add_ps(_mm256_add_ps(
+                  _mm256_mul_ps(_mm256_set1_ps(b[n][2]), tt),
+                  _mm256_mul_ps(_mm256_set1_ps(b[n][1]), t1)),
+                  _mm256_mul_ps(_mm256_set1_ps(b[n][0]), t0)));
+        _mm256_storeu_ps(Tn, t1);
+        _mm256_storeu_ps(Tn + nchan, IIR_FLUSH256(tt));
+      }
+      _mm256_storeu_ps(&y[ky++ * nchan + ch], IIR_PS256(
+            _mm256_mul_pd(IIR_LO256(ys), g), _mm256_mul_pd(IIR_HI256(ys), g)));
+      continue;
+    }
+
+    xs = _mm256_loadu_ps(&x[(up ? k / idown : k) * nchan + ch]);
+    if (up || k0 % idown == 0)
+    {
+      /* Input and output sample */
+      ys = IIR_PS256(_mm256_mul_pd(IIR_LO256(xs), dc),
+                     _mm256_mul_pd(IIR_HI256(xs), dc));
+      for (Tn = &iir_ptr->T[ch], n = 0; n < iir_ptr->nblocks;
+           Tn += 2 * nchan, n++)
+      {
+        t0 = _mm256_loadu_ps(Tn);
+        t1 = _mm256_loadu_ps(Tn + nchan);
+        tt = _mm256_sub_ps(_mm256_sub_ps(xs,
+                  _mm256_mul_ps(_mm256_set1_ps(c[n][0]), t0)),
+                  _mm256_mul_ps(_mm256_set1_ps(c[n][1]), t1));
+        tt = _mm256_add_ps(tt, tt);
+        ys = _mm256_add_ps(ys, _mm256_add_ps(_mm256_add_ps(
+                  _mm256_mul_ps(_mm256_set1_ps(b[n][2]), tt),
+                  _mm256_mul_ps(_mm256_set1_ps(b[n][1]), t1)),
+                  _mm256_mul_ps(_mm256_set1_ps(b[n][0]), t0)));
+        _mm256_storeu_ps(Tn, t1);
+        _mm256_storeu_ps(Tn + nchan, IIR_FLUSH256(tt));
+      }
+      _mm256_storeu_ps(&y[ky++ * nchan + ch], IIR_PS256(
+            _mm256_mul_pd(IIR_LO256(ys), g), _mm256_mul_pd(IIR_HI256(ys), g)));
+    }
+    else
+    {
+      /* Input sample only: update the state variables */
+      for (Tn = &iir_ptr->T[ch], n = 0; n < iir_ptr->nblocks;
+           Tn += 2 * nchan, n++)
+      {
+        t0 = _mm256_loadu_ps(Tn);
+        t1 = _mm256_loadu_ps(Tn + nchan);
+        tt = _mm256_sub_ps(_mm256_sub_ps(xs,
+                  _mm256_mul_ps(_mm256_set1_ps(c[n][0]), t0)),
+                  _mm256_mul_ps(_mm256_set1_ps(c[n][1]), t1));
+        _mm256_storeu_ps(Tn, t1);
+        _mm256_storeu_ps(Tn + nchan, IIR_FLUSH256(_mm256_add_ps(tt, tt)));
+      }
+    }
+    k0++;
+  }
+  return ky;
+}
+/* ....................... End of stdpcm_mc_avx2() ....................... */
+#endif
+
+
+/*
+  ============================================================================
+
+        int iir_cpu_avx2 (void);
+        ~~~~~~~~~~~~~~~~
+
+        Description:
+        ~~~~~~~~~~~~
+
+        Tells whether the CPU and the operating system support AVX2.
+
+        Return value:
+        ~~~~~~~~~~~~~
+        1 if the AVX2 multi-channel kernels can be used, 0 otherwise.
+
+        History:
+        ~~~~~~~~
+        17.Oct.26 v1.0 Release of 1st version
+
+ ============================================================================
+*/
+#ifdef IIR_SIMD_AVX2
+static int      iir_cpu_avx2()
+{
+#if defined(__GNUC__)
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("avx2") ? 1 : 0;
+#else
+  int             r[4];
+
+  __cpuid(r, 0);
+  if (r[0] < 7)
+    return 0;
+  __cpuid(r, 1);
+  if (!(r[2] & (1 << 27)) || !(r[2] & (1 << 28)))	/* OSXSAVE, AVX */
+    return 0;
+  if ((_xgetbv(0) & 6) != 6)	/* YMM state saved by the OS */
+    return 0;
+  __cpuidex(r, 7, 0);
+  return (r[1] >> 5) & 1;	/* AVX2 */
+#endif
+}
+/* ........................ End of iir_cpu_avx2() ........................ */
+#endif
+
+
+/* *************************************************************************
+   ******** BLOCK MODE: ONE LONG SIGNAL, BLOCKS FILTERED IN PARALLEL *******
+ * ************************************************************************* */
+
+/*
+  ============================================================================
+
+        long cascade_iir_block_kernel (long lseg, float *x_ptr,
+        ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~  CASCADE_IIR *iir_ptr, float *y_ptr,
+                                       long lblk, int nthreads);
+
+        long direct_iir_block_kernel (long lseg, float *x_ptr,
+        ~~~~~~~~~~~~~~~~~~~~~~~~~~~~  DIRECT_IIR *iir_ptr, float *y_ptr,
+                                      long lblk, int nthreads);
+
+        Description:
+        ~~~~~~~~~~~~
+
+        Same as cascade_iir_kernel() and direct_iir_kernel(), for a long
+        signal that is filtered in blocks of lblk input samples in
+        parallel (see iir_block_filter()). The output matches the
+        sequential filtering within float precision, and the state of
+        the filter is updated as by the sequential kernels, so that the
+        filtering can go on with either kernel. x_ptr and y_ptr may be
+        the same array only for 1:1 filters.
+
+        Parameters:
+        ~~~~~~~~~~~
+        lseg: ....... number of input samples
+        x_ptr: ...... array with input samples
+        iir_ptr: .... pointer to the IIR-struct
+        y_ptr: ...... output samples
+        lblk: ....... block length, 0 for lseg/nthreads; rounded up to
+                      a multiple of the down-sampling factor
+        nthreads: ... number of threads
+
+        Return value:
+        ~~~~~~~~~~~~~
+        Returns the number of output samples.
+
+        History:
+        ~~~~~~~~
+        17.Oct.26 v1.0 Release of 1st version
+
+ ============================================================================
+*/
+long            cascade_iir_block_kernel(lseg, x_ptr, iir_ptr, y_ptr, lblk,
+                                         nthreads)
+  long            lseg;
+  float          *x_ptr;
+  CASCADE_IIR    *iir_ptr;
+  float          *y_ptr;
+  long            lblk;
+  int             nthreads;
+{
+  IIR_BLOCK_FILTER flt;
+
+  flt.iir = (void *) iir_ptr;
+  flt.nstate = 4 * iir_ptr->nblocks;
+  flt.up = iir_ptr->hswitch == 'U';
+  flt.factor = iir_ptr->idown;
+  flt.k0 = &iir_ptr->k0;
+  flt.kernel = iir_blk_cascade_kernel;
+  flt.clone = iir_blk_cascade_clone;
+  flt.state = iir_blk_cascade_state;
+  flt.release = iir_blk_cascade_release;
+
+  return iir_block_filter(lseg, x_ptr, y_ptr, lblk, nthreads, &flt);
+}
+/* ................... End of cascade_iir_block_kernel() .................. */
+
+
+long            direct_iir_block_kernel(lseg, x_ptr, iir_ptr, y_ptr, lblk,
+                                        nthreads)
+  long            lseg;
+  float          *x_ptr;
+  DIRECT_IIR     *iir_ptr;
+  float          *y_ptr;
+  long            lblk;
+  int             nthreads;
+{
+  IIR_BLOCK_FILTER flt;
+
+  flt.iir = (void *) iir_ptr;
+  flt.nstate = 2 * (iir_ptr->zerono > iir_ptr->poleno ?
+                    iir_ptr->zerono : iir_ptr->poleno);
+  flt.up = iir_ptr->hswitch == 'U';
+  flt.factor = iir_ptr->idown;
+  flt.k0 = &iir_ptr->k0;
+  flt.kernel = iir_blk_direct_kernel;
+  flt.clone = iir_blk_direct_clone;
+  flt.state = iir_blk_direct_state;
+  flt.release = iir_blk_direct_release;
+
+  return iir_block_filter(lseg, x_ptr, y_ptr, lblk, nthreads, &flt);
+}
+/* ................... End of direct_iir_block_kernel() ................... */
+
+
+/*
+  ============================================================================
+
+        Adapters of the cascade- and direct-form filters to the block
+        mode: kernel, copy with cleared state variables, address of the
+        state variables, and deallocation of a copy.
+
+        History:
+        ~~~~~~~~
+        17.Oct.26 v1.0 Release of 1st version
+
+ ============================================================================
+*/
+static long     iir_blk_cascade_kernel(lseg, x, iir, y)
+  long            lseg;
+  float          *x, *y;
+  void           *iir;
+{
+  return cascade_iir_kernel(lseg, x, (CASCADE_IIR *) iir, y);
+}
+
+static void    *iir_blk_cascade_clone(iir)
+  void           *iir;
+{
+  CASCADE_IIR    *c;
+
+  if ((c = (CASCADE_IIR *) malloc(sizeof(CASCADE_IIR))) == (CASCADE_IIR *) 0)
+    return 0;
+  *c = *(CASCADE_IIR *) iir;
+  if ((c->T = (float (*)[4]) malloc(c->nblocks * 4 * sizeof(float))) == 0)
+  {
+    free(c);
+    return 0;
+  }
+  cascade_iir_reset(c);
+  c->k0 = ((CASCADE_IIR *) iir)->k0;
+  return (void *) c;
+}
+
+static float   *iir_blk_cascade_state(iir)
+  void           *iir;
+{
+  return (float *) ((CASCADE_IIR *) iir)->T;
+}
+
+static void     iir_blk_cascade_release(iir)
+  void           *iir;
+{
+  cascade_iir_free((CASCADE_IIR *) iir);
+}
+
+static long     iir_blk_direct_kernel(lseg, x, iir, y)
+  long            lseg;
+  float          *x, *y;
+  void           *iir;
+{
+  return direct_iir_kernel(lseg, x, (DIRECT_IIR *) iir, y);
+}
+
+static void    *iir_blk_direct_clone(iir)
+  void           *iir;
+{
+  DIRECT_IIR     *c;
+  long            n;
+
+  if ((c = (DIRECT_IIR *) malloc(sizeof(DIRECT_IIR))) == (DIRECT_IIR *) 0)
+    return 0;
+  *c = *(DIRECT_IIR *) iir;
+  n = c->zerono > c->poleno ? c->zerono : c->poleno;
+  if ((c->T = (float (*)[2]) calloc(n * 2, sizeof(float))) == 0)
+  {
+    free(c);
+    return 0;
+  }
+  return (void *) c;
+}
+
+static float   *iir_blk_direct_state(iir)
+  void           *iir;
+{
+  return (float *) ((DIRECT_IIR *) iir)->T;
+}
+
+static void     iir_blk_direct_release(iir)
+  void           *iir;
+{
+  direct_iir_free((DIRECT_IIR *) iir);
+}
+/* ...................... End of the block adapters ....................... */
+
+
+/*
+  ============================================================================
+
+        long iir_block_filter (long lseg, float *x, float *y, long lblk,
+        ~~~~~~~~~~~~~~~~~~~~~  int nthreads, IIR_BLOCK_FILTER *flt);
+
+        Description:
+        ~~~~~~~~~~~~
+
+        Block-parallel filtering of lseg input samples. The filters are
+        linear in their state variables s, so the output of a block
+        that starts in state s is the output with zero state plus
+        sum_i s[i]*g_i, where g_i is the response of the filter to zero
+        input, starting with state variable i set to one and the others
+        to zero. Likewise, the state at the end of a block of length L
+        is the end state with zero start state plus Phi^L s, where Phi
+        is the transition matrix of the state over one input sample.
+
+        Thus:
+        1. the first block is filtered by the filter itself and the
+           other blocks by copies with zero state, in parallel;
+        2. the start states of the blocks are found one after the
+           other, with Phi^L (nstate x nstate operations per block);
+        3. sum_i s[i]*g_i is added to the output of each block, in
+           parallel.
+
+        g_i and Phi^L are computed at the beginning, in double, with the
+        kernel of the filter: g_i only as long as the state does not
+        decay below IIR_BLOCK_TOL (at most L input samples), after which
+        the correction is neglected.
+
+        Blocks are filtered by nthreads threads when compiled with
+        IIR_THREADS (POSIX or Windows threads), one after the other
+        otherwise. The result does not depend on the number of threads.
+        If memory can't be allocated, or there is only one block, the
+        signal is filtered by the sequential kernel.
+
+        Parameters:
+        ~~~~~~~~~~~
+        lseg: ....... (In) number of input samples
+        x: .......... (In) array with input samples
+        y: .......... (Out) array with output samples
+        lblk: ....... (In) block length, 0 for lseg/nthreads
+        nthreads: ... (In) number of threads
+        flt: ........ (In/Out) filter, with its adapters
+
+        Return value:
+        ~~~~~~~~~~~~~
+        Returns the number of output samples.
+
+        History:
+        ~~~~~~~~
+        17.Oct.26 v1.0 Release of 1st version
+
+ ============================================================================
+*/
+static long     iir_block_filter(lseg, x, y, lblk, nthreads, flt)
+  long            lseg;
+  float          *x, *y;
+  long            lblk;
+  int             nthreads;
+  IIR_BLOCK_FILTER *flt;
+{
+  IIR_BLOCK_JOB   job;
+  long            nblk, nst, lzero, k0, b, i, n;
+  double         *phi1, *phiL, *phiN, *tmp, *s;
+  float          *T, *zero, *out;
+  void           *c;
+  int             ok;
+
+  if (nthreads < 1)
+    nthreads = 1;
+  if (lblk <= 0)
+    lblk = (lseg + nthreads - 1) / nthreads;
+  lblk = (lblk + flt->factor - 1) / flt->factor * flt->factor;
+  nblk = lblk > 0 ? (lseg + lblk - 1) / lblk : 0;
+  if (nblk < 2)
+    return flt->kernel(lseg, x, flt->iir, y);
+
+  /* Blocks and work space */
+  nst = flt->nstate;
+  k0 = *flt->k0;
+  job.flt = flt;
+  job.x = x;
+  job.y = y;
+  job.lseg = lseg;
+  job.lblk = lblk;
+  job.nblk = nblk;
+  job.k0 = k0;
+  job.nyblk = flt->up ? lblk * flt->factor : lblk / flt->factor;
+  job.g = 0;
+  job.blk = (void **) calloc(nblk, sizeof(void *));
+  job.s = (double *) calloc(nblk * nst, sizeof(double));
+  phi1 = (double *) malloc(5 * nst * nst * sizeof(double));
+  lzero = lblk * (flt->up ? flt->factor : 1);
+  zero = (float *) calloc(lblk + lzero, sizeof(float));
+  ok = job.blk != 0 && job.s != 0 && phi1 != 0 && zero != 0;
+  for (b = 1; ok && b < nblk; b++)
+    ok = (job.blk[b] = flt->clone(flt->iir)) != 0;
+  phiL = phi1 + nst * nst;
+  phiN = phiL + nst * nst;
+  tmp = phiN + nst * nst;	/* 2 matrices for iir_mat_pow() */
+  out = zero + lblk;
+
+  /* Transition matrix over one input sample (column i for state i) */
+  for (i = 0; ok && i < nst; i++)
+  {
+    if ((c = flt->clone(flt->iir)) == 0)
+    {
+      ok = 0;
+      break;
+    }
+    flt->state(c)[i] = 1.0;
+    flt->kernel(1L, zero, c, out);
+    for (T = flt->state(c), n = 0; n < nst; n++)
+      phi1[i * nst + n] = T[n];
+    flt->release(c);
+  }
+
+  /* Length of the zero-input responses: until Phi^m is negligible */
+  if (ok)
+  {
+    memcpy(phiN, phi1, nst * nst * sizeof(double));
+    for (job.lg = 1; job.lg < lblk && iir_mat_max(nst, phiN) >= IIR_BLOCK_TOL;
+         job.lg *= 2)
+    {
+      iir_mat_mul(nst, phiN, phiN, tmp);
+      memcpy(phiN, tmp, nst * nst * sizeof(double));
+    }
+    job.lg = (job.lg + flt->factor - 1) / flt->factor * flt->factor;
+    if (job.lg > lblk)
+      job.lg = lblk;
+    job.ng = flt->up ? job.lg * flt->factor : iir_blk_nout(job.lg, k0, flt);
+    job.g = (double *) malloc(nst * (job.ng + 1) * sizeof(double));
+    ok = job.g != 0;
+  }
+
+  /* Zero-input responses g_i */
+  for (i = 0; ok && i < nst; i++)
+  {
+    if ((c = flt->clone(flt->iir)) == 0)
+    {
+      ok = 0;
+      break;
+    }
+    flt->state(c)[i] = 1.0;
+    flt->kernel(job.lg, zero, c, out);
+    for (n = 0; n < job.ng; n++)
+      job.g[i * job.ng + n] = out[n];
+    flt->release(c);
+  }
+
+  if (!ok)
+  {
+    /* Not enough memory: filter sequentially */
+    iir_block_free(&job, phi1, zero);
+    return flt->kernel(lseg, x, flt->iir, y);
+  }
+
+  /* 1. Filter the first block with the filter, the other ones with
+   * copies with zero state */
+  job.blk[0] = flt->iir;
+  iir_block_run(&job, 1, nthreads);
+
+  /* 2. Start states of the blocks, and end state of the last block */
+  iir_mat_pow(nst, phi1, lblk, phiL, tmp);
+  iir_mat_pow(nst, phi1, lseg - (nblk - 1) * lblk, phiN, tmp);
+  for (T = flt->state(flt->iir), n = 0; n < nst; n++)
+    job.s[nst + n] = T[n];
+  for (b = 1; b < nblk; b++)
+  {
+    s = &job.s[b * nst];
+    for (T = flt->state(job.blk[b]), n = 0; n < nst; n++)
+      for (tmp[n] = T[n], i = 0; i < nst; i++)
+        tmp[n] += (b < nblk - 1 ? phiL : phiN)[i * nst + n] * s[i];
+    if (b < nblk - 1)
+      memcpy(s + nst, tmp, nst * sizeof(double));
+  }
+  for (T = flt->state(flt->iir), n = 0; n < nst; n++)
+    T[n] = tmp[n];
+  if (!flt->up)
+    *flt->k0 = (k0 + lseg) % flt->factor;
+
+  /* 3. Add the responses to the start states */
+  iir_block_run(&job, 3, nthreads);
+
+  job.blk[0] = 0;
+  iir_block_free(&job, phi1, zero);
+  return flt->up ? lseg * flt->factor : iir_blk_nout(lseg, k0, flt);
+}
+/* ....................... End of iir_block_filter() ...................... */
+
+
+/*
+  ============================================================================
+
+        void iir_block_run (IIR_BLOCK_JOB *job, int step, int nthreads);
+        ~~~~~~~~~~~~~~~~~~
+
+        void iir_block_work (IIR_BLOCK_JOB *job);
+        ~~~~~~~~~~~~~~~~~~~
+
+        Description:
+        ~~~~~~~~~~~~
+
+        iir_block_run() runs step 1 or 3 of iir_block_filter() for all
+        the blocks, with up to nthreads threads (IIR_THREADS). Thread t
+        takes the blocks t, t+nthreads, ...; the calling thread is
+        thread 0, and also takes the blocks of the threads that could
+        not be created. iir_block_work() does the work of one thread.
+
+        History:
+        ~~~~~~~~
+        17.Oct.26 v1.0 Release of 1st version
+
+ ============================================================================
+*/
+static void     iir_block_run(job, step, nthreads)
+  IIR_BLOCK_JOB  *job;
+  int             step, nthreads;
+{
+#ifdef IIR_THREADS
+  IIR_BLOCK_JOB  *jobs;
+#if defined(_WIN32)
+  HANDLE         *th;
+#else
+  pthread_t      *th;
+#endif
+  int            *started;
+  long            t;
+#endif
+
+  job->step = step;
+  job->first = 0;
+  job->stride = 1;
+
+#ifdef IIR_THREADS
+  if (nthreads > job->nblk)
+    nthreads = job->nblk;
+  jobs = (IIR_BLOCK_JOB *) malloc(nthreads * sizeof(IIR_BLOCK_JOB));
+  th = malloc(nthreads * sizeof(*th));
+  started = (int *) calloc(nthreads, sizeof(int));
+  if (nthreads > 1 && jobs != 0 && th != 0 && started != 0)
+  {
+    for (t = 0; t < nthreads; t++)
+    {
+      jobs[t] = *job;
+      jobs[t].first = t;
+      jobs[t].stride = nthreads;
+    }
+    for (t = 1; t < nthreads; t++)
+#if defined(_WIN32)
+      started[t] = (th[t] = CreateThread(NULL, 0, iir_block_thread,
+                                         &jobs[t], 0, NULL)) != NULL;
+#else
+      started[t] = pthread_create(&th[t], NULL, iir_block_thread,
+                                  &jobs[t]) == 0;
+#endif
+    iir_block_work(&jobs[0]);
+    for (t = 1; t < nthreads; t++)
+    {
+      if (!started[t])
+        iir_block_work(&jobs[t]);
+      else
+      {
+#if defined(_WIN32)
+        WaitForSingleObject(th[t], INFINITE);
+        CloseHandle(th[t]);
+#else
+        pthread_join(th[t], NULL);
+#endif
+      }
+    }
+  }
+  else
+    iir_block_work(job);
+  free(jobs);
+  free(th);
+  free(started);
+#else
+  (void) nthreads;
+  iir_block_work(job);
+#endif
+}
+
+
+static void     iir_block_work(job)
+  IIR_BLOCK_JOB  *job;
+{
+  IIR_BLOCK_FILTER *flt = job->flt;
+  long            b, len, ny, n, i, nst;
+  double          acc, *s;
+  float          *y;
+
+  nst = flt->nstate;
+  for (b = job->first; b < job->nblk; b += job->stride)
+  {
+    len = b < job->nblk - 1 ? job->lblk : job->lseg - b * job->lblk;
+    y = &job->y[b * job->nyblk];
+    if (job->step == 1)
+      flt->kernel(len, &job->x[b * job->lblk], job->blk[b], y);
+    else if (b > 0)
+    {
+      ny = flt->up ? len * flt->factor : iir_blk_nout(len, job->k0, flt);
+      if (ny > job->ng)
+        ny = job->ng;
+      s = &job->s[b * nst];
+      for (n = 0; n < ny; n++)
+      {
+        for (acc = 0.0, i = 0; i < nst; i++)
+          acc += s[i] * job->g[i * job->ng + n];
+        y[n] += acc;
+      }
+    }
+  }
+}
+/* ........................ End of iir_block_run() ........................ */
+
+
+#ifdef IIR_THREADS
+#if defined(_WIN32)
+static DWORD WINAPI iir_block_thread(LPVOID arg)
+#else
+static void    *iir_block_thread(void *arg)
+#endif
+{
+  iir_block_work((IIR_BLOCK_JOB *) arg);
+  return 0;
+}
+#endif
+
+
+/*
+  ============================================================================
+
+        Helper functions of iir_block_filter():
+        - iir_blk_nout(): number of outputs for len inputs, down-sampling
+          starting with modulo counter k0;
+        - iir_mat_mul(): c = a*b for n x n matrices (c distinct from a
+          and b);
+        - iir_mat_pow(): c = a^p, using tmp;
+        - iir_mat_max(): largest magnitude of the elements of a;
+        - iir_block_free(): deallocate the work space.
+
+        History:
+        ~~~~~~~~
+        17.Oct.26 v1.0 Release of 1st version
+
+ ============================================================================
+*/
+static long     iir_blk_nout(len, k0, flt)
+  long            len, k0;
+  IIR_BLOCK_FILTER *flt;
+{
+  long            first;
+
+  first = (flt->factor - k0 % flt->factor) % flt->factor;
+  return len > first ? (len - 1 - first) / flt->factor + 1 : 0;
+}
+
+static void     iir_mat_mul(n, a, b, c)
+  long            n;
+  double         *a, *b, *c;
+{
+  long            i, j, k;
+
+  for (i = 0; i < n; i++)
+    for (j = 0; j < n; j++)
+      for (c[i * n + j] = 0.0, k = 0; k < n; k++)
+        c[i * n + j] += a[k * n + j] * b[i * n + k];
+}
+
+static void     iir_mat_pow(n, a, p, c, tmp)
+  long            n, p;
+  double         *a, *c, *tmp;
+{
+  double         *sq;
+  long            i;
+
+  /* c = identity; sq = a^(2^k) is kept after c, in tmp */
+  sq = tmp + n * n;
+  for (i = 0; i < n * n; i++)
+    c[i] = i % (n + 1) == 0 ? 1.0 : 0.0;
+  memcpy(sq, a, n * n * sizeof(double));
+  for (; p > 0; p >>= 1)
+  {
+    if (p & 1)
+    {
+      iir_mat_mul(n, sq, c, tmp);
+      memcpy(c, tmp, n * n * sizeof(double));
+    }
+    if (p > 1)
+    {
+      iir_mat_mul(n, sq, sq, tmp);
+      memcpy(sq, tmp, n * n * sizeof(double));
+    }
+  }
+}
+
+static double   iir_mat_max(n, a)
+  long            n;
+  double         *a;
+{
+  double          m;
+  long            i;
+
+  for (m = 0.0, i = 0; i < n * n; i++)
+    if (fabs(a[i]) > m)
+      m = fabs(a[i]);
+  return m;
+}
+
+static void     iir_block_free(job, phi1, zero)
+  IIR_BLOCK_JOB  *job;
+  double         *phi1;
+  float          *zero;
+{
+  long            b;
+
+  if (job->blk != 0)
+    for (b = 0; b < job->nblk; b++)
+      if (job->blk[b] != 0)
+        job->flt->release(job->blk[b]);
+  free(job->blk);
+  free(job->s);
+  free(job->g);
+  free(phi1);
+  free(zero);
+}
+/* ................... End of iir_block_filter() helpers .................. */
+
+
 /* **************************** END OF IIR-LIB.C ************************ */
@@ -1,6 +1,6 @@
 /*
   ============================================================================
-   File: IIRFLT.H                                     Version: 3.0 - 31.JUL.95
+   File: IIRFLT.H                                     Version: 3.4 - 17.OCT.26
   ============================================================================
 
                             UGST/ITU-T IIR FILTERS
@@ -12,6 +12,10 @@
    30.Oct.94	v2.0	Name changed to iirflt.h/included cascade-form 
                         IIR filters <simao@ctd.comsat.com>
    31.Jul.95	v3.0	Added direct-form IIR filters <simao@ctd.comsat.com>
+   17.Oct.26	v3.2	Added multi-channel cascade- and parallel-form
+                        IIR filters
+   17.Oct.26	v3.4	Added block-parallel cascade- and direct-form
+                        filtering
 
   ============================================================================
 */
@@ -63,6 +67,41 @@ typedef struct
 }               CASCADE_IIR;
 
 
+/*
+ * ..... Multi-channel IIR filtering, parallel and cascade form  .....
+ *       The coefficients are shared with the single-channel struct the
+ *       filter was initialized from; state variable j of block n of
+ *       channel ch is T[(2*n+j)*nchan+ch] (parallel form) or
+ *       T[(4*n+j)*nchan+ch] (cascade form).
+ */
+typedef struct
+{
+  long            nchan;	/* number of channels                 */
+  long            nblocks;	/* number of coefficient sets         */
+  long            idown;	/* down sampling factor               */
+  long            k0;		/* start index in next segment        */
+  double          gain;		/* gain factor                        */
+  double          direct_cof;	/* In     : direct path coefficient   */
+  float           (*b)[3];	/* In     : numerator coefficients    */
+  float           (*c)[2];	/* In     : denominator coefficients  */
+  float           *T;		/* In/Out : interleaved state vars.   */
+  char            hswitch;	/* "U": upsampling; else downsampling */
+}               SCD_IIR_MC;
+
+typedef struct
+{
+  long            nchan;	/* number of channels                 */
+  long            nblocks;	/* number of stages in cascade        */
+  long            idown;	/* down sampling factor               */
+  long            k0;		/* start index in next segment        */
+  double          gain;		/* gain factor                        */
+  float           (*a)[2];	/* In     : numerator coefficients    */
+  float           (*b)[2];	/* In     : denominator coefficients  */
+  float           *T;		/* In/Out : interleaved state vars.   */
+  char            hswitch;	/* "U": upsampling; else downsampling */
+}               CASCADE_IIR_MC;
+
+
 /*
  * ..... State variable structure for IIR filtering, direct form  .....
  */
@@ -119,5 +158,30 @@ void direct_iir_free ARGS((DIRECT_IIR *iir_ptr));
 /* Additions to the STL92: direct IIR filter initialization */
 DIRECT_IIR *iir_dir_dc_removal_init ARGS((void));
 
+
+/* Multi-channel (interleaved) parallel and cascade IIR filtering, with
+   the coefficients of a filter initialized by the functions above */
+SCD_IIR_MC *stdpcm_mc_init ARGS((SCD_IIR *iir_ptr, long nchan));
+long stdpcm_mc_kernel ARGS((long lseg, float *x_ptr, SCD_IIR_MC *iir_ptr, 
+			    float *y_ptr));
+void stdpcm_mc_reset ARGS((SCD_IIR_MC *iir_ptr));
+void stdpcm_mc_free ARGS((SCD_IIR_MC *iir_ptr));
+
+CASCADE_IIR_MC *cascade_iir_mc_init ARGS((CASCADE_IIR *iir_ptr, long nchan));
+long cascade_iir_mc_kernel ARGS((long lseg, float *x_ptr, 
+				 CASCADE_IIR_MC *iir_ptr, float *y_ptr));
+void cascade_iir_mc_reset ARGS((CASCADE_IIR_MC *iir_ptr));
+void cascade_iir_mc_free ARGS((CASCADE_IIR_MC *iir_ptr));
+
+
+/* Block-parallel filtering of a long signal by cascade- and direct-form
+   filters (threads with IIR_THREADS) */
+long cascade_iir_block_kernel ARGS((long lseg, float *x_ptr, 
+				    CASCADE_IIR *iir_ptr, float *y_ptr, 
+				    long lblk, int nthreads));
+long direct_iir_block_kernel ARGS((long lseg, float *x_ptr, 
+				   DIRECT_IIR *iir_ptr, float *y_ptr, 
+				   long lblk, int nthreads));
+
 #endif
 /* ........................... End of IIRFLT.H ........................... */
@@ -142,6 +142,7 @@ APP_C_FILES_DEC_ENC =
     
 APP_C_FILES_CODEC = g722demo.c \
                     arc_profile.c \
+                    headroom.c \
                     helper_lib.c
 #CDK_workload.c genericStds.c
 
@@ -27,10 +27,19 @@
 	Global (have prototype in reverb-lib.h)
 		shift(...)		:		Shift coefficients of the input buffer for next block filtering
 		conv(...)		:		Convolves the impulse response of a room with the input file
+		conv_fft_init(...)	:	Allocates the state of the partitioned FFT convolution
+		conv_fft(...)	:		Same as conv(), by partitioned FFT convolution (overlap-save)
+		conv_fft_free(...)	:	Frees the state of the FFT convolution
+
+	Local
+		fft_cplx(...)	:		Complex FFT
+		fft_real(...)	:		FFT of a real signal
+		ifft_real(...)	:		Inverse of fft_real()
 
   HISTORY :
 	02.Feb.05	v1.0	First Beta version
     10.jul.08   v1.01   Added 16 bit saturation and saturation warning
+	17.Oct.26	v1.1	Added the partitioned FFT convolution (conv_fft...)
 
   AUTHORS :
 	v1.0 Cyril Guillaume & Stephane Ragot -- stephane.ragot@francetelecom.com
@@ -38,6 +47,15 @@
 
 */
 
+#include <stdlib.h>
+#include <math.h>
+
+#include "reverb-lib.h"
+
+
+static void fft_cplx(double *a, long n, long *rev, double *wr, double *wi, double isign);
+static void fft_real(double *a, CONV_FFT *st);
+static void ifft_real(double *a, CONV_FFT *st);
 
 
 /* this routine replaces the first N-1 samples of a buffer by the last N-1 samples */
@@ -104,3 +122,280 @@ void conv_old(float* IR, short* buffIn, short* buffRvb, float alignFact, long N,
 	}
 }
 
+
+/* this routine allocates the state of the partitioned FFT convolution with the impulse response IR */
+/* P is the partition length, a power of 2 (0: chosen from N); the input is split into frames of P */
+/* samples, and the impulse response into K partitions of P samples, whose spectra are computed here */
+CONV_FFT *conv_fft_init(float* IR, long N, long P)
+{
+	CONV_FFT *st;
+	double *a, pi;
+	long K, k, j, m, p;
+
+	if(N < 1) return NULL;
+
+	/* partition length: the cost per sample of the FFTs grows with log(P), */
+	/* the one of the products of the spectra with N/P */
+	if(P <= 0) {
+		for(P=64; P*P < 32*N && P < N; P*=2);
+	}
+	for(k=1; k < P; k*=2);
+	if(k != P) return NULL;
+	K=(N+P-1)/P;
+
+	/* allocate the state */
+	st=(CONV_FFT*) calloc(1, sizeof(CONV_FFT));
+	if(st == NULL) return NULL;
+	st->rev=(long*) malloc(P*sizeof(long));
+	st->wr=(double*) calloc(2*P + 2*K*(2*P+2) + 2*(2*P+2) + 2*P, sizeof(double));
+	if((st->rev == NULL) || (st->wr == NULL)) {
+		conv_fft_free(st);
+		return NULL;
+	}
+	st->N=N;
+	st->P=P;
+	st->K=K;
+	st->wi=st->wr + P;
+	st->H=st->wi + P;
+	st->X=st->H + K*(2*P+2);
+	st->S=st->X + K*(2*P+2);
+	st->Y=st->S + (2*P+2);
+	st->xin=st->Y + (2*P+2);
+
+	/* twiddle factors and bit-reversal permutation */
+	pi=4.0*atan(1.0);
+	for(k=0; k<P; k++) {
+		st->wr[k]=cos(pi*k/P);
+		st->wi[k]=sin(pi*k/P);
+	}
+	for(k=0; k<P; k++) {
+		for(j=0, m=1; m<P; m<<=1)
+			j=(j<<1) | ((k & m) != 0);
+		st->rev[k]=j;
+	}
+
+	/* spectra of the partitions, with the scaling of the inverse FFT */
+	for(p=0; p<K; p++) {
+		a=&st->H[p*(2*P+2)];
+		for(k=0; k<P && p*P+k<N; k++)
+			a[k]=IR[p*P+k]/(2.0*P);
+		fft_real(a, st);
+	}
+
+	return st;
+}
+
+
+/* this routine convolves the next L input samples of buffIn with the impulse response (see conv_fft_init) */
+/* alignFact is used to align the energy of the input file with an other file */
+/* when a frame of P input samples is complete, its spectrum (taken with the frame before it) is kept, */
+/* and the contribution of the partitions 1..K-1 to the next frame is summed in the frequency domain (S). */
+/* The output of a frame is the inverse FFT of S plus the product of the first partition with the */
+/* spectrum of the frame; it is also computed for the last, incomplete frame of the call (padded with */
+/* zeros, which don't change its first output samples), so that L is not restricted and there is no delay. */
+/* the ouput sat_warning is the same as for conv() */
+long conv_fft(CONV_FFT* st, short* buffIn, short* buffRvb, float alignFact, long L)
+{
+	long P, N2, k, n, j, p, next;
+	double *x, *h, *y, xr, xi;
+	float tmpRvb;
+	long sat_warning;
+
+	sat_warning=-1;
+	P=st->P;
+	N2=2*P+2;
+	for(k=0; k<L; k+=n) {
+		/* append the input samples to the current frame */
+		n=P - st->pos;
+		if(n > L-k) n=L-k;
+		for(j=0; j<n; j++)
+			st->xin[P + st->pos + j]=buffIn[k+j];
+		st->pos+=n;
+
+		/* spectrum of the previous and current frames, in the slot of the oldest frame */
+		next=(st->fdl+1) % st->K;
+		x=&st->X[next*N2];
+		for(j=0; j<2*P; j++)
+			x[j]=st->xin[j];
+		fft_real(x, st);
+
+		/* output of the current frame */
+		y=st->Y;
+		h=st->H;
+		for(j=0; j<N2; j+=2) {
+			y[j]  =st->S[j]   + x[j]*h[j]   - x[j+1]*h[j+1];
+			y[j+1]=st->S[j+1] + x[j]*h[j+1] + x[j+1]*h[j];
+		}
+		ifft_real(y, st);
+		for(j=st->done; j<st->pos; j++) {
+			tmpRvb=(float) y[P+j];
+			tmpRvb=(float)(alignFact*tmpRvb + 0.5); /* +0.5 : rounding for the 'short' truncation */
+
+			/* perform 16 bit saturation */
+			if( tmpRvb < -32768.0 ){
+				buffRvb[k+n-st->pos+j]=-32768;
+				sat_warning=k+n-st->pos+j;
+			} else {
+				if( tmpRvb > 32767.0 ){
+					buffRvb[k+n-st->pos+j]=32767;
+					sat_warning=k+n-st->pos+j;
+				} else {
+					buffRvb[k+n-st->pos+j]=(short)tmpRvb;
+				}
+			}
+		}
+		st->done=st->pos;
+
+		if(st->pos == P) {
+			/* the frame is complete: contribution of the partitions 1..K-1 to the next frame */
+			st->fdl=next;
+			y=st->S;
+			for(j=0; j<N2; j++)
+				y[j]=0.0;
+			for(p=1; p<st->K; p++) {
+				x=&st->X[((st->fdl + st->K - p + 1) % st->K)*N2];
+				h=&st->H[p*N2];
+				for(j=0; j<N2; j+=2) {
+					xr=x[j];
+					xi=x[j+1];
+					y[j]  +=xr*h[j]   - xi*h[j+1];
+					y[j+1]+=xr*h[j+1] + xi*h[j];
+				}
+			}
+
+			/* the current frame becomes the previous one */
+			for(j=0; j<P; j++) {
+				st->xin[j]=st->xin[P+j];
+				st->xin[P+j]=0.0;
+			}
+			st->pos=0;
+			st->done=0;
+		}
+	}
+	return sat_warning;
+}
+
+
+/* this routine frees the state of the FFT convolution */
+void conv_fft_free(CONV_FFT* st)
+{
+	if(st == NULL) return;
+	free(st->rev);
+	free(st->wr);
+	free(st);
+}
+
+
+/* this routine computes in place the FFT of n complex values, stored as real and imaginary parts in a[0..2n-1] */
+/* isign=1: forward FFT, with exp(-2*pi*i*j*k/n); isign=-1: inverse FFT, with exp(2*pi*i*j*k/n), not scaled */
+/* rev is the bit-reversal permutation, and wr and wi are cos(pi*k/n) and sin(pi*k/n), k<n */
+static void fft_cplx(double* a, long n, long* rev, double* wr, double* wi, double isign)
+{
+	double c, s, tr, ti, ur, ui, *u, *v;
+	long len, half, step, i, j;
+
+	/* bit-reversal permutation */
+	for(i=0; i<n; i++) {
+		j=rev[i];
+		if(i < j) {
+			tr=a[2*i];
+			ti=a[2*i+1];
+			a[2*i]=a[2*j];
+			a[2*i+1]=a[2*j+1];
+			a[2*j]=tr;
+			a[2*j+1]=ti;
+		}
+	}
+
+	/* butterflies */
+	for(len=2; len<=n; len<<=1) {
+		half=len>>1;
+		step=2*n/len;
+		for(i=0; i<n; i+=len) {
+			u=&a[2*i];
+			v=&a[2*(i+half)];
+			for(j=0; j<half; j++) {
+				c=wr[j*step];
+				s=isign*wi[j*step];
+				ur=u[2*j];
+				ui=u[2*j+1];
+				tr=v[2*j]*c + v[2*j+1]*s;
+				ti=v[2*j+1]*c - v[2*j]*s;
+				u[2*j]=ur + tr;
+				u[2*j+1]=ui + ti;
+				v[2*j]=ur - tr;
+				v[2*j+1]=ui - ti;
+			}
+		}
+	}
+}
+
+
+/* this routine computes in place the FFT of the 2P real samples a[0..2P-1]: they are transformed */
+/* as P complex values, whose FFT is split into the spectra of the even and odd samples */
+/* the output is the spectrum at the frequencies 0..P, as real and imaginary parts in a[0..2P+1] */
+static void fft_real(double* a, CONV_FFT* st)
+{
+	double er, ei, odr, odi, tr, ti, c, s;
+	long P, k;
+
+	P=st->P;
+	fft_cplx(a, P, st->rev, st->wr, st->wi, 1.0);
+
+	/* frequencies 0 and P */
+	a[2*P]=a[0] - a[1];
+	a[2*P+1]=0.0;
+	a[0]=a[0] + a[1];
+	a[1]=0.0;
+
+	/* frequencies k and P-k, from the spectra of the even (e) and odd (o) samples */
+	for(k=1; 2*k<=P; k++) {
+		er=0.5*(a[2*k] + a[2*(P-k)]);
+		ei=0.5*(a[2*k+1] - a[2*(P-k)+1]);
+		odr=0.5*(a[2*k+1] + a[2*(P-k)+1]);
+		odi=-0.5*(a[2*k] - a[2*(P-k)]);
+		c=st->wr[k];
+		s=st->wi[k];
+		tr=odr*c + odi*s;
+		ti=odi*c - odr*s;
+		a[2*k]=er + tr;
+		a[2*k+1]=ei + ti;
+		a[2*(P-k)]=er - tr;
+		a[2*(P-k)+1]=ti - ei;
+	}
+}
+
+
+/* this routine is the inverse of fft_real(), scaled by 2P: the spectrum at the frequencies 0..P */
+/* in a[0..2P+1] gives 2P times the real samples in a[0..2P-1] */
+static void ifft_real(double* a, CONV_FFT* st)
+{
+	double er, ei, dr, di, odr, odi, c, s;
+	long P, k;
+
+	P=st->P;
+
+	/* frequencies 0 and P */
+	er=a[0] + a[2*P];
+	odr=a[0] - a[2*P];
+	a[0]=er;
+	a[1]=odr;
+
+	/* spectra of the even (e) and odd (o) samples, times 2, combined as e + i*o */
+	for(k=1; 2*k<=P; k++) {
+		er=a[2*k] + a[2*(P-k)];
+		ei=a[2*k+1] - a[2*(P-k)+1];
+		dr=a[2*k] - a[2*(P-k)];
+		di=a[2*k+1] + a[2*(P-k)+1];
+		c=st->wr[k];
+		s=st->wi[k];
+		odr=dr*c - di*s;
+		odi=di*c + dr*s;
+		a[2*k]=er - odi;
+		a[2*k+1]=ei + odr;
+		a[2*(P-k)]=er + odi;
+		a[2*(P-k)+1]=odr - ei;
+	}
+
+	fft_cplx(a, P, st->rev, st->wr, st->wi, -1.0);
+}
@@ -32,6 +32,7 @@
   HISTORY :
 	02.Feb.05	v1.0	First Beta version
 	10.jul.08   v1.01   Added 16 bit saturation and saturation warning
+	17.Oct.26   v1.1    Added the partitioned FFT convolution (conv_fft...)
 
 
   AUTHORS :
@@ -58,3 +59,50 @@ long conv(
 	long	N,			/* length of the impulse response */
 	long	L			/* length of the input buffer to process */
 );
+
+
+/* state of the partitioned FFT convolution: the impulse response is split into K partitions */
+/* of P samples, and the input into frames of P samples */
+typedef struct {
+	long	N;		/* length of the impulse response */
+	long	P;		/* partition length, FFT size 2*P */
+	long	K;		/* number of partitions */
+	long	pos;	/* number of input samples in the current frame */
+	long	done;	/* number of output samples already given for the current frame */
+	long	fdl;	/* slot of the newest frame spectrum in X */
+	long	*rev;	/* bit-reversal permutation of P entries */
+	double	*wr;	/* cos(pi*k/P), k<P */
+	double	*wi;	/* sin(pi*k/P), k<P */
+	double	*H;		/* spectra of the partitions, scaled by 1/(2*P), K slots of 2*P+2 values */
+	double	*X;		/* spectra of the last K input frames, each with the frame before it */
+	double	*S;		/* spectrum of the contribution of the partitions 1..K-1 to the current frame */
+	double	*xin;	/* previous and current input frames, 2*P samples */
+	double	*Y;		/* output spectrum, 2*P+2 values */
+} CONV_FFT;
+
+
+/* this routine allocates the state of the FFT convolution with the impulse response IR */
+/* the output is NULL if the memory can't be allocated */
+CONV_FFT *conv_fft_init(
+	float	*IR,		/* impulse response buffer */
+	long	N,			/* length of the impulse response */
+	long	P			/* partition length (power of 2), 0 for the default */
+);
+
+
+/* this routine convolves the next L input samples with the impulse response, as conv() */
+/* the previous input samples are kept in the state, so shift() is not needed */
+/* the output is an overflow flag, if non-negative it indicates overflow with saturation at that sample position */
+long conv_fft(
+	CONV_FFT	*st,	/* FFT convolution state */
+	short	*buffIn,	/* input samples (new ones only) */
+	short	*buffRvb,	/* reverberated data */
+	float	alignFact,	/* energy alignment factor */
+	long	L			/* number of input samples to process */
+);
+
+
+/* this routine frees the state of the FFT convolution */
+void conv_fft_free(
+	CONV_FFT	*st		/* FFT convolution state */
+);
@@ -1,4 +1,4 @@
-/*                                                         02/Feb/2010 v1.02 */
+/*                                                         17/Oct/2026 v1.1  */
 /*=============================================================================
 
                           U    U   GGG    SSSS  TTTTT
@@ -26,6 +26,7 @@
 	02.Feb.05	v1.0	First Beta version
 	10.Jul.08 v1.01 Added 16 bit saturation and saturation warning
 	02.Feb.10 v1.02 Modified maximum string length to avoid buffer overrun
+	17.Oct.26 v1.1  New option -fft: partitioned FFT convolution
 
   AUTHORS :
 	v1.0  Cyril Guillaume & Stephane Ragot -- stephane.ragot@francetelecom.com
@@ -45,7 +46,7 @@
 #define P(x) printf x
 static void display_usage()
 {
-  P(("REVERB.C - Version 1.02 of 02.Feb.2010 \n\n"));
+  P(("REVERB.C - Version 1.1 of 17.Oct.2026 \n\n"));
  
   P((" Program to add reverberation to a signal\n"));
   P((" This program convolves a signal with the impulse response of a room\n"));
@@ -63,6 +64,10 @@ static void display_usage()
   P((" Options:\n"));
   P(("  -align A...... multiplicative factor to apply to the reverberated sound\n"));
   P(("				   in order to align its energy level with a second file\n"));
+  P(("  -fft P........ partitioned FFT convolution, with partitions of P samples\n"));
+  P(("				   (a power of 2, 0 for the default); much faster for long\n"));
+  P(("				   impulse responses, the output may differ by 1 from the\n"));
+  P(("				   direct convolution in a few samples\n"));
   P(("\n"));
 }
 #undef P
@@ -96,6 +101,8 @@ char *argv[];
 	/* Algorithm variables */
 	float alignFact=1.0;/* multiplicative factor for the reverberated sound (energy alignment with another file to compare) */
 	long  N;			/* length of the impulse response */
+	long  fftP=-1;		/* partition length of the FFT convolution, -1: direct convolution */
+	CONV_FFT *convFFT=NULL;	/* state of the FFT convolution */
 	long  count,global_count;
     long  local_sat_pos;
  
@@ -120,6 +127,15 @@ char *argv[];
 				argc -=2;
 				argv +=2;
 			}
+			else if (strcmp(argv[1],"-fft")==0)
+			{
+				/* Use the partitioned FFT convolution */
+				fftP = atol(argv[2]);
+
+				/* Move arg{c,v} over the option to the next argument */
+				argc -=2;
+				argv +=2;
+			}
 			else if (strcmp(argv[1], "-h") == 0 || strcmp(argv[1], "-?") == 0)
 			{
 				/* Display help message */
@@ -187,6 +203,17 @@ char *argv[];
 	buffIn =(short*)  calloc(2*N-1,sizeof(short));	/* allocate memory for a block of the input file */
 	buffRvb=(short *) malloc(N*sizeof(short));		/* allocate memory for the processed block */
 
+	/* FFT convolution state */
+	if(fftP >= 0)
+	{
+		convFFT=conv_fft_init(IR,N,fftP);
+		if(convFFT==NULL)
+		{
+			fprintf(stderr, "\nInvalid partition length or unable to allocate enough memory\n");
+			exit(-1);
+		}
+	}
+
 	/* check consistency */
 	if((buffIn==NULL)||(buffRvb==NULL))
 	{
@@ -205,14 +232,18 @@ char *argv[];
 	{
 		count= (long) fread(buffIn+N-1,sizeof(short),N,ptr_fileIn);	/* read a block of the input file */
         
-		local_sat_pos = conv(IR,buffIn,buffRvb,alignFact,N,count);		    /* convolves a block of the input file with the impulse response */
+		if(convFFT!=NULL)
+			local_sat_pos = conv_fft(convFFT,buffIn+N-1,buffRvb,alignFact,count);	/* same, by FFT (the past samples are kept in convFFT) */
+		else
+			local_sat_pos = conv(IR,buffIn,buffRvb,alignFact,N,count);		    /* convolves a block of the input file with the impulse response */
         if(local_sat_pos >= 0){
            fprintf(stderr, "\nWarning warning!! Saturation(s) in output file.  In  sample %ld\n", 
                    local_sat_pos + global_count);
         }
         global_count += count;
 		fwrite(buffRvb,sizeof(short),count,ptr_fileOut);			/* output the processed block */
-		shift(buffIn,N);											/* shift a part of the input buffer (to keep the N-1 
+		if(convFFT==NULL)
+			shift(buffIn,N);											/* shift a part of the input buffer (to keep the N-1 
 																	   last samples of the input file for the next processing) */
 	}
 
@@ -223,6 +254,7 @@ char *argv[];
 	/* FINALIZATIONS */
 	
 	/* free allocated memory */
+	conv_fft_free(convFFT);
 	free(buffIn);
 	free(buffRvb);
 	free(IR);
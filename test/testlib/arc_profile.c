@@ -20,6 +20,9 @@
 
 #include <string.h>
 #include "arc_profile.h"
+#ifdef NATIVE_HEADROOM_ANALYSIS
+	#include "headroom.h"
+#endif
 #ifdef _ARC
 	#include <arc/arc_timer.h>
 	#ifdef NATIVE_BUSBANDWIDTH_PROFILING
@@ -34,6 +37,24 @@
 	#ifdef NATIVE_BUSBANDWIDTH_PROFILING
 		#include "alb_mss_perfctrl_regmap.h"
 	#endif
+#else
+	#undef NATIVE_STACK_PROFILING		/* needs the ARC linker stack symbols */
+#endif
+#ifdef NATIVE_LINUX_PROFILING
+	#include <time.h>
+	#include <unistd.h>
+	#include <sys/ioctl.h>
+	#include <sys/syscall.h>
+	#include <linux/perf_event.h>
+	#if defined(__x86_64__) || defined(__i386__)
+		#include <x86intrin.h>
+	#endif
+#endif
+
+#ifdef NATIVE_HEADROOM_ANALYSIS
+// live headroom analysis of the profiled frames, reported by profile_postprocess()
+static Headroom_Analyzer_t headroom;
+static double headroom_core_mhz = 0;
 #endif
 
 static char* component_class_to_str(uint32_t comp_class)
@@ -53,6 +74,7 @@ static char* component_class_to_str(uint32_t comp_class)
     }
 }
 
+#ifdef _ARC
 #pragma Push_small_data(0)
 extern uint32_t _fstack;
 extern uint32_t _estack;
@@ -95,6 +117,116 @@ void stack_postprocess(Profiler_Settings_t * inst_settings) {
 
     inst_settings->profiling_data.stack2 = (uint8_t *)GetStackEnd() - (uint8_t *)(void*)stack_start;
 }
+#endif
+
+#ifdef NATIVE_LINUX_PROFILING
+// Linux backend: one perf event group (cycles, instructions, cache misses)
+// counting user space of the calling thread. perf_slot[] maps each event to
+// its position in the group read, -1 when the event could not be opened
+// (no PMU, perf_event_paranoid, container, ...).
+enum { PERF_EV_CYCLES, PERF_EV_INSTRUCTIONS, PERF_EV_CACHE_MISSES, PERF_EV_NUM };
+
+static int perf_fd[PERF_EV_NUM] = {-1, -1, -1};
+// unit of the cycle column: core cycles from perf, else the fallback source
+static const char* cycle_unit = "cycles";
+static int perf_slot[PERF_EV_NUM] = {-1, -1, -1};
+static int perf_leader = -1;
+
+static int perf_open_(uint64_t config, int group_fd)
+{
+    struct perf_event_attr attr;
+
+    memset(&attr, 0, sizeof(attr));
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.size = sizeof(attr);
+    attr.config = config;
+    attr.disabled = (group_fd == -1);
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP;
+    return (int)syscall(__NR_perf_event_open, &attr, 0, -1, group_fd, 0);
+}
+
+static void perf_start_()
+{
+    static const uint64_t config[PERF_EV_NUM] = {
+        PERF_COUNT_HW_CPU_CYCLES,
+        PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_CACHE_MISSES
+    };
+    int i, nr = 0;
+
+    perf_leader = -1;
+    for (i = 0; i < PERF_EV_NUM; i++)
+    {
+        perf_fd[i] = perf_open_(config[i], perf_leader);
+        perf_slot[i] = -1;
+        if (perf_fd[i] >= 0)
+        {
+            perf_slot[i] = nr++;
+            if (perf_leader < 0)
+                perf_leader = perf_fd[i];
+        }
+    }
+    cycle_unit = "cycles";
+    if (perf_slot[PERF_EV_CYCLES] < 0)
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        cycle_unit = "TSC ticks";
+#else
+        cycle_unit = "ns";
+#endif
+        WRN( "perf cycle counter not available, the cycle column is in %s", cycle_unit);
+    }
+    if (perf_leader < 0)
+        return;
+    ioctl(perf_leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(perf_leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+}
+
+static void perf_stop_()
+{
+    int i;
+
+    for (i = PERF_EV_NUM - 1; i >= 0; i--)
+    {
+        if (perf_fd[i] >= 0)
+            close(perf_fd[i]);
+        perf_fd[i] = -1;
+        perf_slot[i] = -1;
+    }
+    perf_leader = -1;
+}
+
+// Fallback cycle source: time stamp counter on x86, nanoseconds elsewhere
+// (reported as such through cycle_unit)
+static uint64_t tsc_read_()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+// Reads all events at once; counters that are not available stay 0,
+// except cycles which then come from tsc_read_()
+static void perf_read_(uint64_t events[PERF_EV_NUM])
+{
+    struct { uint64_t nr; uint64_t values[PERF_EV_NUM]; } group;
+    int i;
+
+    memset(&group, 0, sizeof(group));
+    if (perf_leader >= 0 && read(perf_leader, &group, sizeof(group)) <= 0)
+        group.nr = 0;
+    for (i = 0; i < PERF_EV_NUM; i++)
+        events[i] = (perf_slot[i] >= 0 && (uint64_t)perf_slot[i] < group.nr) ? group.values[perf_slot[i]] : 0;
+    if (perf_slot[PERF_EV_CYCLES] < 0)
+        events[PERF_EV_CYCLES] = tsc_read_();
+}
+#endif
 
 
 uint32_t print_stream_summary(Profiler_Settings_t * inst_settings)
@@ -117,12 +249,18 @@ uint32_t print_stream_summary(Profiler_Settings_t * inst_settings)
 	fprintf(inst_settings->f_raw_profiling_log, "    Sample size:        %d" NEWLINE, inst_settings->stream_config.sample_size);
 	fprintf(inst_settings->f_raw_profiling_log, "    Raw profiling log:  %s" NEWLINE, inst_settings->raw_prof_data_file_name);
 	fprintf(inst_settings->f_raw_profiling_log, "    Codec instance size:%u" NEWLINE, inst_settings->stream_config.codec_instance_size);
+#ifdef NATIVE_LINUX_PROFILING
+	fprintf(inst_settings->f_raw_profiling_log, "    Cycle column unit:  %s" NEWLINE, cycle_unit);
+#endif
 
 	fprintf(inst_settings->f_raw_profiling_log, "\nFrame#, bytes, cycles, heap, stack, input buffer, output buffer"
 #ifdef NATIVE_BUSBANDWIDTH_PROFILING
 		", I$ cycles, D$ cycles"
 #endif
 	        ", microsec/frame, mhz"
+#ifdef NATIVE_LINUX_PROFILING
+		", instructions, cache misses"     /* after mhz, as leaky_bucket.pl expects */
+#endif
 	NEWLINE);
 
     return TEST_TRUE;
@@ -140,6 +278,9 @@ void print_frame_info(Profiler_Settings_t * inst_settings)
 			",%u,%u"
 	#endif
 			", %u, %.2f"
+	#ifdef NATIVE_LINUX_PROFILING
+			",%llu,%llu"
+	#endif
 			NEWLINE , inst_settings->profiling_data.frame_counter,
 				used_buffer,
 				inst_settings->profiling_data.cycles_per_frame,
@@ -152,6 +293,10 @@ void print_frame_info(Profiler_Settings_t * inst_settings)
 				inst_settings->profiling_data.d_cache_cycles_per_frame
 	#endif
 				, inst_settings->profiling_data.mksec_per_frame, mhz
+	#ifdef NATIVE_LINUX_PROFILING
+				, (unsigned long long)inst_settings->profiling_data.instructions_per_frame,
+				(unsigned long long)inst_settings->profiling_data.cache_misses_per_frame
+	#endif
 				);
         fflush(inst_settings->f_raw_profiling_log);
 }
@@ -170,6 +315,25 @@ void print_profile_summary(Profiler_Settings_t * inst_settings)
 			inst_settings->memory_stats.max_heap_usage);
 	INFO( "[Memory Usage For Buffers] Maximum I/O buffers memory usage: %d bytes",
 			inst_settings->profiling_data.max_used_input_buffer + inst_settings->profiling_data.max_used_output_buffer);
+#ifdef NATIVE_HEADROOM_ANALYSIS
+	{
+		Headroom_Report_t report;
+		if (headroom_analyze(&headroom, headroom_core_mhz, &report))
+			headroom_print_report(stdout, &report);
+	}
+#endif
+#ifdef NATIVE_LINUX_PROFILING
+	if (inst_settings->profiling_data.frame_counter > 0)
+	{
+		uint32_t n = inst_settings->profiling_data.frame_counter;
+		INFO( "[Cycles] Average cycles per frame: %llu (%s)",
+				(unsigned long long)(inst_settings->profiling_data.summary_cycles / n), cycle_unit);
+		INFO( "[Instructions] Average instructions per frame: %llu",
+				(unsigned long long)(inst_settings->profiling_data.summary_instructions / n));
+		INFO( "[Cache Misses] Average cache misses per frame: %llu",
+				(unsigned long long)(inst_settings->profiling_data.summary_cache_misses / n));
+	}
+#endif
 }
 
 #ifdef NATIVE_BUSBANDWIDTH_PROFILING
@@ -207,7 +371,7 @@ void read_profiler_counters(uint32_t * read_icache, uint32_t * write_icache, uin
 #endif
 
 
-uint32_t read_timer_()
+uint64_t read_timer_()
 {
 #ifdef _ARC
 	if (_timer0_present())
@@ -223,6 +387,10 @@ uint32_t read_timer_()
 		WRN0( "No available timers for profiling!");
 		return 0;
 	}
+#elif defined(NATIVE_LINUX_PROFILING)
+	uint64_t events[PERF_EV_NUM];
+	perf_read_(events);
+	return events[PERF_EV_CYCLES];
 #else
 	return 0;
 #endif
@@ -248,6 +416,7 @@ uint32_t profile_preprocess(Profiler_Settings_t * inst_settings)
     memset(&inst_settings->rt_stats, 0, sizeof(inst_settings->rt_stats));
 
     inst_settings->profiling_data.frame_counter = 0;
+    inst_settings->profiling_data.summary_cycles = 0;
 
     inst_settings->profiling_data.max_used_input_buffer = 0;
     inst_settings->profiling_data.max_used_output_buffer = 0;
@@ -273,6 +442,14 @@ uint32_t profile_preprocess(Profiler_Settings_t * inst_settings)
         inst_settings->profiling_data.xydma_bw_summary = 0;
         inst_settings->profiling_data.ldst_bw_summary = 0;
     #endif
+    #ifdef NATIVE_LINUX_PROFILING
+        inst_settings->profiling_data.summary_instructions = 0;
+        inst_settings->profiling_data.summary_cache_misses = 0;
+        perf_start_();
+    #endif
+    #ifdef NATIVE_HEADROOM_ANALYSIS
+        headroom_init(&headroom, HEADROOM_DEFAULT_INTERVAL, HEADROOM_DEFAULT_BORDER);
+    #endif
     return TEST_TRUE;
 }
 
@@ -322,6 +499,16 @@ void profile_init(Profiler_Settings_t *inst_settings, int * pargc, char * argv[]
 #ifdef NATIVE_BUSBANDWIDTH_PROFILING
             inst_settings->profiling_data.required_mem_latency = atoi(argv_item);
             INFO("required_mem_latency = %u", inst_settings->profiling_data.required_mem_latency);
+#endif
+            prof_counters+=2;
+        }
+        else if(strcmp(argv[count], "-core_clock")==0)
+        {
+            remove_argv_item(count, pargc, argv); /* remove -core_clock */
+            argv_item = remove_argv_item(count, pargc, argv);
+#ifdef NATIVE_HEADROOM_ANALYSIS
+            headroom_core_mhz = atof(argv_item);
+            INFO("core_clock = %s MHz", argv_item);
 #endif
             prof_counters+=2;
         }
@@ -355,7 +542,12 @@ TEST_BOOL profile_frame_preprocess(Profiler_Settings_t * inst_settings)
 	}
 #endif
     reset_timer_();
+#ifdef NATIVE_LINUX_PROFILING
+    perf_read_(inst_settings->profiling_data.events1);
+    inst_settings->profiling_data.c1 = inst_settings->profiling_data.events1[PERF_EV_CYCLES];
+#else
     inst_settings->profiling_data.c1 = read_timer_();
+#endif
 
     return TEST_TRUE;
 }
@@ -373,13 +565,34 @@ void store_frame_info(Profiler_Settings_t * inst_settings)
 #endif
 
     inst_settings->profiling_data.mksec_per_frame = inst_settings->rt_stats.microseconds_per_frame;
-    inst_settings->profiling_data.cycles_per_frame = (inst_settings->profiling_data.c2 - inst_settings->profiling_data.c1);
+    inst_settings->profiling_data.cycles_per_frame = (uint32_t)(inst_settings->profiling_data.c2 - inst_settings->profiling_data.c1);
     inst_settings->profiling_data.summary_cycles += inst_settings->profiling_data.cycles_per_frame;
+#ifdef NATIVE_LINUX_PROFILING
+    inst_settings->profiling_data.instructions_per_frame = inst_settings->profiling_data.events2[PERF_EV_INSTRUCTIONS] -
+            inst_settings->profiling_data.events1[PERF_EV_INSTRUCTIONS];
+    inst_settings->profiling_data.cache_misses_per_frame = inst_settings->profiling_data.events2[PERF_EV_CACHE_MISSES] -
+            inst_settings->profiling_data.events1[PERF_EV_CACHE_MISSES];
+    inst_settings->profiling_data.summary_instructions += inst_settings->profiling_data.instructions_per_frame;
+    inst_settings->profiling_data.summary_cache_misses += inst_settings->profiling_data.cache_misses_per_frame;
+#endif
+#ifdef NATIVE_HEADROOM_ANALYSIS
+    headroom_set_stream(&headroom, inst_settings->stream_config.sample_rate,
+            inst_settings->stream_config.sample_size, inst_settings->stream_config.num_ch);
+    headroom_add_frame(&headroom,
+            inst_settings->stream_config.component_class == ARC_API_CLASS_ENCODER ?
+                    inst_settings->rt_stats.used_input_buffer : inst_settings->rt_stats.used_output_buffer,
+            inst_settings->profiling_data.cycles_per_frame, inst_settings->profiling_data.mksec_per_frame);
+#endif
 }
 
 TEST_BOOL profile_frame_postprocess(Profiler_Settings_t * inst_settings)
 {
+#ifdef NATIVE_LINUX_PROFILING
+    perf_read_(inst_settings->profiling_data.events2);
+    inst_settings->profiling_data.c2 = inst_settings->profiling_data.events2[PERF_EV_CYCLES];
+#else
     inst_settings->profiling_data.c2 = read_timer_();
+#endif
 #ifdef NATIVE_BUSBANDWIDTH_PROFILING
     stop_profiler();
 #endif
@@ -413,6 +626,12 @@ TEST_BOOL profile_frame_postprocess(Profiler_Settings_t * inst_settings)
 void profile_postprocess(Profiler_Settings_t* inst_settings)
 {
     print_profile_summary(inst_settings);
+#ifdef NATIVE_LINUX_PROFILING
+    perf_stop_();
+#endif
+#ifdef NATIVE_HEADROOM_ANALYSIS
+    headroom_free(&headroom);
+#endif
     if (inst_settings->f_raw_profiling_log != NULL)
     {
 	    fflush(inst_settings->f_raw_profiling_log);
@@ -425,10 +644,18 @@ void profile_postprocess(Profiler_Settings_t* inst_settings)
 void profile_pause(Profiler_Settings_t * inst_settings)
 {
 	inst_settings->profiling_data.c_stop = read_timer_();
+#ifdef NATIVE_LINUX_PROFILING
+	if (perf_leader >= 0)
+		ioctl(perf_leader, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+#endif
 }
 
 void profile_resume(Profiler_Settings_t * inst_settings)
 {
+#ifdef NATIVE_LINUX_PROFILING
+	if (perf_leader >= 0)
+		ioctl(perf_leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#endif
 	inst_settings->profiling_data.c1 +=  read_timer_() - inst_settings->profiling_data.c_stop;
 }
 #endif
@@ -0,0 +1,289 @@
+//
+//CONFIDENTIAL AND PROPRIETARY INFORMATION
+//
+//Copyright (c) 2012 Synopsys, Inc. All rights reserved.
+//This software and documentation contain confidential and
+//proprietary information that is the property of
+//Synopsys, Inc. The software and documentation are
+//furnished under a license agreement and may be used
+//or copied only in accordance with the terms of the license
+//agreement. No part of the software and documentation
+//may be reproduced, transmitted, or translated, in any
+//form or by any means, electronic, mechanical, manual,
+//optical, or otherwise, without prior written permission
+//of Synopsys, Inc., or as expressly provided by the license agreement.
+//Reverse engineering is prohibited, and reproduction,
+//disclosure or use without specific written authorization
+//of Synopsys Inc. is strictly forbidden.
+//
+
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+#include "headroom.h"
+
+#define HEADROOM_MIN_CAPACITY   (1024)
+#define HEADROOM_MHZ_PRECISION  (0.001)
+
+void headroom_init(Headroom_Analyzer_t *h, uint32_t buffer_interval, double border_condition)
+{
+    memset(h, 0, sizeof(*h));
+    h->buffer_interval = buffer_interval > 0 ? buffer_interval : HEADROOM_DEFAULT_INTERVAL;
+    h->border_condition = border_condition;
+    h->min_mhz = 1.0e30;
+}
+
+void headroom_free(Headroom_Analyzer_t *h)
+{
+    free(h->cycles);
+    free(h->microseconds);
+    h->cycles = NULL;
+    h->microseconds = NULL;
+    h->nframes = h->capacity = 0;
+}
+
+void headroom_set_stream(Headroom_Analyzer_t *h, uint32_t sample_rate, uint32_t sample_size, uint32_t num_ch)
+{
+    h->sample_rate = _max(h->sample_rate, sample_rate);
+    h->sample_size = _max(h->sample_size, sample_size);
+    h->num_ch = _max(h->num_ch, num_ch);
+}
+
+// Cycles of frame i; cycles of trailing frames without data go to the last one
+static uint64_t frame_cycles(const Headroom_Analyzer_t *h, uint32_t i)
+{
+    return h->cycles[i] + (i == h->nframes - 1 ? h->stored_cycles : 0);
+}
+
+static double frame_mhz(const Headroom_Analyzer_t *h, uint32_t i)
+{
+    return (double)frame_cycles(h, i) / h->microseconds[i];
+}
+
+// Frames that produce no data (bytes == 0) are charged to the next frame,
+// as in leaky_bucket.pl
+TEST_BOOL headroom_add_frame(Headroom_Analyzer_t *h, uint32_t bytes, uint64_t cycles, uint32_t microseconds)
+{
+    double mhz;
+
+    if (bytes == 0 || microseconds == 0)
+    {
+        h->stored_cycles += cycles;
+        return TEST_TRUE;
+    }
+    if (h->nframes == h->capacity)
+    {
+        uint32_t capacity = _max(HEADROOM_MIN_CAPACITY, 2 * h->capacity);
+        uint64_t *c = (uint64_t *)realloc(h->cycles, capacity * sizeof(uint64_t));
+        uint32_t *us;
+
+        if (c == NULL)
+            return TEST_FALSE;
+        h->cycles = c;
+        us = (uint32_t *)realloc(h->microseconds, capacity * sizeof(uint32_t));
+        if (us == NULL)
+            return TEST_FALSE;
+        h->microseconds = us;
+        h->capacity = capacity;
+    }
+    h->cycles[h->nframes] = cycles + h->stored_cycles;
+    h->microseconds[h->nframes] = microseconds;
+    h->stored_cycles = 0;
+    mhz = frame_mhz(h, h->nframes);
+    if (mhz < h->min_mhz)
+        h->min_mhz = mhz;
+    if (mhz > h->max_mhz)
+        h->max_mhz = mhz;
+    h->nframes++;
+    return TEST_TRUE;
+}
+
+// Accepts one line of a raw profiling log (see print_stream_summary() and
+// print_frame_info() in arc_profile.c). Frame lines are
+// "frame, bytes, cycles, ..., microsec/frame, mhz"; the optional columns in
+// between depend on the profiler build. Returns TEST_TRUE for a frame line.
+TEST_BOOL headroom_parse_line(Headroom_Analyzer_t *h, const char *line)
+{
+    const char *field[32];
+    const char *p;
+    uint32_t n = 0;
+
+    if (strstr(line, "Samplerate:") != NULL)
+        headroom_set_stream(h, (uint32_t)strtoul(strchr(line, ':') + 1, NULL, 10), 0, 0);
+    else if (strstr(line, "Number of channels:") != NULL)
+        headroom_set_stream(h, 0, 0, (uint32_t)strtoul(strchr(line, ':') + 1, NULL, 10));
+    else if (strstr(line, "Sample size:") != NULL)
+        headroom_set_stream(h, 0, (uint32_t)strtoul(strchr(line, ':') + 1, NULL, 10), 0);
+    if (line[0] < '0' || line[0] > '9' || h->num_ch == 0)
+        return TEST_FALSE;
+
+    for (p = line; p != NULL && n < sizeof(field) / sizeof(field[0]); n++)
+    {
+        field[n] = p;
+        p = strchr(p, ',');
+        if (p != NULL)
+            p++;
+    }
+    if (n < 5)
+        return TEST_FALSE;
+    return headroom_add_frame(h, (uint32_t)strtoul(field[1], NULL, 10),
+                              strtoull(field[2], NULL, 10),
+                              (uint32_t)strtoul(field[n - 2], NULL, 10));
+}
+
+static int compare_double(const void *a, const void *b)
+{
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+// Nearest-rank percentile of a sorted array
+static double percentile(const double *sorted, uint32_t n, double p)
+{
+    uint32_t rank = (uint32_t)ceil(p * n);
+    return sorted[rank > 0 ? rank - 1 : 0];
+}
+
+// Leaky bucket: the output buffer starts border_condition full, every frame
+// adds its duration and drains the time it takes at try_mhz, the fill is
+// capped at buffer_interval. The clock fits when the buffer never runs dry
+// and ends at least as full as it started.
+static TEST_BOOL bucket_fits(const Headroom_Analyzer_t *h, double try_mhz)
+{
+    double initial = h->buffer_interval * h->border_condition;
+    double buffer = initial;
+    uint32_t i;
+
+    for (i = 0; i < h->nframes; i++)
+    {
+        buffer += h->microseconds[i] - frame_cycles(h, i) / try_mhz;
+        if (buffer < 0)
+            return TEST_FALSE;
+        if (buffer > h->buffer_interval)
+            buffer = h->buffer_interval;
+    }
+    return buffer >= initial ? TEST_TRUE : TEST_FALSE;
+}
+
+// Lowest clock that passes the leaky bucket. A higher clock only drains
+// less, so the search is a bisection between the cheapest and the most
+// expensive frame instead of the linear scan of leaky_bucket.pl.
+static double required_clock(const Headroom_Analyzer_t *h)
+{
+    double lo = h->min_mhz;
+    double hi = h->max_mhz;
+
+    if (bucket_fits(h, lo))
+        return lo;
+    if (!bucket_fits(h, hi))
+        return 0;
+    while (hi - lo > HEADROOM_MHZ_PRECISION)
+    {
+        double mid = 0.5 * (lo + hi);
+        if (bucket_fits(h, mid))
+            hi = mid;
+        else
+            lo = mid;
+    }
+    return hi;
+}
+
+TEST_BOOL headroom_analyze(Headroom_Analyzer_t *h, double core_mhz, Headroom_Report_t *r)
+{
+    double *sorted;
+    double total_cycles = 0, total_us = 0;
+    double win_cycles = 0, win_us = 0;
+    uint32_t i, first = 0;
+
+    memset(r, 0, sizeof(*r));
+    r->nframes = h->nframes;
+    r->core_mhz = core_mhz;
+    if (h->nframes == 0)
+        return TEST_FALSE;
+    sorted = (double *)malloc(h->nframes * sizeof(double));
+    if (sorted == NULL)
+        return TEST_FALSE;
+
+    for (i = 0; i < h->nframes; i++)
+    {
+        double cycles = (double)frame_cycles(h, i);
+
+        sorted[i] = frame_mhz(h, i);
+        if (sorted[i] > r->max_mhz)
+        {
+            r->max_mhz = sorted[i];
+            r->max_frame = i;
+        }
+        total_cycles += cycles;
+        total_us += h->microseconds[i];
+
+        // sliding window of at least buffer_interval microseconds
+        win_cycles += cycles;
+        win_us += h->microseconds[i];
+        while (first < i && win_us - h->microseconds[first] >= h->buffer_interval)
+        {
+            win_cycles -= (double)frame_cycles(h, first);
+            win_us -= h->microseconds[first];
+            first++;
+        }
+        if (win_us >= h->buffer_interval && win_cycles / win_us > r->burst_mhz)
+        {
+            r->burst_mhz = win_cycles / win_us;
+            r->burst_frame = first;
+        }
+    }
+    if (r->burst_mhz == 0)  // stream shorter than one interval
+    {
+        r->burst_mhz = total_cycles / total_us;
+        r->burst_frame = 0;
+    }
+    r->avg_mhz = total_cycles / total_us;
+
+    qsort(sorted, h->nframes, sizeof(double), compare_double);
+    r->p50_mhz = percentile(sorted, h->nframes, 0.50);
+    r->p99_mhz = percentile(sorted, h->nframes, 0.99);
+    r->p999_mhz = percentile(sorted, h->nframes, 0.999);
+    free(sorted);
+
+    r->required_mhz = required_clock(h);
+
+    if (core_mhz > 0)
+    {
+        // deepest underrun of an unbounded buffer drained at core_mhz
+        double level = 0, deficit = 0;
+
+        for (i = 0; i < h->nframes; i++)
+        {
+            level += h->microseconds[i] - frame_cycles(h, i) / core_mhz;
+            if (level < deficit)
+                deficit = level;
+        }
+        r->buffer_us = (uint32_t)ceil(-deficit);
+        r->buffer_bytes = (uint32_t)ceil(-deficit * h->sample_rate * h->sample_size * h->num_ch / 1000000.0);
+        if (r->required_mhz > 0)
+            r->channels = (uint32_t)(core_mhz / r->required_mhz);
+    }
+    return TEST_TRUE;
+}
+
+void headroom_print_report(FILE *f, const Headroom_Report_t *r)
+{
+    fprintf(f, "Frames:              %u" NEWLINE, r->nframes);
+    fprintf(f, "Average:             %.3f MHz" NEWLINE, r->avg_mhz);
+    fprintf(f, "Frame cost p50:      %.3f MHz" NEWLINE, r->p50_mhz);
+    fprintf(f, "Frame cost p99:      %.3f MHz" NEWLINE, r->p99_mhz);
+    fprintf(f, "Frame cost p99.9:    %.3f MHz" NEWLINE, r->p999_mhz);
+    fprintf(f, "Worst frame:         %.3f MHz (frame %u)" NEWLINE, r->max_mhz, r->max_frame);
+    fprintf(f, "Worst burst:         %.3f MHz (from frame %u)" NEWLINE, r->burst_mhz, r->burst_frame);
+    if (r->required_mhz > 0)
+        fprintf(f, "Frequency:           %.3f MHz" NEWLINE, r->required_mhz);
+    else
+        fprintf(f, "Frequency:           not found" NEWLINE);
+    if (r->core_mhz > 0)
+    {
+        fprintf(f, "Core clock:          %.3f MHz" NEWLINE, r->core_mhz);
+        fprintf(f, "Buffer depth:        %u microsec, %u bytes" NEWLINE, r->buffer_us, r->buffer_bytes);
+        fprintf(f, "Channels per core:   %u" NEWLINE, r->channels);
+    }
+}
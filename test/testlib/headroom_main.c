@@ -0,0 +1,136 @@
+//
+//CONFIDENTIAL AND PROPRIETARY INFORMATION
+//
+//Copyright (c) 2012 Synopsys, Inc. All rights reserved.
+//This software and documentation contain confidential and
+//proprietary information that is the property of
+//Synopsys, Inc. The software and documentation are
+//furnished under a license agreement and may be used
+//or copied only in accordance with the terms of the license
+//agreement. No part of the software and documentation
+//may be reproduced, transmitted, or translated, in any
+//form or by any means, electronic, mechanical, manual,
+//optical, or otherwise, without prior written permission
+//of Synopsys, Inc., or as expressly provided by the license agreement.
+//Reverse engineering is prohibited, and reproduction,
+//disclosure or use without specific written authorization
+//of Synopsys Inc. is strictly forbidden.
+//
+
+// Host tool: headroom analysis of raw profiling logs, replaces leaky_bucket.pl.
+//
+//   cc -O2 -Iinclude headroom_main.c headroom.c -lm -o headroom
+//   headroom [options] file.rpd      analyze a finished log
+//   g722demo ... -raw_profiling_data /dev/stdout | headroom -report_every 100 -
+//                                    analyze a run live
+//
+// Options (same meaning as in leaky_bucket.pl where they overlap):
+//   -nframes N          analyze N frames only
+//   -nframes_skip N     skip the first N frames
+//   -prof_interval us   buffering interval [50000]
+//   -border f           initial buffer fill, fraction of the interval [0.5]
+//   -core_clock MHz     report buffer depth and channel count for this clock
+//   -report_every N     print an intermediate report every N frames
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "headroom.h"
+
+#define MAX_LINE_LENGTH (1024)
+
+static void usage()
+{
+    printf("Usage: headroom [-nframes 44] [-nframes_skip 3] [-prof_interval 50000] [-border 0.5]" NEWLINE
+           "                [-core_clock 200] [-report_every 100] file.rpd|-" NEWLINE);
+}
+
+int main(int argc, char *argv[])
+{
+    Headroom_Analyzer_t analyzer;
+    Headroom_Report_t report;
+    uint32_t buffer_interval = HEADROOM_DEFAULT_INTERVAL;
+    double border_condition = HEADROOM_DEFAULT_BORDER;
+    double core_mhz = 0;
+    uint32_t nframes = 0, nframes_skip = 0, report_every = 0;
+    uint32_t read_frame = 0;
+    const char *file_name = NULL;
+    char line[MAX_LINE_LENGTH];
+    FILE *f;
+    int i;
+
+    for (i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-nframes") == 0 && i + 1 < argc)
+            nframes = (uint32_t)atoi(argv[++i]);
+        else if (strcmp(argv[i], "-nframes_skip") == 0 && i + 1 < argc)
+            nframes_skip = (uint32_t)atoi(argv[++i]);
+        else if (strcmp(argv[i], "-prof_interval") == 0 && i + 1 < argc)
+            buffer_interval = (uint32_t)atoi(argv[++i]);
+        else if (strcmp(argv[i], "-border") == 0 && i + 1 < argc)
+            border_condition = atof(argv[++i]);
+        else if (strcmp(argv[i], "-core_clock") == 0 && i + 1 < argc)
+            core_mhz = atof(argv[++i]);
+        else if (strcmp(argv[i], "-report_every") == 0 && i + 1 < argc)
+            report_every = (uint32_t)atoi(argv[++i]);
+        else if (argv[i][0] == '-' && argv[i][1] != '\0')
+        {
+            usage();
+            return 1;
+        }
+        else
+            file_name = argv[i];
+    }
+    if (file_name == NULL)
+    {
+        usage();
+        return 0;
+    }
+
+    f = strcmp(file_name, "-") == 0 ? stdin : fopen(file_name, "r");
+    if (f == NULL)
+    {
+        fprintf(stderr, "[ERROR] Can not open file %s for reading" NEWLINE, file_name);
+        return 1;
+    }
+
+    headroom_init(&analyzer, buffer_interval, border_condition);
+    while (fgets(line, sizeof(line), f) != NULL)
+    {
+        uint32_t stored = analyzer.nframes;
+
+        // the frame filter has to see the line before it becomes a frame
+        if (line[0] >= '0' && line[0] <= '9' && analyzer.num_ch > 0)
+        {
+            read_frame++;
+            if (read_frame <= nframes_skip)
+                continue;
+            if (nframes > 0 && read_frame > nframes + nframes_skip)
+                break;
+        }
+        headroom_parse_line(&analyzer, line);
+        if (report_every > 0 && analyzer.nframes != stored && analyzer.nframes % report_every == 0)
+        {
+            headroom_analyze(&analyzer, core_mhz, &report);
+            printf("-----------------------------------------------------------" NEWLINE);
+            headroom_print_report(stdout, &report);
+            fflush(stdout);
+        }
+    }
+    if (f != stdin)
+        fclose(f);
+
+    printf("Samplerate:         %u" NEWLINE, analyzer.sample_rate);
+    printf("Number of channels: %u" NEWLINE, analyzer.num_ch);
+    printf("Sample size:        %u" NEWLINE, analyzer.sample_size);
+    printf("===========================================================" NEWLINE);
+    if (!headroom_analyze(&analyzer, core_mhz, &report))
+    {
+        printf("No frames found in %s" NEWLINE, file_name);
+        headroom_free(&analyzer);
+        return 1;
+    }
+    headroom_print_report(stdout, &report);
+    headroom_free(&analyzer);
+    return report.required_mhz > 0 ? 0 : 1;
+}
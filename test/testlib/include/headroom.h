@@ -0,0 +1,82 @@
+//
+//CONFIDENTIAL AND PROPRIETARY INFORMATION
+//
+//Copyright (c) 2012 Synopsys, Inc. All rights reserved.
+//This software and documentation contain confidential and
+//proprietary information that is the property of
+//Synopsys, Inc. The software and documentation are
+//furnished under a license agreement and may be used
+//or copied only in accordance with the terms of the license
+//agreement. No part of the software and documentation
+//may be reproduced, transmitted, or translated, in any
+//form or by any means, electronic, mechanical, manual,
+//optical, or otherwise, without prior written permission
+//of Synopsys, Inc., or as expressly provided by the license agreement.
+//Reverse engineering is prohibited, and reproduction,
+//disclosure or use without specific written authorization
+//of Synopsys Inc. is strictly forbidden.
+//
+
+#ifndef __TEST_HEADROOM_H__
+#define __TEST_HEADROOM_H__
+
+// Real-time headroom analysis of per-frame profiling data.
+//
+// Frames are fed one at a time, either live from the profiler or from a
+// raw profiling log written by arc_profile.c (same format leaky_bucket.pl
+// reads). The report gives the frame cost distribution, the worst burst
+// over a buffering interval, the core clock the leaky bucket model needs
+// and, for a given core clock, the buffer depth and channel count that fit.
+
+#include <stdio.h>
+#include <stdint.h>
+#include "testlib_types.h"
+
+#define HEADROOM_DEFAULT_INTERVAL   (50000)     /* buffering interval, microseconds */
+#define HEADROOM_DEFAULT_BORDER     (0.5)       /* initial buffer fill, fraction of the interval */
+
+typedef struct {
+    uint32_t  buffer_interval;      /* leaky bucket depth, microseconds            */
+    double    border_condition;     /* initial fill of the bucket (0..1)           */
+
+    uint32_t  sample_rate;          /* stream parameters, used for byte figures    */
+    uint32_t  sample_size;
+    uint32_t  num_ch;
+
+    uint32_t  nframes;              /* frames stored                               */
+    uint32_t  capacity;
+    uint64_t *cycles;               /* per frame                                   */
+    uint32_t *microseconds;         /* per frame                                   */
+    uint64_t  stored_cycles;        /* cycles of frames that produced no data      */
+
+    double    min_mhz;
+    double    max_mhz;
+} Headroom_Analyzer_t;
+
+typedef struct {
+    uint32_t  nframes;
+    double    avg_mhz;              /* total cycles / total time                   */
+    double    p50_mhz;              /* frame cost percentiles                      */
+    double    p99_mhz;
+    double    p999_mhz;
+    double    max_mhz;              /* single worst frame                          */
+    uint32_t  max_frame;
+    double    burst_mhz;            /* worst average over buffer_interval          */
+    uint32_t  burst_frame;          /* first frame of that window                  */
+    double    required_mhz;         /* leaky bucket clock, 0 if not found          */
+
+    double    core_mhz;             /* given core clock, 0 if none                 */
+    uint32_t  buffer_us;            /* pre-buffering needed at core_mhz            */
+    uint32_t  buffer_bytes;
+    uint32_t  channels;             /* channels of this stream that fit core_mhz   */
+} Headroom_Report_t;
+
+void headroom_init(Headroom_Analyzer_t *h, uint32_t buffer_interval, double border_condition);
+void headroom_free(Headroom_Analyzer_t *h);
+void headroom_set_stream(Headroom_Analyzer_t *h, uint32_t sample_rate, uint32_t sample_size, uint32_t num_ch);
+TEST_BOOL headroom_add_frame(Headroom_Analyzer_t *h, uint32_t bytes, uint64_t cycles, uint32_t microseconds);
+TEST_BOOL headroom_parse_line(Headroom_Analyzer_t *h, const char *line);
+TEST_BOOL headroom_analyze(Headroom_Analyzer_t *h, double core_mhz, Headroom_Report_t *r);
+void headroom_print_report(FILE *f, const Headroom_Report_t *r);
+
+#endif //__TEST_HEADROOM_H__
@@ -35,6 +35,14 @@
 
 #ifdef _MSC_VER
   #define _max(a, b) (a > b) ? a : b
+#elif !defined(_ARC) && !defined(_max)
+  #define _max(a, b) (((a) > (b)) ? (a) : (b))
+#endif
+
+/* Hosted Linux build: cycles, instructions and cache misses come from
+   perf_event_open() (rdtsc/clock_gettime if perf is not available) */
+#if defined(NATIVE_CYCLE_PROFILING) && defined(__linux__) && !defined(_ARC)
+  #define NATIVE_LINUX_PROFILING
 #endif
 
 #ifndef PSP_MEMORY_ALIGNMENT
@@ -202,9 +210,9 @@ typedef struct {
 } ARC_API_Stream_Configuration_t;
 
 typedef struct {
-    unsigned long c1;
-    unsigned long c2;
-    unsigned long c_stop;
+    uint64_t c1;
+    uint64_t c2;
+    uint64_t c_stop;
  	unsigned long stack1;
  	unsigned long stack2;
 
@@ -213,7 +221,7 @@ typedef struct {
 
     uint32_t mksec_per_frame;
     uint32_t cycles_per_frame;
-    uint32_t summary_cycles;
+    uint64_t summary_cycles;
     uint32_t cached_sample_rate;
     uint32_t cached_sample_size;
 	uint32_t cached_num_chans;
@@ -240,6 +248,15 @@ typedef struct {
     double    ldst_bw_summary;
     uint32_t  required_mem_latency;
 #endif
+#ifdef NATIVE_LINUX_PROFILING
+    //event counters at frame start/stop: cycles, instructions, cache misses
+    uint64_t events1[3];
+    uint64_t events2[3];
+    uint64_t instructions_per_frame;
+    uint64_t cache_misses_per_frame;
+    uint64_t summary_instructions;
+    uint64_t summary_cache_misses;
+#endif
 } ARC_TEST_Profile_Tag_t;
 
 typedef struct {